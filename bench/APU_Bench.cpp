@@ -0,0 +1,101 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "../include/NES.h"
+#include "../include/RomImage.h"
+
+/**
+ * APU cost benchmark. Plays a busy score on all five channels (notes,
+ * envelopes and sweeps changing every frame, a looping DMC sample) with the
+ * APU clocked in CPU instruction sized steps, and compares the time per
+ * frame against a whole headless frame of nestest.nes.
+ *
+ * Usage: benchAPU [frames]
+ */
+
+namespace {
+
+constexpr uint32_t FRAME_CYCLES = 29781;
+constexpr uint32_t STEP_CYCLES = 3; // a typical instruction
+
+// register writes a music driver might make in one frame
+void playFrame(APU &apu, int frame) {
+    const auto note = static_cast<uint8_t>(0x40 + (frame * 7) % 0x90);
+    apu.writeRegister(0x4000, static_cast<uint8_t>(0x80 | (frame & 0x0F)));
+    apu.writeRegister(0x4002, note);
+    apu.writeRegister(0x4004, 0x4F);
+    apu.writeRegister(0x4005, 0x9A); // sweep down
+    apu.writeRegister(0x4006, static_cast<uint8_t>(note / 2));
+    apu.writeRegister(0x400A, static_cast<uint8_t>(note + 0x20));
+    apu.writeRegister(0x400E, static_cast<uint8_t>(frame & 0x0F));
+    if (frame % 8 == 0) {
+        apu.writeRegister(0x4003, 0x08);
+        apu.writeRegister(0x4007, 0x09);
+        apu.writeRegister(0x400B, 0x08);
+        apu.writeRegister(0x400F, 0x08);
+    }
+}
+
+double microsPerFrame(std::chrono::steady_clock::time_point start,
+                      int frames) {
+    return std::chrono::duration<double, std::micro>(
+               std::chrono::steady_clock::now() - start)
+               .count() /
+           frames;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    const int frames = argc > 1 ? std::stoi(argv[1]) : 3000;
+
+    const std::filesystem::path path =
+        std::filesystem::path(NES_SOURCE_DIR) / "tests" / "nestest.nes";
+    NES nes(RomImage::open(path.string()));
+    nes.log.mute();
+
+    // whole machine, for scale
+    nes.runHeadless(60);
+    const HeadlessResult emulation = nes.runHeadless(frames / 10 + 1);
+    const double emulationMicros =
+        emulation.elapsedSeconds * 1e6 / static_cast<double>(emulation.frames);
+
+    APU &apu = nes.apu;
+    apu.writeRegister(0x4015, 0x1F);
+    apu.writeRegister(0x4001, 0x00);
+    apu.writeRegister(0x4008, 0xFF);
+    apu.writeRegister(0x400C, 0x3F);
+    apu.writeRegister(0x4010, 0x4E); // looping, second fastest rate
+    apu.writeRegister(0x4012, 0x00);
+    apu.writeRegister(0x4013, 0xFF);
+    apu.writeRegister(0x4017, 0x40);
+
+    std::vector<int16_t> drained(apu.output().capacity());
+    uint64_t samples = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        playFrame(apu, frame);
+        for (uint32_t cycle = 0; cycle < FRAME_CYCLES; cycle += STEP_CYCLES) {
+            apu.clock(STEP_CYCLES);
+            apu.takeStallCycles();
+        }
+        apu.endFrame();
+        samples += apu.output().pop(drained.data(), apu.output().size());
+    }
+    const double apuMicros = microsPerFrame(start, frames);
+
+    std::printf("frames:            %d\n", frames);
+    std::printf("samples:           %llu (%.1f per frame)\n",
+                static_cast<unsigned long long>(samples),
+                static_cast<double>(samples) / frames);
+    std::printf("apu:               %.2f us/frame\n", apuMicros);
+    std::printf("emulated frame:    %.2f us/frame (nestest, headless)\n",
+                emulationMicros);
+    std::printf("apu share:         %.1f %% of an emulated frame\n",
+                100.0 * apuMicros / emulationMicros);
+    return 0;
+}
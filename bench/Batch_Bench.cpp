@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/BatchRunner.h"
+#include "../include/RomImage.h"
+
+/**
+ * Scaling of BatchRunner. Runs the same batch of nestest.nes instances, each
+ * with its own random input, on 1, 2, 4, ... threads up to the hardware
+ * thread count or the given maximum, and reports throughput and parallel
+ * efficiency (speedup over one thread divided by the thread count). Results
+ * must match between thread counts; a mismatch is reported.
+ *
+ * Usage: benchBatch [jobs] [frames] [max threads]
+ */
+
+int main(int argc, char *argv[]) {
+    const std::size_t jobCount = argc > 1 ? std::stoull(argv[1]) : 64;
+    const uint64_t frames = argc > 2 ? std::stoull(argv[2]) : 120;
+
+    const std::filesystem::path path =
+        std::filesystem::path(NES_SOURCE_DIR) / "tests" / "nestest.nes";
+    const std::shared_ptr<const RomImage> rom = RomImage::open(path.string());
+
+    std::vector<BatchJob> jobs(jobCount);
+    for (std::size_t i = 0; i < jobCount; i++) {
+        jobs[i].rom = rom;
+        jobs[i].frames = frames;
+        jobs[i].inputSeed = i + 1;
+    }
+
+    const unsigned maxThreads =
+        argc > 3 ? static_cast<unsigned>(std::stoul(argv[3]))
+                 : std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> threadCounts;
+    for (unsigned threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    std::printf("%zu jobs x %llu frames\n", jobCount,
+                static_cast<unsigned long long>(frames));
+    std::printf("%8s %10s %12s %9s %11s %8s\n", "threads", "seconds",
+                "frames/s", "speedup", "efficiency", "steals");
+
+    std::vector<BatchResult> baseline;
+    double baselineSeconds = 0.0;
+    for (unsigned threads : threadCounts) {
+        BatchRunner runner(threads);
+        const std::vector<BatchResult> results = runner.run(jobs);
+        const BatchStats &stats = runner.stats();
+        if (baseline.empty()) {
+            baseline = results;
+            baselineSeconds = stats.elapsedSeconds;
+        }
+        for (std::size_t i = 0; i < results.size(); i++) {
+            if (!results[i].ok() ||
+                results[i].frameHash != baseline[i].frameHash ||
+                results[i].ramHash != baseline[i].ramHash) {
+                std::printf("job %zu differs on %u threads %s\n", i, threads,
+                            results[i].error.c_str());
+            }
+        }
+
+        const double speedup = baselineSeconds / stats.elapsedSeconds;
+        std::printf("%8u %10.3f %12.0f %9.2f %10.1f%% %8zu\n", threads,
+                    stats.elapsedSeconds,
+                    static_cast<double>(jobCount * frames) /
+                        stats.elapsedSeconds,
+                    speedup, 100.0 * speedup / threads, stats.steals);
+    }
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../include/NES.h"
+
+/**
+ * CPU instruction throughput benchmark. Replays the automated (no PPU) run of
+ * nestest.nes from $C000 repeatedly and reports instructions per second.
+ *
+ * Usage: benchCPUNestest [passes] [--instruction-stepped]
+ */
+
+namespace {
+
+// number of instructions in the nestest automated run (see nestest_cpu_exp.log)
+constexpr uint64_t NESTEST_INSTRUCTIONS = 8990;
+
+std::vector<uint8_t> readNestestROM() {
+    const std::filesystem::path path =
+        std::filesystem::path(NES_SOURCE_DIR) / "tests" / "nestest.nes";
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Could not open file: " + path.string());
+    }
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(file)),
+                                std::istreambuf_iterator<char>());
+}
+
+// run one pass of nestest, returns number of CPU cycles executed
+uint64_t runNestestPass(CPU<Bus> &cpu, bool instructionStepped) {
+    cpu.TEST_setPC(0xC000);
+    cpu.TEST_setSP(0xFD);
+    cpu.TEST_setStatus(0x24);
+
+    const uint64_t startCycles = cpu.getCycleCount();
+    for (uint64_t i = 0; i < NESTEST_INSTRUCTIONS; i++) {
+        if (instructionStepped) {
+            cpu.step();
+            continue;
+        }
+        cpu.tick(); // fetch opcode
+        while (cpu.TEST_getCyclesRemainingInCurrentInstr() > 0) {
+            cpu.tick();
+        }
+    }
+    return cpu.getCycleCount() - startCycles;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    const int passes = argc > 1 ? std::stoi(argv[1]) : 200;
+    const bool instructionStepped =
+        argc > 2 && std::string(argv[2]) == "--instruction-stepped";
+
+    NES nes(readNestestROM());
+    nes.log.mute();
+
+    runNestestPass(nes.cpu, instructionStepped); // warm up
+
+    uint64_t cycles = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < passes; pass++) {
+        cycles += runNestestPass(nes.cpu, instructionStepped);
+    }
+    const double seconds = std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
+
+    const double instructions =
+        static_cast<double>(NESTEST_INSTRUCTIONS) * passes;
+    std::printf("mode:              %s\n",
+                instructionStepped ? "instruction stepped" : "cycle stepped");
+    std::printf("passes:            %d\n", passes);
+    std::printf("instructions:      %.0f\n", instructions);
+    std::printf("cpu cycles:        %llu\n",
+                static_cast<unsigned long long>(cycles));
+    std::printf("elapsed:           %.3f s\n", seconds);
+    std::printf("instructions/sec:  %.2f M\n", instructions / seconds / 1e6);
+    std::printf("cpu cycles/sec:    %.2f M\n",
+                static_cast<double>(cycles) / seconds / 1e6);
+    return 0;
+}
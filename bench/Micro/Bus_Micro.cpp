@@ -0,0 +1,68 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+#include "../../include/APU/APU.h"
+#include "../../include/Bus.h"
+#include "../../include/Cartridge.h"
+#include "../../include/PPU/PPU.h"
+#include "Micro.h"
+
+/**
+ * Bus::read and Bus::write by region of the CPU memory map. Each iteration
+ * accesses ACCESSES consecutive addresses (wrapped to the region's size).
+ * Reported items are bus accesses.
+ */
+
+namespace {
+
+constexpr int ACCESSES = 256;
+
+struct Board {
+    Cartridge cart;
+    PPU ppu;
+    APU apu;
+    Bus bus;
+
+    Board() : cart(), ppu(cart), apu(cart), bus(ppu, apu, cart) {
+        cart.load(micro::nestestImage());
+        bus.mapCartridge();
+    }
+};
+
+void BM_BusRead(benchmark::State &state, uint16_t base, uint16_t mask) {
+    Board board;
+    for (auto _ : state) {
+        for (int i = 0; i < ACCESSES; i++) {
+            benchmark::DoNotOptimize(
+                board.bus.read(static_cast<uint16_t>(base + (i & mask))));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * ACCESSES);
+}
+
+void BM_BusWrite(benchmark::State &state, uint16_t base, uint16_t mask) {
+    Board board;
+    for (auto _ : state) {
+        for (int i = 0; i < ACCESSES; i++) {
+            board.bus.write(static_cast<uint16_t>(base + (i & mask)),
+                            static_cast<uint8_t>(i));
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * ACCESSES);
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(BM_BusRead, RAM, 0x0000, 0x07FF);
+BENCHMARK_CAPTURE(BM_BusRead, RAMMirror, 0x1800, 0x07FF);
+BENCHMARK_CAPTURE(BM_BusRead, PPURegisters, 0x2000, 0x0007);
+BENCHMARK_CAPTURE(BM_BusRead, APUStatus, 0x4015, 0x0000);
+BENCHMARK_CAPTURE(BM_BusRead, Joypad, 0x4016, 0x0000);
+BENCHMARK_CAPTURE(BM_BusRead, PRGROM, 0x8000, 0x7FFF);
+
+BENCHMARK_CAPTURE(BM_BusWrite, RAM, 0x0000, 0x07FF);
+BENCHMARK_CAPTURE(BM_BusWrite, PPUScroll, 0x2005, 0x0000);
+BENCHMARK_CAPTURE(BM_BusWrite, APURegisters, 0x4000, 0x000F);
+BENCHMARK_CAPTURE(BM_BusWrite, PRGROM, 0x8000, 0x7FFF);
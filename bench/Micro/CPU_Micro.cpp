@@ -0,0 +1,70 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "../../include/CPU/CPU.h"
+#include "../../include/Logger.h"
+#include "../../include/TestBus.h"
+
+/**
+ * CPU::tick on TestBus, one benchmark per class of instruction. Each runs a
+ * loop of the same instruction followed by JMP back to the start, so nearly
+ * every cycle is spent in the class being measured. Reported items are CPU
+ * cycles.
+ */
+
+namespace {
+
+constexpr uint16_t PROGRAM = 0x0200;
+constexpr int REPEATS = 64;
+constexpr int TICKS_PER_ITERATION = 1000;
+
+void BM_CPUTick(benchmark::State &state, std::vector<uint8_t> instruction) {
+    Logger logger;
+    logger.mute();
+    TestBus bus;
+    CPU<TestBus> cpu(bus, logger);
+
+    uint16_t addr = PROGRAM;
+    for (int i = 0; i < REPEATS; i++) {
+        for (uint8_t byte : instruction) {
+            bus.write(addr++, byte);
+        }
+    }
+    bus.write(addr++, 0x4C); // JMP PROGRAM
+    bus.write(addr++, PROGRAM & 0xFF);
+    bus.write(addr++, PROGRAM >> 8);
+    bus.write(0x0100, 0x60); // RTS, for JSR
+    bus.write(0x0010, 0x00); // pointer for (zp),Y
+    bus.write(0x0011, 0x03);
+
+    cpu.TEST_setPC(PROGRAM);
+    cpu.TEST_setSP(0xFD);
+    cpu.TEST_setStatus(0x24); // Z clear, so BNE is taken
+    cpu.TEST_setX(1);
+    cpu.TEST_setY(1);
+
+    for (auto _ : state) {
+        for (int i = 0; i < TICKS_PER_ITERATION; i++) {
+            cpu.tick();
+        }
+    }
+    benchmark::DoNotOptimize(cpu.getCycleCount());
+    state.SetItemsProcessed(state.iterations() * TICKS_PER_ITERATION);
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(BM_CPUTick, Implied_NOP, std::vector<uint8_t>{0xEA});
+BENCHMARK_CAPTURE(BM_CPUTick, Immediate_LDA, std::vector<uint8_t>{0xA9, 0x01});
+BENCHMARK_CAPTURE(BM_CPUTick, Immediate_ADC, std::vector<uint8_t>{0x69, 0x01});
+BENCHMARK_CAPTURE(BM_CPUTick, ZeroPage_STA, std::vector<uint8_t>{0x85, 0x20});
+BENCHMARK_CAPTURE(BM_CPUTick, ZeroPage_INC, std::vector<uint8_t>{0xE6, 0x20});
+BENCHMARK_CAPTURE(BM_CPUTick, AbsoluteX_LDA,
+                  std::vector<uint8_t>{0xBD, 0x00, 0x03});
+BENCHMARK_CAPTURE(BM_CPUTick, IndirectY_LDA, std::vector<uint8_t>{0xB1, 0x10});
+BENCHMARK_CAPTURE(BM_CPUTick, Branch_BNE, std::vector<uint8_t>{0xD0, 0x00});
+BENCHMARK_CAPTURE(BM_CPUTick, Stack_PHA_PLA, std::vector<uint8_t>{0x48, 0x68});
+BENCHMARK_CAPTURE(BM_CPUTick, Subroutine_JSR_RTS,
+                  std::vector<uint8_t>{0x20, 0x00, 0x01});
@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <iostream>
+#include <streambuf>
+
+#include "../../include/CPU/TraceRecord.h"
+#include "../../include/Logger.h"
+#include "../../include/TraceRecorder.h"
+
+/**
+ * Logger::log, the cost of tracing one instruction: printed as a --trace
+ * line with std::cout discarded, or appended to a TraceRecorder. Reported
+ * items are instructions.
+ */
+
+namespace {
+
+class NullBuffer : public std::streambuf {
+  protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char *, std::streamsize n) override {
+        return n;
+    }
+};
+
+TraceRecord testRecord(uint8_t opcode) {
+    TraceRecord record{};
+    record.cycles = 7;
+    record.pc = 0xC000;
+    record.address = 0x0200;
+    record.ppuX = 21;
+    record.opBytes = {opcode, 0x00, 0x02};
+    record.opByteCount = 3;
+    record.valueAtAddr = 0x42;
+    record.A = 0x01;
+    record.X = 0x02;
+    record.Y = 0x03;
+    record.P = 0x24;
+    record.SP = 0xFD;
+    return record;
+}
+
+void BM_LoggerLog(benchmark::State &state, uint8_t opcode) {
+    const TraceRecord record = testRecord(opcode);
+    Logger logger;
+    NullBuffer discard;
+    std::streambuf *out = std::cout.rdbuf(&discard);
+    for (auto _ : state) {
+        logger.log(record);
+    }
+    std::cout.rdbuf(out);
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_LoggerRecord(benchmark::State &state) {
+    TraceRecord record = testRecord(0xAD);
+    TraceRecorder recorder(1 << 16);
+    Logger logger;
+    logger.recordTo(&recorder);
+    for (auto _ : state) {
+        logger.log(record);
+        record.cycles += 4;
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(BM_LoggerLog, Absolute_LDA, 0xAD);
+BENCHMARK_CAPTURE(BM_LoggerLog, Implied_NOP, 0xEA);
+BENCHMARK(BM_LoggerRecord);
@@ -0,0 +1,23 @@
+#ifndef MICRO_H
+#define MICRO_H
+
+#include <filesystem>
+#include <memory>
+
+#include "../../include/RomImage.h"
+
+/**
+ * Shared by the nesemu_bench microbenchmarks.
+ */
+namespace micro {
+
+// nestest.nes from the tests directory, mapped once
+inline std::shared_ptr<const RomImage> nestestImage() {
+    const std::filesystem::path path =
+        std::filesystem::path(NES_SOURCE_DIR) / "tests" / "nestest.nes";
+    return RomImage::open(path.string());
+}
+
+} // namespace micro
+
+#endif // MICRO_H
@@ -0,0 +1,55 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "../../include/NES.h"
+#include "../../include/TraceRecorder.h"
+#include "Micro.h"
+
+/**
+ * Whole-system speed on nestest.nes: CPU, PPU and APU run headless one frame
+ * per iteration. Reported items are frames, so items/s is frames per second.
+ */
+
+namespace {
+
+void BM_NESFrame(benchmark::State &state, SyncMode syncMode,
+                 PPURenderMode renderMode) {
+    NES nes(micro::nestestImage());
+    nes.log.mute();
+    nes.clock.setSyncMode(syncMode);
+    nes.ppu.setRenderMode(renderMode);
+    std::vector<int16_t> audio(nes.apu.output().capacity());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(nes.runHeadless(1).frameHash);
+        // drain the audio as a device would, so the ring never fills
+        nes.apu.output().pop(audio.data(), nes.apu.output().size());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// cycle stepped with every instruction appended to a binary trace
+void BM_NESFrameTraced(benchmark::State &state) {
+    NES nes(micro::nestestImage());
+    TraceRecorder recorder(1 << 16);
+    nes.log.recordTo(&recorder);
+    std::vector<int16_t> audio(nes.apu.output().capacity());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(nes.runHeadless(1).frameHash);
+        nes.apu.output().pop(audio.data(), nes.apu.output().size());
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["instructions"] = benchmark::Counter(
+        static_cast<double>(recorder.written()), benchmark::Counter::kIsRate);
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(BM_NESFrame, CycleStepped, SyncMode::CycleStepped,
+                  PPURenderMode::Dot);
+BENCHMARK_CAPTURE(BM_NESFrame, InstructionStepped,
+                  SyncMode::InstructionStepped, PPURenderMode::Dot);
+BENCHMARK_CAPTURE(BM_NESFrame, InstructionStepped_ScanlinePPU,
+                  SyncMode::InstructionStepped, PPURenderMode::Scanline);
+BENCHMARK(BM_NESFrameTraced);
@@ -0,0 +1,88 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "../../include/Cartridge.h"
+#include "../../include/PPU/PPU.h"
+#include "../../include/Renderer/Frame.h"
+#include "../../include/SaveState.h"
+#include "Micro.h"
+
+/**
+ * PPU::tick per kind of scanline, with background and sprite rendering on,
+ * and sprite drawing with a full OAM. Reported items are scanlines, or
+ * sprite passes for renderSprites.
+ */
+
+namespace {
+
+constexpr uint16_t DOTS_PER_SCANLINE = 341;
+
+struct Setup {
+    Cartridge cart;
+    PPU ppu;
+
+    explicit Setup(PPURenderMode mode) : cart(), ppu(cart) {
+        cart.load(micro::nestestImage());
+        ppu.setRenderMode(mode);
+        ppu.write_to_mask(0x1E); // background and sprites, left column too
+
+        // 64 sprites spread over the screen, so every scanline has some
+        std::array<uint8_t, 256> oam{};
+        for (int sprite = 0; sprite < 64; sprite++) {
+            oam[sprite * 4] = static_cast<uint8_t>((sprite * 29) % 232);
+            oam[sprite * 4 + 1] = static_cast<uint8_t>(sprite);
+            oam[sprite * 4 + 2] = static_cast<uint8_t>(sprite & 0xC3);
+            oam[sprite * 4 + 3] = static_cast<uint8_t>((sprite * 37) % 248);
+        }
+        ppu.write_oam_dma(oam);
+    }
+
+    void tickUntil(uint16_t scanline) {
+        while (ppu.getScanline() != scanline || ppu.getCycle() != 0) {
+            ppu.tick();
+        }
+    }
+};
+
+// times count scanlines from first on, restoring the PPU to first in between
+void BM_PPUScanlines(benchmark::State &state, PPURenderMode mode,
+                     uint16_t first, uint16_t count) {
+    Setup setup(mode);
+    setup.tickUntil(first);
+    std::vector<uint8_t> snapshot;
+    StateWriter writer(snapshot);
+    setup.ppu.saveState(writer);
+    for (auto _ : state) {
+        state.PauseTiming();
+        StateReader reader(snapshot);
+        setup.ppu.loadState(reader);
+        state.ResumeTiming();
+        for (uint32_t dot = 0; dot < count * DOTS_PER_SCANLINE; dot++) {
+            benchmark::DoNotOptimize(setup.ppu.tick());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+void BM_PPURenderSprites(benchmark::State &state) {
+    Setup setup(PPURenderMode::Dot);
+    Frame frame;
+    for (auto _ : state) {
+        setup.ppu.TEST_renderSprites(frame);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(BM_PPUScanlines, Visible_Dot, PPURenderMode::Dot, 0, 240);
+BENCHMARK_CAPTURE(BM_PPUScanlines, Visible_Scanline, PPURenderMode::Scanline,
+                  0, 240);
+BENCHMARK_CAPTURE(BM_PPUScanlines, PostRender, PPURenderMode::Dot, 240, 1);
+BENCHMARK_CAPTURE(BM_PPUScanlines, VBlank, PPURenderMode::Dot, 241, 20);
+BENCHMARK_CAPTURE(BM_PPUScanlines, PreRender, PPURenderMode::Dot, 261, 1);
+BENCHMARK(BM_PPURenderSprites);
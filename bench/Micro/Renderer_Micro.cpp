@@ -0,0 +1,69 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "../../include/Constants.h"
+#include "../../include/Renderer/PaletteConversion.h"
+#include "../../include/Renderer/Scaler.h"
+
+/**
+ * The CPU side of presenting a frame: palette index to RGBA conversion, then
+ * scaling to the window. Reported items are frames.
+ */
+
+namespace {
+
+constexpr std::size_t PIXELS = SCREEN_WIDTH * SCREEN_HEIGHT;
+
+std::vector<uint8_t> testIndices() {
+    std::vector<uint8_t> indices(PIXELS);
+    for (std::size_t i = 0; i < PIXELS; i++) {
+        indices[i] = static_cast<uint8_t>((i / 8 + i / SCREEN_WIDTH) & 0x3F);
+    }
+    return indices;
+}
+
+void BM_PaletteConversion(benchmark::State &state, PaletteConversionPath path) {
+    if (!paletteConversionSupported(path)) {
+        state.SkipWithError("not supported by this CPU");
+        return;
+    }
+    const std::vector<uint8_t> indices = testIndices();
+    std::vector<uint32_t> rgba(PIXELS);
+    for (auto _ : state) {
+        convertPaletteIndicesToRGBA(path, indices.data(), PIXELS,
+                                    reinterpret_cast<uint8_t *>(rgba.data()));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_Scale(benchmark::State &state, ScalerKind kind, bool vectorized) {
+    const std::vector<uint8_t> indices = testIndices();
+    std::vector<uint32_t> rgba(PIXELS);
+    convertPaletteIndicesToRGBA(indices.data(), PIXELS,
+                                reinterpret_cast<uint8_t *>(rgba.data()));
+    std::unique_ptr<Scaler> scaler =
+        makeScaler(kind, SCREEN_SCALING, vectorized);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(scaler->scale(rgba.data()));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(BM_PaletteConversion, Scalar, PaletteConversionPath::Scalar);
+BENCHMARK_CAPTURE(BM_PaletteConversion, SSSE3, PaletteConversionPath::SSSE3);
+BENCHMARK_CAPTURE(BM_PaletteConversion, AVX2, PaletteConversionPath::AVX2);
+BENCHMARK_CAPTURE(BM_PaletteConversion, NEON, PaletteConversionPath::NEON);
+
+BENCHMARK_CAPTURE(BM_Scale, Nearest, ScalerKind::Nearest, true);
+BENCHMARK_CAPTURE(BM_Scale, Nearest_Scalar, ScalerKind::Nearest, false);
+BENCHMARK_CAPTURE(BM_Scale, Scanlines, ScalerKind::Scanlines, true);
+BENCHMARK_CAPTURE(BM_Scale, Scanlines_Scalar, ScalerKind::Scanlines, false);
+BENCHMARK_CAPTURE(BM_Scale, EPX, ScalerKind::EPX, true);
+BENCHMARK_CAPTURE(BM_Scale, EPX_Scalar, ScalerKind::EPX, false);
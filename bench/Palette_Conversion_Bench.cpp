@@ -0,0 +1,80 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../include/Renderer/Frame.h"
+#include "../include/Renderer/PaletteConversion.h"
+
+/**
+ * Palette conversion benchmark. Converts a frame of palette indices to RGBA
+ * repeatedly with each implementation the host supports and reports frames
+ * per second. The per-pixel RGB conversion the PPU used to do while drawing
+ * is included for comparison.
+ *
+ * Usage: benchPaletteConversion [frames]
+ */
+
+namespace {
+
+constexpr std::size_t PIXELS =
+    static_cast<std::size_t>(SCREEN_WIDTH) * SCREEN_HEIGHT;
+
+// the former Frame::push, one tuple lookup and three byte writes per pixel
+void convertPerPixelRGB(const std::vector<uint8_t> &indices,
+                        std::vector<uint8_t> &rgb) {
+    std::size_t offset = 0;
+    for (uint8_t index : indices) {
+        const auto &[r, g, b] = NES_PALETTE[index & 0x3F];
+        rgb[offset] = r;
+        rgb[offset + 1] = g;
+        rgb[offset + 2] = b;
+        offset += 3;
+    }
+}
+
+template <typename Convert>
+void report(const char *name, int frames, Convert convert) {
+    convert(); // warm up
+    const auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        convert();
+    }
+    const double seconds = std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
+    std::printf("%-10s %8.1f us/frame  %9.0f frames/sec  %7.1f Mpixels/sec\n",
+                name, seconds * 1e6 / frames, frames / seconds,
+                static_cast<double>(PIXELS) * frames / seconds / 1e6);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    const int frames = argc > 1 ? std::stoi(argv[1]) : 5000;
+
+    std::vector<uint8_t> indices(PIXELS);
+    for (std::size_t i = 0; i < PIXELS; i++) {
+        indices[i] = static_cast<uint8_t>((i * 7 + i / SCREEN_WIDTH) & 0x3F);
+    }
+    std::vector<uint8_t> rgb(PIXELS * 3);
+    std::vector<uint8_t> rgba(PIXELS * 4);
+
+    std::printf("frames:    %d of %zu pixels\n", frames, PIXELS);
+    report("per-pixel", frames, [&] { convertPerPixelRGB(indices, rgb); });
+    for (PaletteConversionPath path :
+         {PaletteConversionPath::Scalar, PaletteConversionPath::SSSE3,
+          PaletteConversionPath::AVX2, PaletteConversionPath::NEON}) {
+        if (!paletteConversionSupported(path)) {
+            continue;
+        }
+        report(paletteConversionPathName(path), frames, [&] {
+            convertPaletteIndicesToRGBA(path, indices.data(), PIXELS,
+                                        rgba.data());
+        });
+    }
+    std::printf("best:      %s\n",
+                paletteConversionPathName(bestPaletteConversionPath()));
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../include/Constants.h"
+#include "../include/Renderer/PaletteConversion.h"
+#include "../include/Renderer/Scaler.h"
+
+/**
+ * Scaler stage benchmark. Runs every scaler at the window scaling factor,
+ * vectorized and scalar, over a frame converted from palette indices and
+ * reports the time per frame. Palette conversion is timed separately as the
+ * stage that runs before any scaler.
+ *
+ * Usage: benchScaler [frames]
+ */
+
+namespace {
+
+constexpr std::size_t PIXELS =
+    static_cast<std::size_t>(SCREEN_WIDTH) * SCREEN_HEIGHT;
+
+template <typename Stage> void report(const std::string &name, int frames,
+                                      Stage stage) {
+    stage(); // warm up
+    const auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        stage();
+    }
+    const double seconds = std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
+    std::printf("%-20s %8.1f us/frame  %9.0f frames/sec\n", name.c_str(),
+                seconds * 1e6 / frames, frames / seconds);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    const int frames = argc > 1 ? std::stoi(argv[1]) : 2000;
+
+    // stripes and blocks, so EPX finds both flat areas and edges
+    std::vector<uint8_t> indices(PIXELS);
+    for (std::size_t i = 0; i < PIXELS; i++) {
+        const std::size_t x = i % SCREEN_WIDTH;
+        const std::size_t y = i / SCREEN_WIDTH;
+        indices[i] = static_cast<uint8_t>(((x / 8) ^ (y / 8) ^ (x + y) / 13) &
+                                          0x3F);
+    }
+    std::vector<uint32_t> rgba(PIXELS);
+
+    std::printf("frames:              %d, x%d\n", frames, SCREEN_SCALING);
+    report("palette conversion", frames, [&] {
+        convertPaletteIndicesToRGBA(indices.data(), PIXELS,
+                                    reinterpret_cast<uint8_t *>(rgba.data()));
+    });
+
+    for (ScalerKind kind : {ScalerKind::GPU, ScalerKind::Nearest,
+                            ScalerKind::Scanlines, ScalerKind::EPX}) {
+        for (bool vectorized : {true, false}) {
+            if (kind == ScalerKind::GPU && !vectorized) {
+                continue;
+            }
+            auto scaler = makeScaler(kind, SCREEN_SCALING, vectorized);
+            const std::string name =
+                std::string(scalerKindName(kind)) +
+                (kind == ScalerKind::GPU ? ""
+                                         : vectorized ? " simd" : " scalar");
+            volatile uint32_t sink = 0;
+            report(name, frames, [&] { sink = *scaler->scale(rgba.data()); });
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,177 @@
+#ifndef APU_H
+#define APU_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "AudioRing.h"
+#include "BlipBuffer.h"
+#include "Channels.h"
+
+class Cartridge;
+class StateWriter;
+class StateReader;
+enum class NESRegion;
+
+// step of the frame counter sequence, see APU.cpp
+struct FrameCounterStep {
+    uint16_t cycle; // CPU cycles after the sequence started
+    uint8_t events;
+};
+using FrameSequence = std::array<FrameCounterStep, 6>;
+
+/**
+ * 2A03 audio processing unit: two pulse channels, triangle, noise and DMC,
+ * plus the frame counter that clocks their envelopes, sweeps and length
+ * counters and raises the frame IRQ. https://www.nesdev.org/wiki/APU
+ *
+ * The APU is not stepped every CPU cycle. clock() only counts cycles, which
+ * are run when a register is accessed, the frame ends or an event is due (a
+ * frame counter step or a DMC sample fetch, the only things that affect the
+ * CPU). Channels then advance from one timer expiry to the next, and every
+ * change of the mixed output is added to a BlipBuffer as a band-limited
+ * step, so the cost follows the number of output transitions.
+ *
+ * Mixing uses the nonlinear 2A03 DAC response from precomputed tables.
+ * Samples are pushed into output() at the end of each frame.
+ */
+class APU {
+  public:
+    static constexpr double DEFAULT_SAMPLE_RATE = 48000.0;
+
+  private:
+    Cartridge &cart; // DMC samples are read from $8000-$FFFF
+
+    Pulse pulse1;
+    Pulse pulse2;
+    Triangle triangle;
+    Noise noise;
+    DMC dmc;
+
+    // frame counter ($4017)
+    bool fiveStep = false;
+    bool irqInhibit = false;
+    bool frameIRQ = false;
+    int32_t frameCycle = 0; // negative while a $4017 reset is delayed
+    uint8_t frameStep = 0;  // next step of the sequence
+
+    uint64_t cycle = 0;          // CPU cycles run since power on
+    uint32_t pendingCycles = 0;  // counted by clock() but not run yet
+    uint32_t cyclesToEvent = 0;  // catchUp() must run before more pass
+    uint32_t stallCycles = 0;    // DMC DMA cycles the CPU has not waited yet
+
+    // region tables
+    const std::array<uint16_t, 16> *noisePeriods;
+    const std::array<uint16_t, 16> *dmcPeriods;
+    const FrameSequence *fourStepSequence;
+    const FrameSequence *fiveStepSequence;
+    double cpuHz;
+
+    // output, not part of the machine state
+    BlipBuffer blip;
+    AudioRing ring;
+    std::vector<int16_t> samples; // read from blip, reused between frames
+    double sampleRate = DEFAULT_SAMPLE_RATE;
+    double rateRatio = 1.0; // applied to blip at the next flush
+    uint32_t time = 0;    // CPU cycles since the audio frame started
+    uint32_t mutedAt = 0; // time when setAudioOutput(false) was called
+    bool audioOutput = true;
+    uint8_t pulseIndex = 0; // mixer inputs last added to blip
+    uint8_t tndIndex = 0;
+
+    void catchUp();
+    void run(uint32_t cycles);
+    void runPulses(uint32_t cycles);
+    void runTND(uint32_t cycles);
+    void updateOutput();
+    void handleEvents();
+    void schedule();
+    void stepFrameCounter(uint8_t events);
+    void clockQuarterFrame();
+    void clockHalfFrame();
+    void fetchSample();
+    void flushSamples();
+
+    const FrameSequence &sequence() const {
+        return fiveStep ? *fiveStepSequence : *fourStepSequence;
+    }
+
+  public:
+    APU(const APU &) = delete;
+    APU &operator=(const APU &) = delete;
+    APU(APU &&) = delete;
+    APU &operator=(APU &&) = delete;
+
+    explicit APU(Cartridge &cart);
+
+    /**
+     * Selects NTSC or PAL timing. Dendy consoles use NTSC APU timing with
+     * the PAL CPU clock.
+     */
+    void setRegion(NESRegion region);
+
+    void setSampleRate(double rate);
+    double getSampleRate() const { return sampleRate; }
+
+    /**
+     * Produces ratio times as many samples per emulated second from the
+     * next audio frame on, so the output can be steered to match a device
+     * whose clock runs slightly apart from the emulator's. ratio is limited
+     * to within 1% of 1.
+     */
+    void setRateRatio(double ratio) { rateRatio = ratio; }
+
+    /**
+     * Advances the APU by cpuCycles. Only counts them unless an event is
+     * due, so it is cheap to call every cycle.
+     */
+    void clock(uint32_t cpuCycles) {
+        pendingCycles += cpuCycles;
+        if (pendingCycles >= cyclesToEvent) {
+            catchUp();
+        }
+    }
+
+    /**
+     * Runs all counted cycles and moves the samples of the frame into
+     * output(). Call once per video frame.
+     */
+    void endFrame();
+
+    /**
+     * While disabled nothing is synthesised or pushed to output(), and
+     * re-enabling continues the audio frame from where it was disabled.
+     * For run-ahead frames, which are emulated and then rolled back.
+     */
+    void setAudioOutput(bool enabled);
+
+    AudioRing &output() { return ring; }
+    const AudioRing &output() const { return ring; }
+
+    uint8_t readStatus(); // $4015
+    void writeRegister(uint16_t addr, uint8_t value);
+
+    // level of the APU IRQ line (frame counter or DMC)
+    bool irqAsserted() const { return frameIRQ || dmc.irq; }
+
+    /**
+     * Cycles the CPU must be stalled for DMC sample fetches since the last
+     * call.
+     */
+    uint32_t takeStallCycles() {
+        const uint32_t stall = stallCycles;
+        stallCycles = 0;
+        return stall;
+    }
+
+    uint64_t getCycleCount() const { return cycle + pendingCycles; }
+
+    // Channel, frame counter and DMA state; buffered audio is not saved.
+    // Counted cycles are run first, so a state does not depend on when the
+    // APU last caught up.
+    void saveState(StateWriter &out);
+    void loadState(StateReader &in);
+};
+
+#endif // APU_H
@@ -0,0 +1,39 @@
+#ifndef AUDIODEVICE_H
+#define AUDIODEVICE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "AudioRing.h"
+
+struct SDL_AudioStream;
+
+/**
+ * Plays the samples of an AudioRing on the default SDL playback device. SDL
+ * pulls from the ring on its own audio thread whenever the device needs
+ * more; if the emulator has fallen behind, the last sample is held rather
+ * than dropping to 0, which would click.
+ */
+class AudioDevice {
+  private:
+    AudioRing &ring;
+    SDL_AudioStream *stream = nullptr;
+    std::vector<int16_t> buffer; // used by the SDL audio thread only
+    int16_t lastSample = 0;
+
+    static void feed(void *userdata, SDL_AudioStream *stream,
+                     int additionalAmount, int totalAmount);
+
+  public:
+    AudioDevice(const AudioDevice &) = delete;
+    AudioDevice &operator=(const AudioDevice &) = delete;
+
+    /**
+     * Opens a mono signed 16-bit stream at sampleRate and starts playback.
+     * Throws std::runtime_error if SDL has no audio device.
+     */
+    AudioDevice(AudioRing &ring, int sampleRate);
+    ~AudioDevice();
+};
+
+#endif // AUDIODEVICE_H
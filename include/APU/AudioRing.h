@@ -0,0 +1,94 @@
+#ifndef AUDIORING_H
+#define AUDIORING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Hands audio samples from the emulation thread to the audio device callback
+ * without locks. A single-producer, single-consumer ring: each side only
+ * writes its own index, and the release store of an index publishes the
+ * samples before it to the other side. Neither side ever waits; a full ring
+ * drops the newest samples and an empty one reads nothing. Both are counted,
+as overruns and underruns, to tell how well the two sides keep pace.
+ *
+ * Exactly one thread may call push() and one thread pop().
+ */
+class AudioRing {
+  private:
+    std::vector<int16_t> samples; // capacity is a power of two
+    std::size_t mask;
+    alignas(64) std::atomic<std::size_t> writeIndex{0};
+    std::atomic<uint64_t> overruns{0}; // pushes that dropped samples
+    alignas(64) std::atomic<std::size_t> readIndex{0};
+    std::atomic<uint64_t> underruns{0}; // pops that came up short
+
+  public:
+    // capacity is rounded up to a power of two
+    explicit AudioRing(std::size_t capacity) {
+        std::size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        samples.assign(size, 0);
+        mask = size - 1;
+    }
+
+    AudioRing(const AudioRing &) = delete;
+    AudioRing &operator=(const AudioRing &) = delete;
+
+    std::size_t capacity() const { return samples.size(); }
+
+    // samples waiting to be popped, exact only on the consumer thread
+    std::size_t size() const {
+        return writeIndex.load(std::memory_order_acquire) -
+               readIndex.load(std::memory_order_acquire);
+    }
+
+    uint64_t overrunCount() const {
+        return overruns.load(std::memory_order_relaxed);
+    }
+    uint64_t underrunCount() const {
+        return underruns.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Copies as many of count samples as fit. Returns the number copied.
+     */
+    std::size_t push(const int16_t *in, std::size_t count) {
+        const std::size_t write = writeIndex.load(std::memory_order_relaxed);
+        const std::size_t read = readIndex.load(std::memory_order_acquire);
+        const std::size_t space = samples.size() - (write - read);
+        if (count > space) {
+            overruns.fetch_add(1, std::memory_order_relaxed);
+            count = space;
+        }
+        for (std::size_t i = 0; i < count; i++) {
+            samples[(write + i) & mask] = in[i];
+        }
+        writeIndex.store(write + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * Copies up to count samples into out. Returns the number copied; fewer
+     * than count is an underrun.
+     */
+    std::size_t pop(int16_t *out, std::size_t count) {
+        const std::size_t read = readIndex.load(std::memory_order_relaxed);
+        const std::size_t write = writeIndex.load(std::memory_order_acquire);
+        if (count > write - read) {
+            underruns.fetch_add(1, std::memory_order_relaxed);
+            count = write - read;
+        }
+        for (std::size_t i = 0; i < count; i++) {
+            out[i] = samples[(read + i) & mask];
+        }
+        readIndex.store(read + count, std::memory_order_release);
+        return count;
+    }
+};
+
+#endif // AUDIORING_H
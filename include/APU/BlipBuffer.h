@@ -0,0 +1,92 @@
+#ifndef BLIPBUFFER_H
+#define BLIPBUFFER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Band-limited step synthesis, after Shay Green's blip_buf. A signal is
+ * described by the times (in source clock cycles) at which its amplitude
+ * changes and by how much. Each change adds a windowed-sinc impulse at the
+ * output sample position it falls on, with 1/PHASES sample precision, and
+ * reading integrates the impulses back into steps. That gives alias-free
+ * square waves at a cost per amplitude change rather than per clock cycle.
+ *
+ * Time restarts at 0 after every endFrame(). A frame may be at most
+ * maxFrameClocks long.
+ */
+class BlipBuffer {
+  public:
+    static constexpr int PHASE_BITS = 5;
+    static constexpr int PHASES = 1 << PHASE_BITS;
+    static constexpr int TAPS = 16;
+    // furthest setRateRatio() may move the output rate from setRates()
+    static constexpr double MAX_RATE_RATIO = 1.01;
+
+  private:
+    static constexpr int FRAC_BITS = 32;
+
+    std::array<std::array<float, TAPS>, PHASES> kernel{};
+    std::vector<float> impulses; // pending, not yet integrated
+    double baseFactor = 0.0;     // output samples per clock at ratio 1
+    uint64_t factor = 0;         // output samples per clock, 32.32 fixed
+    uint64_t offset = 0;         // position of time 0, 32.32 fixed
+    std::size_t available = 0;   // complete samples at the front of impulses
+    std::size_t capacity = 0;    // samples impulses can hold, excluding TAPS
+
+    float integrator = 0.0f;
+    float highPass = 0.0f;      // DC level removed from the output
+    float highPassCoefficient = 0.0f;
+
+  public:
+    BlipBuffer();
+
+    /**
+     * Sets the source clock and output sample rates and clears the buffer.
+     */
+    void setRates(double clockRate, double sampleRate, uint32_t maxFrameClocks);
+
+    /**
+     * Scales the output rate of setRates() by ratio, between
+     * 1 / MAX_RATE_RATIO and MAX_RATE_RATIO, without clearing the buffer.
+     * For dynamic rate control; call only between frames.
+     */
+    void setRateRatio(double ratio);
+
+    void clear();
+
+    /**
+     * Adds a step of delta to the output at time clocks into the frame.
+     */
+    void addDelta(uint32_t time, float delta) {
+        const uint64_t position = offset + time * factor;
+        const std::size_t sample =
+            static_cast<std::size_t>(position >> FRAC_BITS);
+        const auto phase = static_cast<std::size_t>(
+            (position >> (FRAC_BITS - PHASE_BITS)) & (PHASES - 1));
+        float *out = impulses.data() + sample;
+        const std::array<float, TAPS> &taps = kernel[phase];
+        for (int i = 0; i < TAPS; i++) {
+            out[i] += taps[i] * delta;
+        }
+    }
+
+    /**
+     * Ends the frame clocks cycles long. Samples before its end become
+     * available to readSamples().
+     */
+    void endFrame(uint32_t clocks);
+
+    std::size_t samplesAvailable() const { return available; }
+
+    /**
+     * Moves up to count samples into out as signed 16-bit, full scale at an
+     * amplitude of 1.0 above or below the DC level. Returns the number of
+     * samples read.
+     */
+    std::size_t readSamples(int16_t *out, std::size_t count);
+};
+
+#endif // BLIPBUFFER_H
@@ -0,0 +1,421 @@
+#ifndef CHANNELS_H
+#define CHANNELS_H
+
+#include <array>
+#include <cstdint>
+
+/**
+ * APU sound channels. https://www.nesdev.org/wiki/APU
+ *
+ * Channel timers count CPU cycles. timer is the number of cycles until the
+ * timer next expires and clocks the channel's sequencer, it is never 0. run()
+ * advances a channel by any number of cycles at once; APU only has to stop at
+ * an expiry while active(), because an inactive channel's output cannot
+ * change until a register write or frame counter step makes it active.
+ */
+
+// notes loaded into the length counters by the upper 5 bits of $4003 etc.
+inline constexpr std::array<uint8_t, 32> LENGTH_TABLE = {
+    10, 254, 20, 2,  40, 4,  80, 6,  160, 8,  60, 10, 14, 12, 26, 14,
+    12, 16,  24, 18, 48, 20, 96, 22, 192, 24, 72, 26, 16, 28, 32, 30,
+};
+
+/**
+ * Volume envelope shared by the pulse and noise channels, clocked every
+ * quarter frame.
+ */
+struct Envelope {
+    bool start = false;
+    bool loop = false;     // also halts the length counter
+    bool constant = false; // output period as volume instead of decay
+    uint8_t period = 0;    // 4-bit volume / divider period
+    uint8_t divider = 0;
+    uint8_t decay = 0;
+
+    void write(uint8_t value) {
+        loop = (value & 0x20) != 0;
+        constant = (value & 0x10) != 0;
+        period = value & 0x0F;
+    }
+
+    void clock() {
+        if (start) {
+            start = false;
+            decay = 15;
+            divider = period;
+        } else if (divider > 0) {
+            divider--;
+        } else {
+            divider = period;
+            if (decay > 0) {
+                decay--;
+            } else if (loop) {
+                decay = 15;
+            }
+        }
+    }
+
+    uint8_t volume() const { return constant ? period : decay; }
+};
+
+/**
+ * Pulse channels ($4000-$4007). The timer runs at half the CPU clock, so one
+ * step of the 8 step duty sequence takes 2 * (period + 1) CPU cycles.
+ */
+struct Pulse {
+    static constexpr std::array<uint8_t, 4> DUTY = {
+        0b00000001, 0b00000011, 0b00001111, 0b11111100};
+
+    Envelope envelope;
+    uint8_t duty = 0;
+    uint8_t sequence = 0;
+    uint16_t period = 0; // 11-bit timer period
+    uint32_t timer = 2;
+    uint8_t length = 0;
+    bool enabled = false;
+
+    bool sweepEnabled = false;
+    bool sweepNegate = false;
+    bool sweepReload = false;
+    uint8_t sweepPeriod = 0;
+    uint8_t sweepShift = 0;
+    uint8_t sweepDivider = 0;
+    bool onesComplement = false; // pulse 1 negates with one's complement
+
+    void write(uint16_t reg, uint8_t value) {
+        switch (reg & 0x03) {
+        case 0:
+            duty = value >> 6;
+            envelope.write(value);
+            break;
+        case 1:
+            sweepEnabled = (value & 0x80) != 0;
+            sweepPeriod = (value >> 4) & 0x07;
+            sweepNegate = (value & 0x08) != 0;
+            sweepShift = value & 0x07;
+            sweepReload = true;
+            break;
+        case 2:
+            period = static_cast<uint16_t>((period & 0x0700) | value);
+            break;
+        case 3:
+            period = static_cast<uint16_t>((period & 0x00FF) |
+                                           ((value & 0x07) << 8));
+            if (enabled) {
+                length = LENGTH_TABLE[value >> 3];
+            }
+            sequence = 0;
+            envelope.start = true;
+            break;
+        }
+    }
+
+    uint16_t sweepTarget() const {
+        const uint16_t change = period >> sweepShift;
+        if (!sweepNegate) {
+            return static_cast<uint16_t>(period + change);
+        }
+        const int target = period - change - (onesComplement ? 1 : 0);
+        return static_cast<uint16_t>(target < 0 ? 0 : target);
+    }
+
+    // the sweep unit mutes the channel even when it is not enabled
+    bool muted() const { return period < 8 || sweepTarget() > 0x07FF; }
+
+    void clockSweep() {
+        if (sweepDivider == 0 && sweepEnabled && sweepShift > 0 && !muted()) {
+            period = sweepTarget();
+        }
+        if (sweepDivider == 0 || sweepReload) {
+            sweepDivider = sweepPeriod;
+            sweepReload = false;
+        } else {
+            sweepDivider--;
+        }
+    }
+
+    void clockLength() {
+        if (length > 0 && !envelope.loop) {
+            length--;
+        }
+    }
+
+    uint32_t timerPeriod() const { return 2 * (period + 1u); }
+    bool active() const {
+        return length > 0 && !muted() && envelope.volume() > 0;
+    }
+
+    uint8_t output() const {
+        if (length == 0 || muted() || !((DUTY[duty] >> sequence) & 1)) {
+            return 0;
+        }
+        return envelope.volume();
+    }
+
+    void run(uint32_t cycles) {
+        if (cycles < timer) {
+            timer -= cycles;
+            return;
+        }
+        cycles -= timer;
+        const uint32_t periodCycles = timerPeriod();
+        const uint32_t clocks = 1 + cycles / periodCycles;
+        timer = periodCycles - cycles % periodCycles;
+        sequence = static_cast<uint8_t>((sequence + clocks) & 0x07);
+    }
+};
+
+/**
+ * Triangle channel ($4008-$400B). The timer runs at the CPU clock and steps a
+ * 32 step sequence while both the length and linear counters are nonzero.
+ */
+struct Triangle {
+    uint8_t sequence = 0;
+    uint16_t period = 0;
+    uint32_t timer = 1;
+    uint8_t length = 0;
+    bool enabled = false;
+    bool control = false; // halts the length counter, holds linear reload
+    uint8_t linearReloadValue = 0;
+    uint8_t linear = 0;
+    bool linearReload = false;
+
+    void write(uint16_t reg, uint8_t value) {
+        switch (reg & 0x03) {
+        case 0:
+            control = (value & 0x80) != 0;
+            linearReloadValue = value & 0x7F;
+            break;
+        case 2:
+            period = static_cast<uint16_t>((period & 0x0700) | value);
+            break;
+        case 3:
+            period = static_cast<uint16_t>((period & 0x00FF) |
+                                           ((value & 0x07) << 8));
+            if (enabled) {
+                length = LENGTH_TABLE[value >> 3];
+            }
+            linearReload = true;
+            break;
+        default:
+            break;
+        }
+    }
+
+    void clockLinear() {
+        if (linearReload) {
+            linear = linearReloadValue;
+        } else if (linear > 0) {
+            linear--;
+        }
+        if (!control) {
+            linearReload = false;
+        }
+    }
+
+    void clockLength() {
+        if (length > 0 && !control) {
+            length--;
+        }
+    }
+
+    uint32_t timerPeriod() const { return period + 1u; }
+
+    // Periods below 2 are ultrasonic and only produce a pop on hardware, so
+    // the sequence is held there instead, as in most emulators.
+    bool active() const { return length > 0 && linear > 0 && period >= 2; }
+
+    uint8_t output() const {
+        return sequence < 16 ? 15 - sequence : sequence - 16;
+    }
+
+    void run(uint32_t cycles) {
+        if (cycles < timer) {
+            timer -= cycles;
+            return;
+        }
+        cycles -= timer;
+        const uint32_t periodCycles = timerPeriod();
+        const uint32_t clocks = 1 + cycles / periodCycles;
+        timer = periodCycles - cycles % periodCycles;
+        if (active()) {
+            sequence = static_cast<uint8_t>((sequence + clocks) & 0x1F);
+        }
+    }
+};
+
+/**
+ * Noise channel ($400C-$400F). A 15-bit LFSR clocked at one of 16 rates;
+ * periods differ between NTSC and PAL.
+ */
+struct Noise {
+    Envelope envelope;
+    bool shortMode = false; // feedback from bit 6 instead of bit 1
+    uint16_t shift = 1;
+    uint16_t period = 4; // CPU cycles
+    uint32_t timer = 4;
+    uint8_t length = 0;
+    bool enabled = false;
+
+    void write(uint16_t reg, uint8_t value,
+               const std::array<uint16_t, 16> &periods) {
+        switch (reg & 0x03) {
+        case 0:
+            envelope.write(value);
+            break;
+        case 2:
+            shortMode = (value & 0x80) != 0;
+            period = periods[value & 0x0F];
+            break;
+        case 3:
+            if (enabled) {
+                length = LENGTH_TABLE[value >> 3];
+            }
+            envelope.start = true;
+            break;
+        default:
+            break;
+        }
+    }
+
+    void clockLength() {
+        if (length > 0 && !envelope.loop) {
+            length--;
+        }
+    }
+
+    uint32_t timerPeriod() const { return period; }
+    bool active() const { return length > 0 && envelope.volume() > 0; }
+
+    uint8_t output() const {
+        return (length == 0 || (shift & 1)) ? 0 : envelope.volume();
+    }
+
+    void run(uint32_t cycles) {
+        if (cycles < timer) {
+            timer -= cycles;
+            return;
+        }
+        cycles -= timer;
+        const uint32_t clocks = 1 + cycles / period;
+        timer = period - cycles % period;
+        const unsigned tap = shortMode ? 6 : 1;
+        for (uint32_t i = 0; i < clocks; i++) {
+            const uint16_t feedback = (shift ^ (shift >> tap)) & 1;
+            shift = static_cast<uint16_t>((shift >> 1) | (feedback << 14));
+        }
+    }
+};
+
+/**
+ * Delta modulation channel ($4010-$4013). Plays 1-bit delta samples read from
+ * $C000-$FFFF by DMA; fetching the next byte is left to the APU, which
+ * stalls the CPU for it.
+ */
+struct DMC {
+    bool irqEnabled = false;
+    bool loop = false;
+    bool irq = false;
+    uint16_t period = 428; // CPU cycles
+    uint32_t timer = 428;
+    uint8_t level = 0; // 7-bit output
+    uint16_t sampleAddress = 0xC000;
+    uint16_t sampleLength = 1;
+    uint16_t address = 0xC000;
+    uint16_t bytesRemaining = 0;
+    uint8_t buffer = 0;
+    bool bufferFull = false;
+    uint8_t shift = 0;
+    uint8_t bitsRemaining = 8;
+    bool silence = true;
+
+    void write(uint16_t reg, uint8_t value,
+               const std::array<uint16_t, 16> &periods) {
+        switch (reg & 0x03) {
+        case 0:
+            irqEnabled = (value & 0x80) != 0;
+            loop = (value & 0x40) != 0;
+            period = periods[value & 0x0F];
+            if (!irqEnabled) {
+                irq = false;
+            }
+            break;
+        case 1:
+            level = value & 0x7F;
+            break;
+        case 2:
+            sampleAddress = static_cast<uint16_t>(0xC000 | (value << 6));
+            break;
+        case 3:
+            sampleLength = static_cast<uint16_t>((value << 4) | 1);
+            break;
+        }
+    }
+
+    void restart() {
+        address = sampleAddress;
+        bytesRemaining = sampleLength;
+    }
+
+    bool needsFetch() const { return !bufferFull && bytesRemaining > 0; }
+
+    // stores a fetched sample byte and advances to the next address
+    void fill(uint8_t value) {
+        buffer = value;
+        bufferFull = true;
+        address = static_cast<uint16_t>(address == 0xFFFF ? 0x8000
+                                                           : address + 1);
+        if (--bytesRemaining == 0) {
+            if (loop) {
+                restart();
+            } else if (irqEnabled) {
+                irq = true;
+            }
+        }
+    }
+
+    // CPU cycles until the output unit empties the full sample buffer
+    uint32_t cyclesUntilBufferEmpty() const {
+        return timer + (bitsRemaining - 1u) * period;
+    }
+
+    uint32_t timerPeriod() const { return period; }
+    bool active() const { return !silence || bufferFull; }
+    uint8_t output() const { return level; }
+
+    void clockOutput() {
+        if (!silence) {
+            if (shift & 1) {
+                if (level <= 125) {
+                    level += 2;
+                }
+            } else if (level >= 2) {
+                level -= 2;
+            }
+        }
+        shift >>= 1;
+        if (--bitsRemaining == 0) {
+            bitsRemaining = 8;
+            silence = !bufferFull;
+            if (bufferFull) {
+                shift = buffer;
+                bufferFull = false;
+            }
+        }
+    }
+
+    void run(uint32_t cycles) {
+        if (cycles < timer) {
+            timer -= cycles;
+            return;
+        }
+        cycles -= timer;
+        const uint32_t clocks = 1 + cycles / period;
+        timer = period - cycles % period;
+        for (uint32_t i = 0; i < clocks; i++) {
+            clockOutput();
+        }
+    }
+};
+
+#endif // CHANNELS_H
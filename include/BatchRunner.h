@@ -0,0 +1,101 @@
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Clock.h"
+
+class RomImage;
+
+/**
+ * One headless run for BatchRunner: a ROM, how long to run it and what joypad
+ * 1 does in each frame.
+ */
+struct BatchJob {
+    std::shared_ptr<const RomImage> rom;
+    uint64_t frames = 600;
+    // buttons held on joypad 1 in each frame (Bus::JOYPAD_* bits); frames
+    // past the end of the movie hold none
+    std::vector<uint8_t> inputMovie;
+    // without a movie, a non-zero seed holds random buttons each frame
+    uint64_t inputSeed = 0;
+    SyncMode syncMode = SyncMode::CycleStepped;
+    bool recordFrameHashes = false; // keep every frame's hash, not just the last
+};
+
+/**
+ * Outcome of a BatchJob.
+ */
+struct BatchResult {
+    uint64_t frames = 0;    // frames completed
+    uint64_t cpuCycles = 0; // CPU cycles executed
+    uint64_t frameHash = 0; // FNV-1a hash of the last frame
+    std::vector<uint64_t> frameHashes; // every frame, if recorded
+    uint64_t ramHash = 0;              // FNV-1a hash of ram
+    std::array<uint8_t, 0x0800> ram{}; // CPU RAM after the last frame
+    double elapsedSeconds = 0.0;
+    std::string error; // why the run stopped early, empty if it did not
+
+    bool ok() const { return error.empty(); }
+};
+
+/**
+ * How a BatchRunner::run() call was spread over its threads.
+ */
+struct BatchStats {
+    unsigned threads = 0;
+    std::size_t jobs = 0;
+    std::size_t steals = 0;      // jobs run by a thread they were not dealt to
+    double elapsedSeconds = 0.0; // wall clock time of the whole batch
+    double busySeconds = 0.0;    // sum of the jobs' own run times
+
+    // fraction of the threads' time spent running jobs
+    double utilisation() const {
+        return elapsedSeconds > 0.0 && threads > 0
+                   ? busySeconds / (elapsedSeconds * threads)
+                   : 0.0;
+    }
+};
+
+/**
+ * Runs many independent consoles at once, for regression sweeps and input
+ * searches. Each job gets its own NES, built and run headless on a worker
+ * thread, so nothing touches SDL and jobs share nothing but ROM images.
+ *
+ * Jobs are dealt to the threads in contiguous blocks, each taken from the
+ * front by its own thread. A thread that runs out steals from the back of
+ * another's block, so long and short jobs even out without every job going
+ * through one shared queue.
+ */
+class BatchRunner {
+  private:
+    unsigned threads;
+    BatchStats statistics;
+
+  public:
+    // 0 threads uses one per hardware thread
+    explicit BatchRunner(unsigned threads = 0);
+
+    unsigned threadCount() const { return threads; }
+
+    /**
+     * Runs every job and returns their results in the same order. A job that
+     * throws (a bad ROM, say) records the error in its result and does not
+     * stop the others.
+     */
+    std::vector<BatchResult> run(const std::vector<BatchJob> &jobs);
+
+    const BatchStats &stats() const { return statistics; }
+
+    /**
+     * Runs one job on the calling thread.
+     */
+    static BatchResult runJob(const BatchJob &job);
+};
+
+#endif // BATCHRUNNER_H
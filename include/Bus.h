@@ -4,12 +4,14 @@
 #include <array>
 #include <cstdint>
 
+#include "APU/APU.h"
 #include "Cartridge.h"
 #include "BusInterface.h"
 #include "PPU/PPU.h"
+#include "SaveState.h"
 
 // Memory Management Unit (Bus)
-class Bus : public BusInterface {
+class Bus final : public BusInterface {
  private:
   // https://fceux.com/web/help/NESRAMMappingFindingValues.html
   std::array<uint8_t, 0x0800> cpu_ram;  // $0000 – $07FF: CPU RAM
@@ -18,9 +20,16 @@ class Bus : public BusInterface {
                                         // $2008 – $3FFF: mirrors of PPU regs
   std::array<uint8_t, 0x0020> apu_io;   // $4000 – $401F: APU & I/O registers
   // std::array<uint8_t, 0x1FE0> exp_rom;  // $4020 – $5FFF: cart expansion ROM
-  // std::array<uint8_t, 0x2000> s_ram;    // $6000 – $7FFF: save RAM
-  Cartridge& cart;  // $8000 - $FFFF: cartridge ROM
+  Cartridge& cart;  // $6000 - $7FFF: cartridge PRG RAM
+                    // $8000 - $FFFF: cartridge ROM and mapper registers
   PPU& ppu;
+  APU& apu;
+
+  // One entry per 256 byte page of CPU address space. Accesses to a page with
+  // a pointer are a single load or store; null pages go to readIO/writeIO.
+  static constexpr int PAGE_COUNT = 0x100;
+  std::array<const uint8_t*, PAGE_COUNT> readPages{};
+  std::array<uint8_t*, PAGE_COUNT> writePages{};
   uint8_t joypad1Buttons = 0x00;
   uint8_t joypad1Shift = 0x00;
   bool joypadStrobe = false;
@@ -42,16 +51,40 @@ class Bus : public BusInterface {
   Bus(Bus&&) = delete;
   Bus& operator=(Bus&&) = delete;
 
-  Bus(PPU& ppu, Cartridge& cart)
+  Bus(PPU& ppu, APU& apu, Cartridge& cart)
       : cpu_ram{},
         apu_io{},
         // exp_rom{},
-        // s_ram{},
         cart(cart),
         ppu(ppu),
+        apu(apu),
         cycles(0)
   {
     apu_io.fill(0xFF);  // init FF
+    // CPU RAM mirror: 0x0000 - 0x1FFF
+    for (int page = 0x00; page <= 0x1F; page++) {
+      uint8_t* ram = cpu_ram.data() + ((page & 0x07) << 8);
+      readPages[page] = ram;
+      writePages[page] = ram;
+    }
+    mapCartridge();
+  }
+
+  /**
+   * Points the PRG RAM and ROM pages at the cartridge's current banks. Must be
+   * called after loading a cartridge or restoring its mapper state; mapper
+   * register writes through the bus remap automatically. ROM pages have no
+   * write pointer, so writes reach the mapper.
+   */
+  void mapCartridge() {
+    for (int page = 0x60; page < 0x80; page++) {
+      uint8_t* ram = cart.prg_ram_page(static_cast<uint16_t>(page << 8));
+      readPages[page] = ram;
+      writePages[page] = ram;
+    }
+    for (int page = 0x80; page < PAGE_COUNT; page++) {
+      readPages[page] = cart.prg_page(static_cast<uint16_t>(page << 8));
+    }
   }
 
   inline bool ppuNMI() { return ppu.getNMI(); }
@@ -59,7 +92,29 @@ class Bus : public BusInterface {
   inline uint16_t getPPUCycle() override { return ppu.getCycle(); }
 
   inline uint64_t getCycleCount() const { return cycles; }
+  inline const std::array<uint8_t, 0x0800>& getCPURAM() const {
+    return cpu_ram;
+  }
   inline void resetCycles() { cycles = 0; }
+
+  // RAM, I/O registers and controller latch; PPU and cartridge save their own
+  void saveState(StateWriter& out) const {
+    out.write(cpu_ram);
+    out.write(apu_io);
+    out.write(joypad1Buttons);
+    out.write(joypad1Shift);
+    out.write(joypadStrobe);
+    out.write(cycles);
+  }
+
+  void loadState(StateReader& in) {
+    in.read(cpu_ram);
+    in.read(apu_io);
+    in.read(joypad1Buttons);
+    in.read(joypad1Shift);
+    in.read(joypadStrobe);
+    in.read(cycles);
+  }
   inline void setJoypad1Buttons(uint8_t buttons) {
     joypad1Buttons = buttons;
     if (joypadStrobe) {
@@ -69,27 +124,34 @@ class Bus : public BusInterface {
 
   inline uint8_t read(uint16_t addr) override {
     // cycles++;
-    // CPU RAM mirror: 0x0000 - 0x1FFF
-    if (addr <= 0x1FFF) {
-      addr &= 0b0000011111111111;  // mirror down addr
-      return cpu_ram[addr];
-    } else if (addr == 0x2002) {
-      return ppu.read_status();
-    } else if (addr == 0x2004) {
-      return ppu.read_oam_data();
-    } else if (addr == 0x2007) {
-      return ppu.cpuRead();
-    } else if ((addr >= 0x2000) && (addr <= 0x2006)) {
-      // 0x2000, 0x2001, 0x2003, 0x2005, 0x2006
-      // PPU READ ONLY - return last value written to 0x2000 -> 0x2007
-      return ppu.lastWrittenValue();
+    if (const uint8_t* page = readPages[addr >> 8]) {
+      return page[addr & 0xFF];
     }
-    // PPU registers mirror: 0x2008 to 0x3FFF
-    else if (addr >= 0x2008 && addr <= 0x3FFF) {
-      // mirror down to 0x2000-0x2007 and recurse
-      return read(addr & 0x2007);
-    } else if (addr >= 0x4000 && addr <= 0x4015) {
-      return 0;  // apu->readRegister(addr);
+    return readIO(addr);
+  }
+
+  // Reads from pages without a direct pointer: registers, unmapped space and
+  // cartridge space while no cartridge is loaded. Kept out of line so read()
+  // stays small enough to inline into every CPU access.
+  __attribute__((noinline)) uint8_t readIO(uint16_t addr) {
+    if (addr >= 0x2000 && addr <= 0x3FFF) {
+      // PPU registers, mirrored every 8 bytes up to 0x3FFF
+      switch (addr & 0x0007) {
+        case 0x2:
+          return ppu.read_status();
+        case 0x4:
+          return ppu.read_oam_data();
+        case 0x7:
+          return ppu.cpuRead();
+        default:
+          // 0x2000, 0x2001, 0x2003, 0x2005, 0x2006
+          // PPU READ ONLY - return last value written to 0x2000 -> 0x2007
+          return ppu.lastWrittenValue();
+      }
+    } else if (addr == 0x4015) {
+      return apu.readStatus();
+    } else if (addr >= 0x4000 && addr <= 0x4014) {
+      return 0;  // write only APU registers and OAM DMA
     } else if (addr == 0x4016) {
       uint8_t value = 0;
       if (joypadStrobe) {
@@ -101,11 +163,11 @@ class Bus : public BusInterface {
       return static_cast<uint8_t>(0x40 | value);
     } else if (addr == 0x4017) {
       return 0x40;
-    } else if (addr >= 0x8000 && addr <= 0xFFFF) {
+    } else if (addr >= 0x8000) {
+      // only reached without a cartridge, throws
       return cart.read_prg_rom(addr);
     } else {
-      // error point / TO-DO: missing exp_rom, s_ram and apu_io
-      // cartridge PRG_ROM space: 0x8000 to 0xFFFF
+      // error point / TO-DO: missing exp_rom and apu_io
       return 0;
     }
   }
@@ -121,6 +183,9 @@ class Bus : public BusInterface {
     } else if (addr >= 0x4000 && addr <= 0x401F) {
       // Nintendulator-style trace convention for I/O space.
       return 0xFF;
+    } else if (addr >= 0x6000 && addr <= 0x7FFF) {
+      const uint8_t* ram = readPages[addr >> 8];
+      return ram ? ram[addr & 0xFF] : 0;
     } else if (addr >= 0x8000 && addr <= 0xFFFF) {
       return cart.read_prg_rom(addr);
     } else {
@@ -130,28 +195,42 @@ class Bus : public BusInterface {
 
   inline void write(uint16_t addr, uint8_t value) override {
     // cycles++;
-    // CPU RAM mirror: 0x0000 - 0x1FFF
-    if (addr <= 0x1FFF) {
-      addr &= 0b0000011111111111;  // mirror down addr
-      cpu_ram[addr] = value;
-    } else if (addr == 0x2000) {
-      ppu.write_to_ctrl(value);
-    } else if (addr == 0x2001) {
-      ppu.write_to_mask(value);
-    } else if (addr == 0x2003) {
-      ppu.write_to_oam_addr(value);
-    } else if (addr == 0x2004) {
-      ppu.write_to_oam_data(value);
-    } else if (addr == 0x2005) {
-      ppu.write_to_scroll(value);
-    } else if (addr == 0x2006) {
-      ppu.write_to_ppu_addr(value);
-    } else if (addr == 0x2007) {
-      ppu.cpuWrite(value);
-    } else if (addr >= 0x2008 && addr <= 0x3FFF) {
-      // PPU registers mirror: 0x2008 to 0x3FFF
-      // mirror down to 0x2000-0x2007 and recurse
-      write(addr & 0x2007, value);
+    if (uint8_t* page = writePages[addr >> 8]) {
+      page[addr & 0xFF] = value;
+      return;
+    }
+    writeIO(addr, value);
+  }
+
+  // Writes to pages without a direct pointer, see readIO
+  __attribute__((noinline)) void writeIO(uint16_t addr, uint8_t value) {
+    if (addr >= 0x2000 && addr <= 0x3FFF) {
+      // PPU registers, mirrored every 8 bytes up to 0x3FFF
+      switch (addr & 0x0007) {
+        case 0x0:
+          ppu.write_to_ctrl(value);
+          break;
+        case 0x1:
+          ppu.write_to_mask(value);
+          break;
+        case 0x3:
+          ppu.write_to_oam_addr(value);
+          break;
+        case 0x4:
+          ppu.write_to_oam_data(value);
+          break;
+        case 0x5:
+          ppu.write_to_scroll(value);
+          break;
+        case 0x6:
+          ppu.write_to_ppu_addr(value);
+          break;
+        case 0x7:
+          ppu.cpuWrite(value);
+          break;
+        default:
+          break;  // 0x2002 is read only
+      }
     } else if (addr == 0x4014) {
       // data written to 0x4014 is the high byte of a memery block
       // in CPU RAM.
@@ -168,7 +247,7 @@ class Bus : public BusInterface {
       // uint16_t add_cycles = (cycles % 2 == 1) ? 514 : 513;
       // tick(add_cycles);  // This would need PPU ticks (add_cycles * 3)
     } else if (addr >= 0x4000 && addr <= 0x4015) {
-      // apu write
+      apu.writeRegister(addr, value);
     } else if (addr == 0x4016) {
       bool newStrobe = (value & 0x01) != 0;
       if (!newStrobe && joypadStrobe) {
@@ -179,9 +258,16 @@ class Bus : public BusInterface {
       }
       joypadStrobe = newStrobe;
     } else if (addr == 0x4017) {
-      // joypad 2
+      // APU frame counter; joypad 2 is read only here
+      apu.writeRegister(addr, value);
+    } else if (addr >= 0x8000) {
+      // mapper register; a bank switch may change pixels the PPU has not
+      // drawn yet, so let it catch up first
+      ppu.catchUpBackground();
+      cart.write_prg(addr, value);
+      mapCartridge();
     } else {
-      // error point / TO-DO: missing exp_rom, s_ram and apu_io
+      // error point / TO-DO: missing exp_rom and apu_io
     }
   }
 };
@@ -3,26 +3,33 @@
 
 #include <array>
 #include <cstdint>
-#include <memory>
-#include <vector>
 
 #include "../Bus.h"
 #include "../Logger.h"
 #include "AddressResolveInfo.h"
 #include "OpCode.h"
+#include "TraceRecord.h"
+
+class StateWriter;
+class StateReader;
 
 enum Interrupt { NONE, RES, NMI, IRQ };
 
+/**
+ * 6502 core, templated on the bus it is attached to so memory accesses are
+ * resolved at compile time and inlined. BusType provides the BusInterface
+ * methods and should be final, so they are never called virtually. CPU<Bus>
+ * and CPU<TestBus> are instantiated in CPU.cpp and CPUStep.cpp.
+ */
+template <typename BusType>
 class CPU {
-  friend class OpCode;
-
  public:
   CPU(const CPU&) = delete;
   CPU& operator=(const CPU&) = delete;
   CPU(CPU&&) = delete;
   CPU& operator=(CPU&&) = delete;
 
-  CPU(BusInterface& bus, Logger& logger)
+  CPU(BusType& bus, Logger& logger)
       : a_register(0),       // accumulator starts at 0
         x_register(0),       // X starts at 0
         y_register(0),       // Y starts at 0
@@ -35,12 +42,34 @@ class CPU {
 
   void tick();
 
+  /**
+   * Executes one whole instruction (or interrupt sequence) and returns the
+   * number of CPU cycles it took. Faster than calling tick() once per cycle,
+   * but all bus accesses of the instruction happen at once, so devices on the
+   * bus can only be caught up afterwards. Falls back to tick() while tracing
+   * or when called part way through an instruction.
+   */
+  uint8_t step();
+
+  void saveState(StateWriter& out) const;
+  void loadState(StateReader& in);
+
   void triggerRES() { pendingRES = true; }
   void triggerNMI() { pendingNMI = true; }
-  void triggerIRQ() { pendingIRQ = true; }
+  // IRQ is level-triggered: taken between instructions for as long as the
+  // line is held and the I flag is clear
+  void setIRQLine(bool asserted) { irqLine = asserted; }
 
   Interrupt checkInterrupt() { return activeInterrupt; }
 
+  uint8_t getA() const { return a_register; }
+  uint8_t getX() const { return x_register; }
+  uint8_t getY() const { return y_register; }
+  uint8_t getStatus() const { return status; }
+  uint16_t getPC() const { return pc; }
+  uint8_t getSP() const { return sp; }
+  uint64_t getCycleCount() const { return cycleCount; }
+
   uint8_t TEST_getA() { return a_register; };
   uint8_t TEST_getX() { return x_register; };
   uint8_t TEST_getY() { return y_register; };
@@ -77,22 +106,25 @@ class CPU {
   uint8_t status;      // processor status (p)
   uint16_t pc;         // program counter
   uint8_t sp;          // stack pointer
-  BusInterface& bus;   // bus
+  BusType& bus;       // bus
   Logger& logger;      // logger
 
   const OpCode* currentOpCode = nullptr;
-  uint8_t readBuffer;
-  std::vector<uint8_t> currentOpBytes;
+  uint8_t readBuffer = 0;
+  std::array<uint8_t, 3> currentOpBytes{};  // opcode followed by operands
+  uint8_t currentOpByteCount = 0;
   uint8_t cyclesRemainingInCurrentInstr = 0;
   uint8_t cyclesRemainingInCurrentInterrupt = 7;
   AddressResolveInfo currAddrResCtx;  // current address resolution context
   uint8_t currentValueAtAddress = 0xFF;
-  std::unique_ptr<CPUState> logState;
+  // trace of the current instruction, logged when the next one starts
+  TraceRecord pendingTrace{};
+  bool tracePending = false;
 
   Interrupt activeInterrupt = Interrupt::NONE;
   bool pendingRES = false;
   bool pendingNMI = false;
-  bool pendingIRQ = false;
+  bool irqLine = false;
 
   // variable to hold the high byte of operand *before* dereferencing
   // only used by illegal opcodes SHA, SHX, SHY, and TAS
@@ -124,13 +156,15 @@ class CPU {
 
   // addressing mode handling
   void computeAbsoluteAddress();
+  uint8_t resolveAddress();
+  uint8_t stepByTicks();
 
   inline uint16_t assembleBytes(uint8_t high, uint8_t low) {
     return (static_cast<uint16_t>(high) << 8) | static_cast<uint16_t>(low);
   }
 
   inline void readOperand() {
-    currentOpBytes.push_back(bus.read(pc));
+    currentOpBytes[currentOpByteCount++] = bus.read(pc);
     pc++;
   }
 
@@ -225,6 +259,18 @@ class CPU {
   void opi_SBC(uint16_t addr);
   void opi_NOP(uint16_t addr);
   void opi_KIL(uint16_t addr);
+
+  // calls the handler of the current opcode
+  inline void execute(uint16_t addr) {
+    switch (currentOpCode->instruction) {
+#define CPU_INSTRUCTION_CASE(name) \
+  case Instruction::name:          \
+    name(addr);                    \
+    break;
+      CPU_INSTRUCTIONS(CPU_INSTRUCTION_CASE)
+#undef CPU_INSTRUCTION_CASE
+    }
+  }
 };
 
 #endif  // CPU_H
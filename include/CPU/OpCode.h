@@ -1,15 +1,13 @@
 #ifndef OPCODE_H
 #define OPCODE_H
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
-#include <functional>
-#include <string>
-#include <unordered_map>
-
-class CPU;  // forward declare CPU so we can use it in function pointers
+#include <utility>
 
 // enum class for addressing modes
-enum class AddressingMode {
+enum class AddressingMode : uint8_t {
   Implied,
   Relative,
   Acc,
@@ -25,33 +23,96 @@ enum class AddressingMode {
   IndirectY
 };
 
-using InstructionHandler = void (CPU::*)(uint16_t);
+/**
+ * Every CPU instruction handler, by name. Expanded here for the Instruction
+ * enum and in CPU::execute() for the dispatch switch, so the two cannot get
+ * out of step.
+ */
+#define CPU_INSTRUCTIONS(X)                                                   \
+  X(op_ADC) X(op_AND) X(op_ASL) X(op_ASL_ACC) X(op_BCC) X(op_BCS)             \
+  X(op_BEQ) X(op_BIT) X(op_BMI) X(op_BNE) X(op_BPL) X(op_BRK)                 \
+  X(op_BVC) X(op_BVS) X(op_CLC) X(op_CLD) X(op_CLI) X(op_CLV)                 \
+  X(op_CMP) X(op_CPX) X(op_CPY) X(op_DEC) X(op_DEX) X(op_DEY)                 \
+  X(op_EOR) X(op_INC) X(op_INX) X(op_INY) X(op_JMP) X(op_JSR)                 \
+  X(op_LDA) X(op_LDX) X(op_LDY) X(op_LSR) X(op_LSR_ACC) X(op_NOP)             \
+  X(op_ORA) X(op_PHA) X(op_PHP) X(op_PLA) X(op_PLP) X(op_ROL)                 \
+  X(op_ROL_ACC) X(op_ROR) X(op_ROR_ACC) X(op_RTI) X(op_RTS) X(op_SBC)         \
+  X(op_SEC) X(op_SED) X(op_SEI) X(op_STA) X(op_STX) X(op_STY)                 \
+  X(op_TAX) X(op_TAY) X(op_TSX) X(op_TXA) X(op_TXS) X(op_TYA)                 \
+  X(opi_ALR) X(opi_ANC) X(opi_ANE) X(opi_ARR) X(opi_DCP) X(opi_ISC)           \
+  X(opi_LAS) X(opi_LAX) X(opi_LXA) X(opi_RLA) X(opi_RRA) X(opi_SAX)           \
+  X(opi_SBX) X(opi_SHA) X(opi_SHX) X(opi_SHY) X(opi_SLO) X(opi_SRE)           \
+  X(opi_TAS) X(opi_SBC) X(opi_NOP) X(opi_KIL)
+
+/**
+ * Identifies the handler of an opcode. Opcode tables are shared by every
+ * CPU<BusType>, each of which maps this to its own member function.
+ */
+enum class Instruction : uint8_t {
+#define CPU_INSTRUCTION_ENUM(name) name,
+  CPU_INSTRUCTIONS(CPU_INSTRUCTION_ENUM)
+#undef CPU_INSTRUCTION_ENUM
+};
+
+#define CPU_INSTRUCTION_COUNT(name) +1
+constexpr std::size_t INSTRUCTION_COUNT =
+    0 CPU_INSTRUCTIONS(CPU_INSTRUCTION_COUNT);
+#undef CPU_INSTRUCTION_COUNT
+
+// Metadata only needed for disassembly and testing, kept out of the hot table
+struct OpCodeInfo {
+  const char* name;
+  bool isDocumented;
+};
 
 class OpCode {
  public:
+  Instruction instruction;
   uint8_t code;
-  bool isDocumented;
-  std::string name;
   uint8_t bytes;
   uint8_t cycles;
   AddressingMode mode;
   bool ignorePageCrossings;
-  InstructionHandler handler;
-
-  OpCode(uint8_t code, bool isDocumented, std::string name, uint8_t bytes,
-         uint8_t cycles, AddressingMode mode, bool ignorePageCrossings,
-         InstructionHandler handler)
-      : code(code),
-        isDocumented(isDocumented),
-        name(std::move(name)),
+
+  constexpr OpCode()
+      : instruction(Instruction::opi_KIL),
+        code(0),
+        bytes(0),
+        cycles(0),
+        mode(AddressingMode::Implied),
+        ignorePageCrossings(false) {}
+
+  constexpr OpCode(uint8_t code, uint8_t bytes, uint8_t cycles,
+                   AddressingMode mode, bool ignorePageCrossings,
+                   Instruction instruction)
+      : instruction(instruction),
+        code(code),
         bytes(bytes),
         cycles(cycles),
         mode(mode),
-        ignorePageCrossings(ignorePageCrossings),
-        handler(handler) {}
+        ignorePageCrossings(ignorePageCrossings) {}
+
+  const char* name() const { return OPCODE_INFO[code].name; }
+  bool isDocumented() const { return OPCODE_INFO[code].isDocumented; }
+
+  /**
+   * Look up an opcode in the lookup table. All 256 opcodes are defined.
+   *
+   * @param opcode 6502 opcode.
+   * @return An OpCode object.
+   */
+  static const OpCode* getOpCode(uint8_t opcode) {
+    return &OPCODE_TABLE[opcode];
+  }
+
+ private:
+  static const std::array<OpCode, 256> OPCODE_TABLE;
+  static const std::array<OpCodeInfo, 256> OPCODE_INFO;
 
-  static const OpCode* getOpCode(uint8_t opcode);
-  static const std::unordered_map<uint8_t, OpCode> OPCODE_LOOKUP;
+  static constexpr std::array<std::pair<OpCode, OpCodeInfo>, 256>
+  definitions();
+  static constexpr std::array<OpCode, 256> buildTable();
+  static constexpr std::array<OpCodeInfo, 256> buildInfoTable();
 };
 
-#endif  // OPCODE_H
\ No newline at end of file
+#endif  // OPCODE_H
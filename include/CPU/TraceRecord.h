@@ -0,0 +1,35 @@
+#ifndef TRACE_RECORD_H
+#define TRACE_RECORD_H
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * One traced instruction: the CPU state when it started, plus the operand
+ * bytes and resolved address once it finished. Fixed size and trivially
+ * copyable, so records are copied straight into a TraceRecorder and read back
+ * from trace files. The opcode gives the addressing mode for disassembly.
+ */
+struct TraceRecord {
+  uint64_t cycles;          // CPU cycle the instruction started on
+  uint16_t pc;
+  uint16_t address;         // resolved operand address
+  uint16_t pointerAddress;  // indirect pointer, for (zp,X) and (zp),Y
+  uint16_t ppuX;            // PPU dot when the instruction started
+  uint16_t ppuY;            // PPU scanline when the instruction started
+  std::array<uint8_t, 3> opBytes;  // opcode followed by operands
+  uint8_t opByteCount;
+  uint8_t valueAtAddr;      // operand value before the instruction ran
+  uint8_t A;
+  uint8_t X;
+  uint8_t Y;
+  uint8_t P;
+  uint8_t SP;
+  std::array<uint8_t, 4> reserved;  // explicit padding, always zero
+};
+
+static_assert(std::is_trivially_copyable_v<TraceRecord>);
+static_assert(sizeof(TraceRecord) == 32, "trace files store 32 byte records");
+
+#endif  // TRACE_RECORD_H
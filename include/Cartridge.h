@@ -1,5 +1,6 @@
 /**
- * Provides support for iNES 1.0 format ROMs.
+ * Provides support for iNES 1.0 and NES 2.0 format ROMs. Bytes 0-7 are shared,
+ * see RomHeader.h for the NES 2.0 extensions.
  *
  * iNES Header Format (16 bytes) - https://www.nesdev.org/wiki/INES
  * Bytes   | Description
@@ -39,41 +40,124 @@
 #ifndef CARTRIDGE_H
 #define CARTRIDGE_H
 
+#include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <span>
 #include <vector>
 
-// enum class for addressing modes
-enum class MirroringMode { Vertical, Horizontal, FourScreen };
-enum class NESRegion { NTSC, PAL, None };
+#include "ChrTileCache.h"
+#include "Mapper/Mapper.h"
+#include "RomHeader.h"
+#include "RomImage.h"
+
+class StateWriter;
+class StateReader;
+class RomDatabase;
+
+/**
+ * Derived from a ROM image once and shared by every cartridge that loads
+ * it, so loading the same image again costs no hashing or decoding.
+ */
+struct SharedRomData {
+    uint32_t crc32 = 0;    // PRG ROM followed by CHR ROM, see getCRC32()
+    ChrTileCache chrTiles; // decoded CHR ROM, empty on CHR RAM boards
+};
 
 class Cartridge {
   private:
     bool empty;
-    std::vector<uint8_t> prg_rom;
-    std::vector<uint8_t> chr_rom;
+    // PRG and CHR ROM are views into the image, only RAM is per cartridge
+    std::shared_ptr<const RomImage> image;
+    std::span<const uint8_t> prg_rom;
+    std::span<const uint8_t> chr_rom; // CHR ROM in image, or chr_ram
+    std::vector<uint8_t> chr_ram;
+    // Decoded copy of chr_rom. CHR ROM tiles are decoded once and shared by
+    // every cartridge on the same image; CHR RAM tiles are kept in sync with
+    // writes in chr_ram_tiles.
+    std::shared_ptr<const SharedRomData> shared;
+    ChrTileCache chr_ram_tiles;
+    const ChrTileCache *chr_tiles;
     bool chr_is_ram;
-    MirroringMode mirroring;
-    NESRegion region;
-    uint8_t mapper;
-    size_t prg_rom_size;
-    size_t chr_rom_size;
+    std::vector<uint8_t> prg_ram; // $6000-$7FFF, empty if the board has none
+    MirroringMode mirroring;      // used while no mapper is loaded
+    RomHeader header;             // after corrections from the ROM database
+    std::unique_ptr<Mapper> mapper; // null until a ROM is loaded
+    bool ppuA12;                    // last PPU A12 level, see ppuAddressA12()
 
   public:
     Cartridge()
-        : empty(true), prg_rom{}, chr_rom{}, chr_is_ram(false),
-          mirroring(MirroringMode::Horizontal), region(NESRegion::None),
-          mapper(), prg_rom_size(0), chr_rom_size(0) {}
+        : empty(true), image(), prg_rom{}, chr_rom{}, chr_ram{},
+          shared(), chr_ram_tiles(), chr_tiles(&chr_ram_tiles),
+          chr_is_ram(false), prg_ram{}, mirroring(MirroringMode::Horizontal), header(),
+          mapper(), ppuA12(false) {}
+
+    Cartridge(const Cartridge &) = delete;
+    Cartridge &operator=(const Cartridge &) = delete;
+    Cartridge(Cartridge &&) = delete;
+    Cartridge &operator=(Cartridge &&) = delete;
 
     Cartridge(const std::vector<uint8_t> &raw) : Cartridge() { load(raw); }
 
+    /**
+     * Loads an iNES 1.0 or NES 2.0 ROM dump. Header fields of dumps found in
+     * database (by default RomDatabase::standard()) are replaced by the
+     * database's. Throws std::invalid_argument for malformed files and
+     * std::runtime_error if the mapper is not implemented.
+     *
+     * The cartridge keeps a reference to image and reads ROM from it in
+     * place. The vector overloads copy raw into a new image first.
+     */
+    void load(std::shared_ptr<const RomImage> image);
+    void load(std::shared_ptr<const RomImage> image,
+              const RomDatabase &database);
     void load(const std::vector<uint8_t> &raw);
+    void load(const std::vector<uint8_t> &raw, const RomDatabase &database);
     uint8_t read_prg_rom(uint16_t addr);
+    const uint8_t *prg_page(uint16_t addr) const;
+    uint8_t *prg_ram_page(uint16_t addr);
+    void write_prg(uint16_t addr, uint8_t value);
     uint8_t read_chr_rom(uint16_t addr);
+    const TileRow &read_chr_tile_row(uint16_t addr, bool flipHorizontal);
     void write_chr_ram(uint16_t addr, uint8_t value);
 
-    MirroringMode getMirroring() { return mirroring; }
-    void setMirroring(MirroringMode m) { this->mirroring = m; }
-    NESRegion getRegion() { return region; }
+    MirroringMode getMirroring() const {
+        return mapper ? mapper->getMirroring() : mirroring;
+    }
+    void setMirroring(MirroringMode m) {
+        mirroring = m;
+        if (mapper) {
+            mapper->setMirroring(m);
+        }
+    }
+    NESRegion getRegion() const { return header.region; }
+    uint16_t getMapperID() const { return header.mapper; }
+    uint8_t getSubmapper() const { return header.submapper; }
+    const RomHeader &getHeader() const { return header; }
+    /**
+     * CRC32 of PRG ROM followed by CHR ROM, 0 with no cartridge loaded. Keys
+     * the ROM database and identifies the ROM in save states.
+     */
+    uint32_t getCRC32() const { return shared ? shared->crc32 : 0; }
+
+    /**
+     * Level of PPU address line A12 on a pattern table access. Rising edges
+     * clock mappers that count scanlines (MMC3).
+     */
+    void ppuAddressA12(bool high) {
+        if (high && !ppuA12 && mapper) {
+            mapper->ppuA12Rise();
+        }
+        ppuA12 = high;
+    }
+
+    // level of the cartridge IRQ line, which the CPU sees as IRQ
+    bool irqAsserted() const { return mapper && mapper->irqAsserted(); }
+
+    // mapper registers, PRG-RAM and CHR-RAM; ROM data is not part of a save
+    // state. Throw std::runtime_error if no cartridge is loaded.
+    void saveState(StateWriter &out) const;
+    void loadState(StateReader &in);
 };
 
 #endif
@@ -0,0 +1,79 @@
+#ifndef CHRTILECACHE_H
+#define CHRTILECACHE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * Pixel indices (0-3) of one 8 pixel tile row, leftmost pixel first.
+ */
+using TileRow = std::array<uint8_t, 8>;
+
+/**
+ * Pre-decoded copy of CHR memory. Each 16 byte tile is stored as 8 rows of
+ * 2-bit pixel indices, once as is and once flipped horizontally, so pattern
+ * lookups become a single table read instead of two plane reads and a
+ * per-pixel bit decode.
+ *
+ * The owner must call update() after every write to CHR memory.
+ */
+class ChrTileCache {
+  private:
+    std::vector<TileRow> rows;        // [tile * 8 + fineY]
+    std::vector<TileRow> flippedRows; // same rows, mirrored left to right
+
+    static std::size_t rowIndex(std::size_t chrOffset) {
+        return ((chrOffset >> 4) << 3) | (chrOffset & 0x07);
+    }
+
+    void decodeRow(std::span<const uint8_t> chr, std::size_t chrOffset) {
+        const std::size_t lowOffset = chrOffset & ~static_cast<std::size_t>(8);
+        const uint8_t low = chr[lowOffset];
+        const uint8_t high = chr[lowOffset + 8];
+
+        TileRow &row = rows[rowIndex(chrOffset)];
+        TileRow &flipped = flippedRows[rowIndex(chrOffset)];
+        for (int px = 0; px < 8; px++) {
+            const int bit = 7 - px;
+            row[px] = static_cast<uint8_t>((((high >> bit) & 0x01) << 1) |
+                                           ((low >> bit) & 0x01));
+            flipped[7 - px] = row[px];
+        }
+    }
+
+  public:
+    /**
+     * Decodes every tile in chr. chr.size() must be a multiple of 16.
+     */
+    void rebuild(std::span<const uint8_t> chr) {
+        rows.assign(chr.size() / 2, TileRow{});
+        flippedRows.assign(chr.size() / 2, TileRow{});
+        for (std::size_t offset = 0; offset < chr.size(); offset += 16) {
+            for (std::size_t fineY = 0; fineY < 8; fineY++) {
+                decodeRow(chr, offset + fineY);
+            }
+        }
+    }
+
+    /**
+     * Re-decodes the tile row containing chrOffset (either bit plane).
+     */
+    void update(std::span<const uint8_t> chr, std::size_t chrOffset) {
+        decodeRow(chr, chrOffset);
+    }
+
+    bool empty() const { return rows.empty(); }
+
+    /**
+     * @param chrOffset offset of the row's low plane byte in CHR memory.
+     */
+    const TileRow &row(std::size_t chrOffset, bool flipHorizontal) const {
+        const std::size_t index = rowIndex(chrOffset);
+        return flipHorizontal ? flippedRows[index] : rows[index];
+    }
+};
+
+#endif // CHRTILECACHE_H
@@ -1,10 +1,20 @@
 #ifndef CLOCK_H
 #define CLOCK_H
 
+#include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
 
+#include "Renderer/FrameMailbox.h"
+#include "RewindBuffer.h"
+
+class Frontend;
 class NES;
-class Frame;
+class StateWriter;
+class StateReader;
 enum class NESRegion;
 
 const double TARGET_SPEED = 1; // game speed to target (1 = full speed 60fps)
@@ -16,16 +26,109 @@ const double MASTER_SPEED_NTSC =
 const double MASTER_SPEED_PAL =
     TARGET_SPEED * 1000000 * 26.6017125; // ~26.601 MHz
 
+/**
+ * How the CPU is interleaved with the PPU, see docs/Syncronisation.md.
+ */
+enum class SyncMode {
+    CycleStepped,       // CPU runs one cycle, then the PPU runs three dots
+    InstructionStepped, // CPU runs a whole instruction, then the PPU catches up
+};
+
+/**
+ * How a windowed run keeps to real time, see Clock::setPacing().
+ */
+enum class PacingMode {
+    Timer, // sleep until each frame is due at the console's frame rate
+    Audio, // as Timer, with the audio rate steered by the buffer fill level
+    VSync, // one frame per display refresh, audio steered as in Audio
+};
+
+/**
+ * Frame pacing and audio buffer health of a windowed run, see
+ * Clock::getPacingStats().
+ */
+struct PacingStats {
+    uint64_t frames = 0;            // frame intervals measured
+    double totalJitterMicros = 0.0; // sum of |interval - expected interval|
+    double maxJitterMicros = 0.0;
+    uint64_t audioUnderruns = 0; // device reads the audio ring fell short on
+    uint64_t audioOverruns = 0;  // frames the audio ring dropped samples of
+    double rateRatio = 1.0;    // last audio rate ratio, see APU::setRateRatio
+    double minRateRatio = 1.0; // range the ratio moved in, starting at 1
+    double maxRateRatio = 1.0;
+
+    double averageJitterMicros() const {
+        return frames > 0 ? totalJitterMicros / static_cast<double>(frames)
+                          : 0.0;
+    }
+};
+
+/**
+ * Summary of a headless run, see Clock::runHeadless().
+ */
+struct HeadlessResult {
+    uint64_t frames = 0;         // frames completed
+    uint64_t cpuCycles = 0;      // CPU cycles executed during the run
+    uint64_t frameHash = 0;      // FNV-1a hash of the last completed frame
+    double elapsedSeconds = 0.0; // host wall-clock time
+
+    double framesPerSecond() const {
+        return elapsedSeconds > 0.0 ? static_cast<double>(frames) / elapsedSeconds
+                                    : 0.0;
+    }
+};
+
+/**
+ * Host cost of run-ahead, see Clock::setRunAhead().
+ */
+struct RunAheadStats {
+    uint64_t hostFrames = 0;     // frames presented from the future
+    uint64_t framesRun = 0;      // extra frames emulated for them
+    double emulateMicros = 0.0;  // time spent emulating extra frames
+    double saveLoadMicros = 0.0; // time spent saving and restoring state
+
+    double microsPerFrame() const {
+        return framesRun > 0 ? emulateMicros / static_cast<double>(framesRun)
+                             : 0.0;
+    }
+    double saveLoadMicrosPerHostFrame() const {
+        return hostFrames > 0
+                   ? saveLoadMicros / static_cast<double>(hostFrames)
+                   : 0.0;
+    }
+};
+
 class Clock {
   private:
     NES &nes;
     NESRegion region;
+    SyncMode syncMode;
 
-    bool running;
+    std::atomic<bool> running;
     bool lastNMIState;
     bool pendingNMIEdge;
 
+    RewindBuffer rewind;
+    std::vector<uint8_t> rewindSnapshot; // reused between frames
+    std::atomic<bool> rewinding;         // rewind key held
+
+    // written by the presenting thread, read by the emulation thread
+    std::atomic<uint8_t> joypad1Input;
+    FrameMailbox presented; // emulation thread to presenting thread
+
+    uint32_t runAheadFrames;
+    std::vector<uint8_t> runAheadSnapshot; // reused between frames
+    RunAheadStats runAheadStats;
+
     std::chrono::steady_clock::duration frameDuration;
+    PacingMode pacingMode;
+    PacingStats pacingStats;
+    std::chrono::steady_clock::time_point nextFrameTime; // Timer and Audio
+    std::chrono::steady_clock::time_point lastFrameTime; // for jitter
+    double refreshMicros; // average VSync interval
+    std::atomic<uint64_t> presents; // frames shown by the presenting thread
+
+    std::function<void(const Frame &)> frameCallback;
 
   public:
     Clock(const Clock &) = delete;
@@ -40,12 +143,137 @@ class Clock {
 
     void setRegion(NESRegion region);
 
-    void start();
+    /**
+     * InstructionStepped is considerably faster, but is only suitable for
+     * ROMs that do not rely on sub-instruction CPU/PPU timing.
+     */
+    void setSyncMode(SyncMode mode) { syncMode = mode; }
+
+    /**
+     * Records a snapshot after every frame into a history of at most
+     * megabytes MB. Holding Backspace plays it back in reverse. 0 disables
+     * rewinding and frees the history.
+     */
+    void setRewindBudget(std::size_t megabytes) {
+        rewind.setBudget(megabytes * 1024 * 1024);
+    }
+    const RewindStats &getRewindStats() const { return rewind.stats(); }
+
+    /**
+     * Restores the machine to the previous recorded frame. Returns false if
+     * there is no older frame in the history.
+     */
+    bool rewindFrame();
+
+    /**
+     * After each frame, emulates frames more frames with the current input,
+     * presents the last of them and restores the machine. This hides frames
+     * frames of the game's own input lag at the cost of emulating frames + 1
+     * frames per displayed frame. Only the presented frame is drawn by the
+     * PPU. 0 disables run-ahead.
+     */
+    void setRunAhead(uint32_t frames) {
+        runAheadFrames = frames;
+        runAheadStats = RunAheadStats{};
+    }
+    const RunAheadStats &getRunAheadStats() const { return runAheadStats; }
+
+    /**
+     * Timer paces emulation by the host clock alone, so over time the audio
+     * device, whose clock differs slightly, drains its buffer or overflows
+     * it. Audio keeps timer pacing and corrects the audio instead, moving
+     * the sample rate by up to MAX_RATE_ADJUSTMENT to hold the buffer at
+     * AUDIO_LATENCY. VSync emulates one frame per display refresh and
+     * steers the audio the same way; it only suits displays refreshing
+     * within MAX_RATE_ADJUSTMENT of the console's frame rate.
+     */
+    void setPacing(PacingMode mode) { pacingMode = mode; }
+    PacingMode getPacing() const { return pacingMode; }
+
+    // frames per second of the console in the current region
+    double getFrameRate() const;
+
+    PacingStats getPacingStats() const;
+
+    static constexpr double MAX_RATE_ADJUSTMENT = 0.005;
+    static constexpr double AUDIO_LATENCY = 0.05; // seconds buffered
+
+    /**
+     * Runs the console until the frontend reports a quit. Emulation and
+     * frame pacing run on a second thread; the calling thread polls the
+     * frontend for input and presents the latest completed frame, so a slow
+     * or VSync-blocked present never delays emulation. Must be called from
+     * the thread that owns the frontend's window.
+     */
+    void start(Frontend &frontend);
+
+    /**
+     * Runs the console for frameCount frames as fast as the host allows.
+     * Nothing is rendered, no input is polled and frame pacing is disabled,
+     * so this can be used without a window.
+     */
+    HeadlessResult runHeadless(uint64_t frameCount);
+
+    /**
+     * Called with each frame the PPU completes while the console runs, from
+     * the thread running it. The frame is only valid during the call. Not
+     * called for the hidden frames of run-ahead. An empty callback removes
+     * it.
+     */
+    void setFrameCallback(std::function<void(const Frame &)> callback) {
+        frameCallback = std::move(callback);
+    }
+
+    /**
+     * Library entry points for driving the console directly, without a
+     * window, pacing, rewind or run-ahead. Each steps the CPU and PPU as in
+     * start(), with the same NMI and IRQ handling, passes completed
+     * frames to the frame callback and returns the number completed.
+     *
+     * runFrame() runs until the PPU completes a frame and returns it.
+     * runCycles() runs at least cycles CPU cycles; a step is never split,
+     * so an instruction-stepped run may overshoot by a few cycles.
+     * runUntil() runs until done() returns true, checked before each step.
+     * Video output is turned back on if a run-ahead start() left it off.
+     */
+    const Frame &runFrame();
+    uint64_t runCycles(uint64_t cycles);
+    template <typename Predicate> uint64_t runUntil(Predicate &&done) {
+        enterRunLoop();
+        uint64_t frames = 0;
+        while (!done()) {
+            if (const Frame *frame = step()) {
+                frames++;
+                deliverFrame(*frame);
+            }
+        }
+        return frames;
+    }
+
+    // NMI edge detection state between the PPU and CPU
+    void saveState(StateWriter &out) const;
+    void loadState(StateReader &in);
 
   private:
+    void requireRegion() const;
+    void enterRunLoop();
+    void reset();
+    const Frame *step();
+    const Frame *catchUpPPU(uint32_t cpuCycles);
+    void deliverFrame(const Frame &frame) {
+        if (frameCallback) {
+            frameCallback(frame);
+        }
+    }
+    const Frame &emulateFrame();
+    const Frame &runAhead();
+    void recordOrRewind();
     void gameLoop();
-    void processEvents();
-    void render(const Frame &frame);
+    void pace(uint64_t shown);
+    void steerAudio();
+    void stop();
+    void presentLoop(Frontend &frontend);
+    void applyInput();
 };
 
 #endif // CLOCK_H
@@ -0,0 +1,36 @@
+#ifndef FRONTEND_H
+#define FRONTEND_H
+
+#include <cstdint>
+
+#include "Renderer/Frame.h"
+
+/**
+ * Host input sampled by a Frontend, see Frontend::poll().
+ */
+struct FrontendInput {
+    uint8_t joypad1 = 0; // Bus::JOYPAD_* bits
+    bool rewind = false; // rewind key held
+    bool quit = false;   // window closed or quit key pressed
+};
+
+/**
+ * The host side of a windowed run: shows frames and reads input. The core
+ * only sees this interface, so it builds without a windowing library; the
+ * SDL implementation is SDLFrontend, in the nesemu executable.
+ *
+ * Clock::start() calls both methods from the thread it was called on, never
+ * from the emulation thread.
+ */
+class Frontend {
+  public:
+    virtual ~Frontend() = default;
+
+    // drains pending window events and samples the current input
+    virtual FrontendInput poll() = 0;
+
+    // shows frame, may block until the display's next refresh
+    virtual void present(const Frame &frame) = 0;
+};
+
+#endif // FRONTEND_H
@@ -0,0 +1,50 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * 64-bit FNV-1a hash. Used to fingerprint frames and memory in headless runs
+ * so results can be compared across builds without storing full dumps.
+ * http://www.isthe.com/chongo/tech/comp/fnv/index.html
+ */
+inline uint64_t fnv1a64(const uint8_t *data, std::size_t length,
+                        uint64_t hash = 0xCBF29CE484222325ULL) {
+    for (std::size_t i = 0; i < length; i++) {
+        hash ^= data[i];
+        hash *= 0x00000100000001B3ULL;
+    }
+    return hash;
+}
+
+namespace detail {
+constexpr std::array<uint32_t, 256> makeCRC32Table() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+inline constexpr std::array<uint32_t, 256> CRC32_TABLE = makeCRC32Table();
+} // namespace detail
+
+/**
+ * CRC-32 (IEEE 802.3, as used by zip and NES ROM databases). Pass a previous
+ * result as crc to continue it over another buffer.
+ */
+inline uint32_t crc32(const uint8_t *data, std::size_t length,
+                      uint32_t crc = 0) {
+    crc = ~crc;
+    for (std::size_t i = 0; i < length; i++) {
+        crc = detail::CRC32_TABLE[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+#endif // HASH_H
@@ -1,38 +1,60 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 
-#include <string>
+#include <cstddef>
 
-#include "CPU/CPUState.h"
+#include "CPU/TraceRecord.h"
+#include "TraceRecorder.h"
 
 class Logger {
   private:
     bool silenced = false;
-    std::string disassembleInstr(const CPUState &state);
+    TraceRecorder *recorder = nullptr;
+
+    void print(const TraceRecord &record);
 
   public:
-    /**
-     * Log a single CPU instruction/state line. Written with a LLM.
-     *
-     * Parameters:
-     *   pc          - Program Counter (16-bit)
-     *   op          - OpCode* containing information about the operation
-     *   opBytes     - Up to 3 opcode bytes for this instruction
-     *   addrInfo    - Struct containing info required to build disassembly
-     *   valueAtAddr - Required for disassembly
-     *   A, X, Y     - CPU registers
-     *   P           - Processor status (flags)
-     *   SP          - Stack pointer
-     *   ppuX, ppuY  - Current PPU X/Y scanline position
-     *   cycles      - Cycle count
-     *
-     */
+    // longest line format() writes, the cycle count is at most 20 digits
+    static constexpr std::size_t MAX_LINE_LENGTH = 110;
 
     void mute() { silenced = true; };
     void unmute() { silenced = false; };
     bool isMuted() const { return silenced; }
 
-    void log(const CPUState &state);
+    /**
+     * Appends traced instructions to recorder instead of printing them, or
+     * prints them again if recorder is nullptr. recorder must outlive any
+     * logging to it.
+     */
+    void recordTo(TraceRecorder *recorder) { this->recorder = recorder; }
+
+    /**
+     * Log a single CPU instruction: appended to the recorder if there is one,
+     * otherwise printed to std::cout as a nestest style line.
+     */
+    void log(const TraceRecord &record) {
+        if (silenced)
+            return;
+        if (recorder) {
+            recorder->append(record);
+            return;
+        }
+        print(record);
+    }
+
+    /**
+     * Writes record as a line in the nestest log format, without a line
+     * ending, to line (at least MAX_LINE_LENGTH chars). Returns its length.
+     *
+     * Columns:
+     *   0   PC
+     *   6   up to 3 opcode bytes
+     *   15  disassembly, with the operand address and value
+     *   48  registers, "A:XX X:XX Y:XX P:XX SP:XX"
+     *   74  PPU dot and scanline, "PPU:XXX,YYY"
+     *   86  cycle count, "CYC:N"
+     */
+    static std::size_t format(const TraceRecord &record, char *line);
 };
 
 #endif
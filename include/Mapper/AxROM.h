@@ -0,0 +1,26 @@
+#ifndef AXROM_H
+#define AXROM_H
+
+#include "Mapper.h"
+
+/**
+ * Mapper 7. Any write to $8000-$FFFF selects the 32 KiB PRG bank (bits 0-2)
+ * and which 1 KiB of CIRAM all nametables use (bit 4). CHR is unbanked RAM.
+ * https://www.nesdev.org/wiki/AxROM
+ */
+class AxROM final : public Mapper {
+  public:
+    AxROM(std::size_t prgSize, std::size_t chrSize)
+        : Mapper(prgSize, chrSize, MirroringMode::SingleScreenLower) {
+        setPrg32k(0);
+        setChr8k(0);
+    }
+
+    void writeRegister(uint16_t /* addr */, uint8_t value) override {
+        setPrg32k(value & 0x07);
+        mirroring = (value & 0x10) ? MirroringMode::SingleScreenUpper
+                                   : MirroringMode::SingleScreenLower;
+    }
+};
+
+#endif // AXROM_H
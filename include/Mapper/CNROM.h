@@ -0,0 +1,23 @@
+#ifndef CNROM_H
+#define CNROM_H
+
+#include "Mapper.h"
+
+/**
+ * Mapper 3. PRG as NROM; any write to $8000-$FFFF selects the 8 KiB CHR bank.
+ * https://www.nesdev.org/wiki/INES_Mapper_003
+ */
+class CNROM final : public Mapper {
+  public:
+    CNROM(std::size_t prgSize, std::size_t chrSize, MirroringMode mirroring)
+        : Mapper(prgSize, chrSize, mirroring) {
+        setPrg32k(0);
+        setChr8k(0);
+    }
+
+    void writeRegister(uint16_t /* addr */, uint8_t value) override {
+        setChr8k(value & 0x03);
+    }
+};
+
+#endif // CNROM_H
@@ -0,0 +1,44 @@
+#ifndef MMC1_H
+#define MMC1_H
+
+#include "Mapper.h"
+
+/**
+ * Mapper 1 (SxROM). Registers are loaded one bit per write through a 5 bit
+ * serial shift register; the fifth write commits the value to the register
+ * selected by address bits 13-14.
+ * https://www.nesdev.org/wiki/MMC1
+ *
+ * CONTROL ($8000-$9FFF)
+ *  43210
+ *  |||||
+ *  |||++- Mirroring (0: one-screen lower; 1: one-screen upper;
+ *  |||               2: vertical; 3: horizontal)
+ *  |++--- PRG ROM bank mode (0, 1: switch 32 KiB at $8000;
+ *  |                         2: fix first bank at $8000, switch $C000;
+ *  |                         3: fix last bank at $C000, switch $8000)
+ *  +----- CHR ROM bank mode (0: switch 8 KiB; 1: switch two 4 KiB banks)
+ */
+class MMC1 final : public Mapper {
+  private:
+    uint8_t shift = 0;      // bits loaded so far, first write in bit 0
+    uint8_t shiftCount = 0; // writes since the last commit or reset
+    uint8_t control = 0x0C; // power on in PRG mode 3
+    uint8_t chrBank0 = 0;
+    uint8_t chrBank1 = 0;
+    uint8_t prgBank = 0;
+
+    void updateBanks();
+
+  protected:
+    void saveRegisters(StateWriter &out) const override;
+    void loadRegisters(StateReader &in) override;
+
+  public:
+    MMC1(std::size_t prgSize, std::size_t chrSize, MirroringMode mirroring);
+
+    void writeRegister(uint16_t addr, uint8_t value) override;
+    bool hasPRGRAM() const override { return true; }
+};
+
+#endif // MMC1_H
@@ -0,0 +1,48 @@
+#ifndef MMC3_H
+#define MMC3_H
+
+#include <array>
+
+#include "Mapper.h"
+
+/**
+ * Mapper 4 (TxROM). Eight bank registers selected through $8000 and written
+ * through $8001, plus a scanline counter clocked by rising edges of PPU A12
+ * that raises an IRQ when it reaches zero.
+ * https://www.nesdev.org/wiki/MMC3
+ *
+ * BANK SELECT ($8000-$9FFE, even)
+ *  76543210
+ *  ||   |||
+ *  ||   +++- Bank register to update on the next write to $8001 (R0-R7)
+ *  |+------- PRG ROM bank mode (0: R6 at $8000, second-last bank at $C000;
+ *  |                            1: second-last bank at $8000, R6 at $C000)
+ *  +-------- CHR A12 inversion (0: 2 KiB banks at $0000, 1 KiB at $1000;
+ *                               1: 2 KiB banks at $1000, 1 KiB at $0000)
+ */
+class MMC3 final : public Mapper {
+  private:
+    std::array<uint8_t, 8> registers{}; // R0-R7
+    uint8_t bankSelect = 0;
+    bool fourScreen;
+
+    uint8_t irqLatch = 0;
+    uint8_t irqCounter = 0;
+    bool irqReload = false;
+    bool irqEnabled = false;
+
+    void updateBanks();
+
+  protected:
+    void saveRegisters(StateWriter &out) const override;
+    void loadRegisters(StateReader &in) override;
+
+  public:
+    MMC3(std::size_t prgSize, std::size_t chrSize, MirroringMode mirroring);
+
+    void writeRegister(uint16_t addr, uint8_t value) override;
+    bool hasPRGRAM() const override { return true; }
+    void ppuA12Rise() override;
+};
+
+#endif // MMC3_H
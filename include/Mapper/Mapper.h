@@ -0,0 +1,108 @@
+#ifndef MAPPER_H
+#define MAPPER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+class StateWriter;
+class StateReader;
+
+enum class MirroringMode {
+    Vertical,
+    Horizontal,
+    FourScreen,
+    SingleScreenLower, // every nametable maps to the first 1 KiB of CIRAM
+    SingleScreenUpper, // every nametable maps to the second 1 KiB of CIRAM
+};
+
+/**
+ * Cartridge board logic: bank switching, nametable mirroring and IRQs.
+ * https://www.nesdev.org/wiki/Mapper
+ *
+ * A mapper never reads memory itself. Register writes update tables of bank
+ * offsets into PRG and CHR memory, which the Cartridge and Bus resolve
+ * addresses through directly, so a bank switch costs a few stores and reads
+ * cost no virtual call.
+ */
+class Mapper {
+  public:
+    static constexpr std::size_t PRG_WINDOW = 0x2000; // 8 KiB, $8000-$FFFF
+    static constexpr std::size_t CHR_WINDOW = 0x0400; // 1 KiB, $0000-$1FFF
+    static constexpr std::size_t PRG_WINDOWS = 4;
+    static constexpr std::size_t CHR_WINDOWS = 8;
+
+    /**
+     * Builds the mapper for an iNES mapper number with its power-on banks.
+     * Throws std::runtime_error for mappers that are not implemented.
+     */
+    static std::unique_ptr<Mapper> create(uint16_t id, std::size_t prgSize,
+                                          std::size_t chrSize,
+                                          MirroringMode mirroring);
+
+    virtual ~Mapper() = default;
+
+    /**
+     * CPU write to $8000-$FFFF.
+     */
+    virtual void writeRegister(uint16_t addr, uint8_t value) = 0;
+
+    /**
+     * PPU address line A12 went from low to high.
+     */
+    virtual void ppuA12Rise() {}
+
+    // whether the board has 8 KiB of PRG RAM at $6000 without a battery
+    virtual bool hasPRGRAM() const { return false; }
+
+    // offset into PRG ROM of the 8 KiB window containing addr ($8000-$FFFF)
+    std::size_t prgOffset(uint16_t addr) const {
+        return prgBanks[(addr >> 13) & 0x03] + (addr & (PRG_WINDOW - 1));
+    }
+
+    // offset into CHR memory of the 1 KiB window containing addr
+    std::size_t chrOffset(uint16_t addr) const {
+        return chrBanks[(addr >> 10) & 0x07] + (addr & (CHR_WINDOW - 1));
+    }
+
+    MirroringMode getMirroring() const { return mirroring; }
+    void setMirroring(MirroringMode mode) { mirroring = mode; }
+    bool irqAsserted() const { return irq; }
+
+    // bank tables, mirroring, IRQ line and registers of the concrete mapper
+    void saveState(StateWriter &out) const;
+    void loadState(StateReader &in);
+
+  protected:
+    Mapper(std::size_t prgSize, std::size_t chrSize, MirroringMode mirroring);
+
+    std::array<std::size_t, PRG_WINDOWS> prgBanks{};
+    std::array<std::size_t, CHR_WINDOWS> chrBanks{};
+    MirroringMode mirroring;
+    bool irq = false;
+
+    // Bank numbers wrap to the memory present, negative numbers count back
+    // from the last bank. window is in units of the bank size.
+    void setPrg8k(std::size_t window, int bank);
+    void setPrg16k(std::size_t window, int bank);
+    void setPrg32k(int bank);
+    void setChr1k(std::size_t window, int bank);
+    void setChr2k(std::size_t window, int bank);
+    void setChr4k(std::size_t window, int bank);
+    void setChr8k(int bank);
+
+    virtual void saveRegisters(StateWriter & /* out */) const {}
+    virtual void loadRegisters(StateReader & /* in */) {}
+
+  private:
+    std::size_t prgSize;
+    std::size_t chrSize;
+
+    static std::size_t bankOffset(int bank, std::size_t bankSize,
+                                  std::size_t memorySize);
+    static std::size_t readBank(StateReader &in, std::size_t bankSize,
+                                std::size_t memorySize);
+};
+
+#endif // MAPPER_H
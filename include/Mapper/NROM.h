@@ -0,0 +1,22 @@
+#ifndef NROM_H
+#define NROM_H
+
+#include "Mapper.h"
+
+/**
+ * Mapper 0. 16 or 32 KiB PRG and 8 KiB CHR, no registers; 16 KiB PRG is
+ * mirrored into $C000-$FFFF.
+ * https://www.nesdev.org/wiki/NROM
+ */
+class NROM final : public Mapper {
+  public:
+    NROM(std::size_t prgSize, std::size_t chrSize, MirroringMode mirroring)
+        : Mapper(prgSize, chrSize, mirroring) {
+        setPrg32k(0);
+        setChr8k(0);
+    }
+
+    void writeRegister(uint16_t /* addr */, uint8_t /* value */) override {}
+};
+
+#endif // NROM_H
@@ -0,0 +1,25 @@
+#ifndef UXROM_H
+#define UXROM_H
+
+#include "Mapper.h"
+
+/**
+ * Mapper 2. Any write to $8000-$FFFF selects the 16 KiB PRG bank at $8000;
+ * $C000-$FFFF is fixed to the last bank. CHR is unbanked, usually RAM.
+ * https://www.nesdev.org/wiki/UxROM
+ */
+class UxROM final : public Mapper {
+  public:
+    UxROM(std::size_t prgSize, std::size_t chrSize, MirroringMode mirroring)
+        : Mapper(prgSize, chrSize, mirroring) {
+        setPrg16k(0, 0);
+        setPrg16k(1, -1);
+        setChr8k(0);
+    }
+
+    void writeRegister(uint16_t /* addr */, uint8_t value) override {
+        setPrg16k(0, value & 0x0F);
+    }
+};
+
+#endif // UXROM_H
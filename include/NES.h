@@ -1,16 +1,20 @@
 #ifndef NES_H
 #define NES_H
 
+#include <functional>
 #include <utility>
 #include <vector>
 
+#include "APU/APU.h"
 #include "Bus.h"
 #include "CPU/CPU.h"
 #include "Cartridge.h"
 #include "Clock.h"
 #include "Logger.h"
 #include "PPU/PPU.h"
-#include "Renderer/Renderer.h"
+#include "SaveState.h"
+
+class Frontend;
 
 /**
  * Virtual implementation of an NES console. Instantiates and correctly links
@@ -21,11 +25,10 @@ class NES {
     Logger log;
     Cartridge cart;
     PPU ppu;
+    APU apu;
     Bus bus;
-    CPU cpu;
-    Renderer renderer;
+    CPU<Bus> cpu;
     Clock clock;
-    // APU apu;
 
     NES(const NES &) = delete;
     NES &operator=(const NES &) = delete;
@@ -34,22 +37,36 @@ class NES {
 
     /**
      * Instantiates all components and loads romDump into cartridge.
-     * @param renderer Renderer ownership is transferred to NES.
      * @param romDump iNES 1.0 format NES ROM dump.
      */
-    NES(Renderer renderer, const std::vector<uint8_t> &romDump)
-        : log(), cart(), ppu(cart), bus(ppu, cart), cpu(bus, log),
-          renderer(std::move(renderer)), clock(*this) {
+    explicit NES(const std::vector<uint8_t> &romDump)
+        : log(), cart(), ppu(cart), apu(cart), bus(ppu, apu, cart),
+          cpu(bus, log), clock(*this), rollbackState() {
         insertCartridge(romDump);
     }
 
+    /**
+     * As above, but reads ROM from image in place (see RomImage::open).
+     */
+    explicit NES(std::shared_ptr<const RomImage> image)
+        : log(), cart(), ppu(cart), apu(cart), bus(ppu, apu, cart),
+          cpu(bus, log), clock(*this), rollbackState() {
+        insertCartridge(std::move(image));
+    }
+
     /**
      * Loads romDump into cartridge.
      * @param romDump iNES 1.0 format NES ROM dump.
      */
     void insertCartridge(const std::vector<uint8_t> &romDump) {
-        cart.load(romDump);
+        insertCartridge(RomImage::copy(romDump));
+    }
+
+    void insertCartridge(std::shared_ptr<const RomImage> image) {
+        cart.load(std::move(image));
+        bus.mapCartridge();
         clock.setRegion(cart.getRegion());
+        apu.setRegion(cart.getRegion());
 
         // reset interrupt called on cartridge insertion
         // tick CPU past reset interrupt without PPU
@@ -58,7 +75,105 @@ class NES {
             cpu.tick();
     }
 
-    void start() { clock.start(); }
+    /**
+     * Runs in real time until frontend reports a quit, see Clock::start().
+     */
+    void start(Frontend &frontend) { clock.start(frontend); }
+
+    /**
+     * Runs frameCount frames without rendering or frame pacing.
+     */
+    HeadlessResult runHeadless(uint64_t frameCount) {
+        return clock.runHeadless(frameCount);
+    }
+
+    /**
+     * Drive the console directly at full speed, see Clock::runFrame(). No
+     * window, pacing, rewind or run-ahead; completed frames go to the frame
+     * callback.
+     */
+    const Frame &runFrame() { return clock.runFrame(); }
+    uint64_t runCycles(uint64_t cycles) { return clock.runCycles(cycles); }
+    template <typename Predicate> uint64_t runUntil(Predicate &&done) {
+        return clock.runUntil(std::forward<Predicate>(done));
+    }
+    void setFrameCallback(std::function<void(const Frame &)> callback) {
+        clock.setFrameCallback(std::move(callback));
+    }
+
+    static constexpr uint32_t SAVE_STATE_MAGIC = 0x5353454E; // "NESS"
+    static constexpr uint32_t SAVE_STATE_VERSION = 7;
+
+    /**
+     * Captures the full machine state, including a partly executed CPU
+     * instruction and the PPU dot position, into out. out is cleared first
+     * but keeps its capacity, so saving every frame does not allocate.
+     * Snapshots are only valid for the same build and ROM.
+     */
+    void saveState(std::vector<uint8_t> &out) {
+        out.clear();
+        StateWriter writer(out);
+        writer.write(SAVE_STATE_MAGIC);
+        writer.write(SAVE_STATE_VERSION);
+        writer.write(cart.getCRC32());
+        cpu.saveState(writer);
+        ppu.saveState(writer);
+        apu.saveState(writer);
+        bus.saveState(writer);
+        cart.saveState(writer);
+        clock.saveState(writer);
+    }
+
+    /**
+     * Restores a snapshot taken by saveState(). Throws std::invalid_argument
+     * if it was written by another version or for another ROM, and
+     * std::runtime_error if it is truncated or corrupt. The console is left
+     * unchanged when it throws.
+     */
+    void loadState(const std::vector<uint8_t> &state) {
+        StateReader reader(state);
+        readStateHeader(reader);
+
+        // components check their state as they load it, so keep the current
+        // one to put back if a later component rejects its part
+        saveState(rollbackState);
+        try {
+            loadComponents(reader);
+        } catch (...) {
+            StateReader rollback(rollbackState);
+            readStateHeader(rollback);
+            loadComponents(rollback);
+            throw;
+        }
+    }
+
+  private:
+    std::vector<uint8_t> rollbackState; // reused by every loadState()
+
+    void readStateHeader(StateReader &reader) const {
+        if (reader.read<uint32_t>() != SAVE_STATE_MAGIC) {
+            throw std::invalid_argument("Not a save state");
+        }
+        if (reader.read<uint32_t>() != SAVE_STATE_VERSION) {
+            throw std::invalid_argument("Unsupported save state version");
+        }
+        if (reader.read<uint32_t>() != cart.getCRC32()) {
+            throw std::invalid_argument("Save state is for a different ROM");
+        }
+    }
+
+    void loadComponents(StateReader &reader) {
+        cpu.loadState(reader);
+        ppu.loadState(reader);
+        apu.loadState(reader);
+        bus.loadState(reader);
+        cart.loadState(reader);
+        bus.mapCartridge(); // mapper banks may differ from the saved ones
+        clock.loadState(reader);
+        if (!reader.atEnd()) {
+            throw std::runtime_error("Save state has trailing data");
+        }
+    }
 };
 
 #endif // NES_H
@@ -2,8 +2,8 @@
 #define PPU_H
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
-#include <optional>
 
 #include "../Cartridge.h"
 #include "../Renderer/Frame.h"
@@ -13,15 +13,35 @@
 #include "Registers/PPUScroll.h"
 #include "Registers/PPUStatus.h"
 
+class StateWriter;
+class StateReader;
+
+/**
+ * How visible background pixels are produced, see PPU::setRenderMode().
+ */
+enum class PPURenderMode {
+    Dot,      // fetch and draw on every visible dot
+    Scanline, // draw visible dots in one batch, normally a whole scanline
+};
+
 class PPU {
+  public:
+    /**
+     * Frames are drawn into a fixed ring of buffers. A completed frame is
+     * not written to again until FRAME_BUFFERS - 1 further frames have
+     * completed, so it can be displayed while the next one is drawn.
+     */
+    static constexpr std::size_t FRAME_BUFFERS = 3;
+
   private:
-    std::optional<Frame> currentFrame = std::nullopt;
+    std::array<Frame, FRAME_BUFFERS> frameBuffers;
+    std::size_t nextFrameBuffer = 0;
+    Frame *currentFrame = nullptr; // null between vblank and the next frame
 
     // Background tile fetch state
     uint8_t tileID = 0;
     uint8_t attribute = 0;
-    uint8_t patternLow = 0;
-    uint8_t patternHigh = 0;
+    TileRow tilePixels{}; // decoded pattern row of the fetched tile
 
     // Registers
     PPUCtrl ctrl;         // 0x2000
@@ -39,6 +59,12 @@ class PPU {
     std::array<uint8_t, 2048> vram{};
     Cartridge &cart;
 
+    PPURenderMode renderMode = PPURenderMode::Dot;
+    // Scanline mode: visible dots of the current scanline already drawn.
+    uint16_t renderedDots = 0;
+    // Off for frames that are emulated but never shown, see setVideoOutput().
+    bool videoOutput = true;
+
     uint16_t cycles = 0;
     int scanline = 0;
     bool oddFrame = false;
@@ -58,7 +84,10 @@ class PPU {
     bool spriteZeroPixelOpaque(int screenX, int screenY) const;
     void evaluateSpriteZeroHit(int screenX, int screenY,
                                bool backgroundOpaque);
+    void beginFrame();
     void renderSprites(Frame &frame);
+    void renderBackgroundDots(uint16_t from, uint16_t to);
+    void clockPatternTableA12();
 
   public:
     PPU(const PPU &) = delete;
@@ -68,7 +97,41 @@ class PPU {
 
     explicit PPU(Cartridge &cart) : cart(cart) { oam_data.fill(0xFF); }
 
-    std::optional<Frame> tick();
+    /**
+     * Advances one dot. Returns the frame completed on this dot, or nullptr.
+     * The frame is owned by the PPU, see FRAME_BUFFERS.
+     */
+    const Frame *tick();
+
+    /**
+     * Scanline mode produces frames identical to Dot mode. Register writes
+     * that affect rendering draw the dots already elapsed before they land.
+     */
+    void setRenderMode(PPURenderMode mode);
+    PPURenderMode getRenderMode() const { return renderMode; }
+
+    /**
+     * With video output off the PPU still fetches tiles and sets sprite zero
+     * hit, so emulation is unchanged, but no pixels are pushed or composited
+     * and the frames tick() returns hold stale pixels. Used for frames that
+     * are never shown.
+     */
+    void setVideoOutput(bool enabled);
+    bool getVideoOutput() const { return videoOutput; }
+
+    /**
+     * In Scanline mode, draws the visible dots that have elapsed on this
+     * scanline but have not been drawn yet. Called before any change that
+     * could alter their output, including cartridge bank switches.
+     */
+    void catchUpBackground();
+
+    /**
+     * Saves registers, memory, dot position and the part of the current frame
+     * drawn so far. The render mode is a host setting and is not saved.
+     */
+    void saveState(StateWriter &out);
+    void loadState(StateReader &in);
 
     bool getNMI() const { return nmiInterrupt; }
     uint16_t getScanline() const { return static_cast<uint16_t>(scanline); }
@@ -98,6 +161,7 @@ class PPU {
     uint8_t TEST_getstatus() const { return status.snapshot(); }
     uint16_t TEST_getaddr() const { return addr.get(); }
     void TEST_set_vblank_status(bool val) { status.set_vblank_status(val); }
+    void TEST_renderSprites(Frame &frame) { renderSprites(frame); }
 };
 
 #endif
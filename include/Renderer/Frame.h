@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "../Constants.h"
+#include "../Hash.h"
 
 using Colour = std::tuple<uint8_t, uint8_t, uint8_t>;
 
@@ -83,29 +84,35 @@ inline constexpr std::array<Colour, 64> NES_PALETTE = {{
     {0, 0, 0}        // 0x3F
 }};
 
+/**
+ * One completed or in-progress PPU frame. Pixels are stored as NES palette
+ * indices (0-63, the top two bits are always clear), one byte per pixel, and
+ * only converted to RGB when presented, see PaletteConversion.h.
+ */
 class Frame {
   public:
     std::vector<uint8_t> pixelData;
     std::vector<uint8_t> backgroundOpaque;
-    std::size_t currentPixel;
     std::size_t currentPixelIndex;
 
     Frame()
-        : pixelData(SCREEN_WIDTH * SCREEN_HEIGHT * 3, 0),
-          backgroundOpaque(SCREEN_WIDTH * SCREEN_HEIGHT, 0), currentPixel(0),
+        : pixelData(SCREEN_WIDTH * SCREEN_HEIGHT, 0),
+          backgroundOpaque(SCREEN_WIDTH * SCREEN_HEIGHT, 0),
           currentPixelIndex(0) {}
 
+    // Rewinds to the first pixel so the buffer can be drawn again
+    void restart() { currentPixelIndex = 0; }
+
     // PPU determines colour and sets pixel
     void push(uint8_t colour, bool isBackgroundOpaque = false) {
-        const auto &[r, g, b] = NES_PALETTE[colour & 0x3F]; // 0-63
-        pixelData[currentPixel] = r;
-        pixelData[currentPixel + 1] = g;
-        pixelData[currentPixel + 2] = b;
+        pixelData[currentPixelIndex] = colour & 0x3F; // 0-63
         backgroundOpaque[currentPixelIndex] =
             static_cast<uint8_t>(isBackgroundOpaque ? 1 : 0);
-        currentPixel += 3;
         currentPixelIndex++;
     }
+
+    // Fingerprint of the palette indices, used to compare frames across runs
+    uint64_t hash() const { return fnv1a64(pixelData.data(), pixelData.size()); }
 };
 
 #endif // FRAME_H
@@ -0,0 +1,57 @@
+#ifndef FRAMEMAILBOX_H
+#define FRAMEMAILBOX_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "Frame.h"
+
+/**
+ * Hands completed frames from the emulation thread to the presenting thread
+ * without locks. Slots are triple buffered: the producer fills its back slot
+ * and swaps it with the shared middle slot, the consumer swaps its front slot
+ * with the middle one when a newer frame is there. Neither side ever waits,
+ * and frames the consumer is too slow to take are overwritten, so it always
+ * receives the latest one.
+ *
+ * Exactly one thread may call publish() and one thread take().
+ */
+class FrameMailbox {
+  private:
+    static constexpr uint8_t INDEX_MASK = 0x03;
+    static constexpr uint8_t FRESH = 0x04; // middle slot not yet taken
+
+    std::array<Frame, 3> slots;
+    std::atomic<uint8_t> middle{1};
+    uint8_t back = 0;  // producer only
+    uint8_t front = 2; // consumer only
+
+  public:
+    /**
+     * Copies the pixels of frame into the mailbox, replacing any frame that
+     * has not been taken yet. Does not allocate.
+     */
+    void publish(const Frame &frame) {
+        Frame &slot = slots[back];
+        slot.pixelData = frame.pixelData; // same size, reuses storage
+        slot.currentPixelIndex = frame.currentPixelIndex;
+        back = middle.exchange(back | FRESH, std::memory_order_acq_rel) &
+               INDEX_MASK;
+    }
+
+    /**
+     * Returns the most recently published frame if it has not been taken
+     * before, otherwise nullptr. The frame stays valid until the next call.
+     * Only pixelData is transferred.
+     */
+    const Frame *take() {
+        if ((middle.load(std::memory_order_relaxed) & FRESH) == 0) {
+            return nullptr;
+        }
+        front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+        return &slots[front];
+    }
+};
+
+#endif // FRAMEMAILBOX_H
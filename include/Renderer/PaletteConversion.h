@@ -0,0 +1,47 @@
+#ifndef PALETTECONVERSION_H
+#define PALETTECONVERSION_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Implementations of the palette index to RGBA conversion. Only Scalar is
+ * available everywhere; the x86 paths are chosen at runtime from the host
+ * CPU and NEON is used on every AArch64 host.
+ *
+ * Plain SSE2 has no byte shuffle to look colours up with, so the baseline
+ * x86 vector path needs SSSE3.
+ */
+enum class PaletteConversionPath {
+    Scalar,
+    SSSE3, // 16 pixels per step, pshufb lookup
+    AVX2,  // 32 pixels per step, vpshufb lookup
+    NEON,  // 16 pixels per step, 64 byte tbl lookup
+};
+
+const char *paletteConversionPathName(PaletteConversionPath path);
+
+bool paletteConversionSupported(PaletteConversionPath path);
+
+/**
+ * Fastest path supported by the host CPU. Determined once.
+ */
+PaletteConversionPath bestPaletteConversionPath();
+
+/**
+ * Converts count NES palette indices into RGBA bytes (R, G, B, 255 per
+ * pixel) using NES_PALETTE. Only the low six bits of each index are used.
+ * rgba must hold count * 4 bytes.
+ */
+void convertPaletteIndicesToRGBA(const uint8_t *indices, std::size_t count,
+                                 uint8_t *rgba);
+
+/**
+ * As above, with an explicit implementation, which must be supported.
+ * Used to compare implementations in tests and benchmarks.
+ */
+void convertPaletteIndicesToRGBA(PaletteConversionPath path,
+                                 const uint8_t *indices, std::size_t count,
+                                 uint8_t *rgba);
+
+#endif // PALETTECONVERSION_H
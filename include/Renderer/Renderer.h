@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "Frame.h"
+#include "Scaler.h"
 
 class Renderer {
   private:
@@ -42,11 +43,9 @@ class Renderer {
     std::unique_ptr<SDL_Window, WindowDeleter> sdlWindow;
     std::unique_ptr<SDL_Renderer, RendererDeleter> sdlRenderer;
     std::unique_ptr<SDL_Texture, TextureDeleter> sdlTexture;
-    std::vector<uint8_t> upscaledPixelData =
-        std::vector<uint8_t>(RENDER_WIDTH * RENDER_HEIGHT * 3, 0);
-    uint64_t fpsWindowStartMs = 0;
-    uint32_t framesInCurrentWindow = 0;
-    float currentFps = 0.0f;
+    std::unique_ptr<Scaler> scaler;
+    std::vector<uint32_t> rgbaPixelData =
+        std::vector<uint32_t>(SCREEN_WIDTH * SCREEN_HEIGHT, 0);
 
   public:
     Renderer(const Renderer &) = delete;
@@ -54,9 +53,11 @@ class Renderer {
     Renderer(Renderer &&) noexcept = default;
     Renderer &operator=(Renderer &&) = delete;
 
-    // Constructor: initializes SDL, creates a window, renderer, and texture.
-    Renderer(SDL_Window *w, SDL_Renderer *r, SDL_Texture *t)
-        : sdlWindow(w), sdlRenderer(r), sdlTexture(t) {}
+    // Constructor: takes ownership of the window, renderer and texture. The
+    // texture must match the scaler's output size.
+    Renderer(SDL_Window *w, SDL_Renderer *r, SDL_Texture *t,
+             std::unique_ptr<Scaler> s = makeScaler(ScalerKind::GPU, 1))
+        : sdlWindow(w), sdlRenderer(r), sdlTexture(t), scaler(std::move(s)) {}
 
     // Destructor: cleans up SDL resources.
     ~Renderer() {
@@ -70,7 +71,7 @@ class Renderer {
         }
     }
 
-    // Renders a Frame object onto the SDL window
+    // Converts a Frame object to RGBA and renders it onto the SDL window
     void render(const Frame &frame);
 };
 
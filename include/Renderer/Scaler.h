@@ -0,0 +1,52 @@
+#ifndef SCALER_H
+#define SCALER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * Final stage before a frame is uploaded to the SDL texture. The texture is
+ * created with the scaler's output size and SDL stretches it over the window
+ * with nearest filtering, so a scaler only has to do work the GPU cannot.
+ */
+enum class ScalerKind {
+    GPU,       // native frame is uploaded as is, no CPU scaling
+    Nearest,   // integer nearest neighbour
+    Scanlines, // nearest, with the last row of every source row darkened
+    EPX,       // Scale2x/Scale3x edge smoothing, factor 2 or 3 only
+};
+
+const char *scalerKindName(ScalerKind kind);
+
+/**
+ * Inverse of scalerKindName(). Throws std::invalid_argument for an unknown
+ * name.
+ */
+ScalerKind scalerKindFromName(const std::string &name);
+
+class Scaler {
+  public:
+    virtual ~Scaler() = default;
+
+    virtual int outputWidth() const = 0;
+    virtual int outputHeight() const = 0;
+
+    /**
+     * Scales a SCREEN_WIDTH x SCREEN_HEIGHT image of RGBA pixels (bytes in
+     * R, G, B, A order). Returns outputWidth() x outputHeight() pixels in
+     * the same format, valid until the next call. May return pixels itself.
+     */
+    virtual const uint32_t *scale(const uint32_t *pixels) = 0;
+};
+
+/**
+ * Creates a scaler of the given kind, scaling by factor in both directions.
+ * CPU scalers use SSE2 or NEON where the target has it; vectorized = false
+ * forces the scalar code, for comparison in tests and benchmarks. Throws
+ * std::invalid_argument if kind does not support factor.
+ */
+std::unique_ptr<Scaler> makeScaler(ScalerKind kind, int factor,
+                                   bool vectorized = true);
+
+#endif // SCALER_H
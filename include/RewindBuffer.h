@@ -0,0 +1,82 @@
+#ifndef REWINDBUFFER_H
+#define REWINDBUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+/**
+ * Rewind metrics, see RewindBuffer::stats().
+ */
+struct RewindStats {
+    std::size_t frames = 0;        // snapshots that can currently be restored
+    std::size_t historyBytes = 0;  // compressed deltas held in the ring
+    std::size_t budgetBytes = 0;   // ring capacity
+    std::size_t snapshotBytes = 0; // newest snapshot, uncompressed
+    uint64_t framesRecorded = 0;   // snapshots pushed since the last clear()
+    double lastCompressMicros = 0.0;
+    double totalCompressMicros = 0.0;
+
+    double averageCompressMicros() const {
+        return framesRecorded > 0
+                   ? totalCompressMicros / static_cast<double>(framesRecorded)
+                   : 0.0;
+    }
+};
+
+/**
+ * Bounded history of machine snapshots for rewinding.
+ *
+ * The newest snapshot is kept as is. Every older snapshot is stored as the
+ * XOR of itself and the snapshot after it, run-length encoded, in a ring of
+ * budgetBytes bytes. Consecutive frames differ in only a few bytes of RAM,
+ * so most deltas are a handful of bytes. When the ring is full the oldest
+ * deltas are dropped.
+ */
+class RewindBuffer {
+  private:
+    struct Entry {
+        std::size_t offset;       // position of the delta in ring
+        std::size_t length;       // compressed delta length
+        std::size_t previousSize; // size of the snapshot the delta restores
+    };
+
+    std::vector<uint8_t> ring;
+    std::deque<Entry> entries; // oldest first
+    std::size_t head = 0;      // next write position in ring
+    std::vector<uint8_t> newest;
+    bool hasNewest = false;
+    std::vector<uint8_t> scratch; // compressed delta being built
+    RewindStats statistics;
+
+    void storeDelta(std::size_t previousSize);
+
+  public:
+    explicit RewindBuffer(std::size_t budgetBytes = 0) {
+        setBudget(budgetBytes);
+    }
+
+    /**
+     * Resizes the ring and drops all history. 0 disables rewinding.
+     */
+    void setBudget(std::size_t budgetBytes);
+    bool enabled() const { return !ring.empty(); }
+    void clear();
+
+    /**
+     * Records snapshot as the newest point in history.
+     */
+    void push(const std::vector<uint8_t> &snapshot);
+
+    /**
+     * Drops the newest snapshot and writes the one before it to snapshot,
+     * which then becomes the newest. Returns false if there is no older
+     * snapshot.
+     */
+    bool stepBack(std::vector<uint8_t> &snapshot);
+
+    const RewindStats &stats() const { return statistics; }
+};
+
+#endif // REWINDBUFFER_H
@@ -0,0 +1,94 @@
+#ifndef ROMDATABASE_H
+#define ROMDATABASE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "RomHeader.h"
+
+/**
+ * Known-good header fields for one dump, keyed by the CRC32 of its PRG ROM
+ * followed by its CHR ROM (the NesCartDB convention, so the header itself
+ * does not affect the key).
+ */
+struct RomDatabaseEntry {
+    uint32_t crc32;
+    uint16_t mapper;
+    uint8_t submapper;
+    MirroringMode mirroring;
+    NESRegion region;
+    uint32_t prgRamSize;   // volatile PRG RAM in bytes
+    uint32_t prgNvramSize; // battery-backed PRG RAM in bytes
+
+    // replaces the board fields of header; ROM sizes are left alone
+    void applyTo(RomHeader &header) const {
+        header.mapper = mapper;
+        header.submapper = submapper;
+        header.mirroring = mirroring;
+        header.region = region;
+        header.prgRamSize = prgRamSize;
+        header.prgNvramSize = prgNvramSize;
+        header.battery = prgNvramSize != 0;
+    }
+};
+
+/**
+ * Sorted table of RomDatabaseEntry, searched by binary search. Nothing is
+ * parsed or allocated, so a lookup costs a few comparisons at load time.
+ */
+class RomDatabase {
+  private:
+    std::span<const RomDatabaseEntry> entries;
+
+  public:
+    /**
+     * entries must be sorted by crc32 and outlive the database.
+     */
+    constexpr explicit RomDatabase(std::span<const RomDatabaseEntry> entries)
+        : entries(entries) {}
+
+    /**
+     * Returns the entry for crc32, or nullptr if the dump is not known.
+     */
+    const RomDatabaseEntry *find(uint32_t crc32) const;
+
+    bool empty() const { return entries.empty(); }
+    std::size_t size() const { return entries.size(); }
+
+    /**
+     * Database compiled into the emulator. It holds no dumps yet, so header
+     * corrections come from a table installed with install().
+     */
+    static const RomDatabase &embedded();
+
+    /**
+     * Database Cartridge::load() uses when none is given: the last table
+     * passed to install(), or embedded().
+     */
+    static const RomDatabase &standard();
+
+    /**
+     * Makes entries the standard() database for the rest of the program,
+     * sorting them first. Not thread safe; call it at startup, before any
+     * ROM is loaded.
+     */
+    static void install(std::vector<RomDatabaseEntry> entries);
+
+    /**
+     * Reads a table of header corrections, one dump per line:
+     *
+     *   <crc32> <mapper> <submapper> <mirroring> <region> <prg ram> <prg nvram>
+     *
+     * crc32 is hexadecimal (see Cartridge::getCRC32()), mirroring is one of
+     * H, V or 4, region one of NTSC, PAL or Dendy, and the RAM sizes are in
+     * bytes. '#' starts a comment; lines may be in any order. Throws
+     * std::runtime_error if the file cannot be read or a line is malformed,
+     * naming the line.
+     */
+    static std::vector<RomDatabaseEntry> readFile(const std::string &path);
+};
+
+#endif // ROMDATABASE_H
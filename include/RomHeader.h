@@ -0,0 +1,58 @@
+#ifndef ROMHEADER_H
+#define ROMHEADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "Mapper/Mapper.h"
+
+enum class NESRegion { NTSC, PAL, Dendy, None };
+enum class RomFormat { INES, NES2 };
+
+/**
+ * Decoded iNES 1.0 or NES 2.0 header, see Cartridge.h for the shared layout.
+ * https://www.nesdev.org/wiki/NES_2.0
+ *
+ * NES 2.0 extends bytes 8-15:
+ * Byte | Description
+ * ---------------------------------------------
+ * 8    | Mapper bits 8-11 (low nibble), submapper (high nibble)
+ * 9    | PRG ROM size MSB (low nibble), CHR ROM size MSB (high nibble)
+ * 10   | PRG RAM shift (low nibble), PRG NVRAM shift (high nibble)
+ * 11   | CHR RAM shift (low nibble), CHR NVRAM shift (high nibble)
+ * 12   | CPU/PPU timing (0: NTSC; 1: PAL; 2: multiple-region; 3: Dendy)
+ * 13   | Vs. System type / extended console type
+ * 14   | Number of miscellaneous ROMs
+ * 15   | Default expansion device
+ *
+ * RAM sizes are 64 << shift bytes, or none for a shift of 0. A size MSB of
+ * $F selects exponent-multiplier notation for the LSB: 2^E * (MM * 2 + 1).
+ */
+struct RomHeader {
+    RomFormat format = RomFormat::INES;
+    uint16_t mapper = 0;
+    uint8_t submapper = 0;
+    MirroringMode mirroring = MirroringMode::Horizontal;
+    NESRegion region = NESRegion::None;
+    bool battery = false;
+    bool trainer = false;
+    std::size_t prgRomSize = 0;
+    std::size_t chrRomSize = 0;
+    // iNES 1.0 only records battery-backed PRG RAM, as 8 KiB of PRG NVRAM
+    std::size_t prgRamSize = 0;
+    std::size_t prgNvramSize = 0;
+    std::size_t chrRamSize = 0;
+    std::size_t chrNvramSize = 0;
+
+    // offset of PRG ROM in the file, CHR ROM follows it
+    std::size_t prgRomOffset() const { return 16 + (trainer ? 512 : 0); }
+
+    /**
+     * Decodes the header of romDump. Throws std::invalid_argument if it is
+     * not an iNES file or is too short for the ROM sizes it declares.
+     */
+    static RomHeader parse(std::span<const uint8_t> romDump);
+};
+
+#endif // ROMHEADER_H
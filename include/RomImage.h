@@ -0,0 +1,49 @@
+#ifndef ROMIMAGE_H
+#define ROMIMAGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ * Read-only bytes of a ROM dump. Cartridges refer into the image instead of
+ * copying PRG and CHR ROM, so emulator instances running the same ROM share
+ * one image.
+ */
+class RomImage {
+  private:
+    const uint8_t *data = nullptr;
+    std::size_t size = 0;
+    bool mapped = false;        // data is a file mapping, unmapped on destruction
+    std::vector<uint8_t> owned; // backing store when not mapped
+
+    RomImage() = default;
+
+  public:
+    RomImage(const RomImage &) = delete;
+    RomImage &operator=(const RomImage &) = delete;
+    RomImage(RomImage &&) = delete;
+    RomImage &operator=(RomImage &&) = delete;
+    ~RomImage();
+
+    /**
+     * Maps the file at path read-only. Opening a file that is already open in
+     * this process returns the existing image. Falls back to reading the file
+     * on platforms without mmap. Throws std::runtime_error if the file cannot
+     * be opened.
+     */
+    static std::shared_ptr<const RomImage> open(const std::string &path);
+
+    /**
+     * Image holding a copy of bytes, for dumps that are already in memory.
+     */
+    static std::shared_ptr<const RomImage> copy(std::span<const uint8_t> bytes);
+
+    std::span<const uint8_t> bytes() const { return {data, size}; }
+    bool isMapped() const { return mapped; }
+};
+
+#endif // ROMIMAGE_H
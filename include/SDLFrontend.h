@@ -0,0 +1,24 @@
+#ifndef SDLFRONTEND_H
+#define SDLFRONTEND_H
+
+#include <utility>
+
+#include "Frontend.h"
+#include "Renderer/Renderer.h"
+
+/**
+ * Frontend for an SDL window: presents frames through a Renderer and maps
+ * the keyboard to joypad 1, see the README for the controls.
+ */
+class SDLFrontend : public Frontend {
+  private:
+    Renderer renderer;
+
+  public:
+    explicit SDLFrontend(Renderer renderer) : renderer(std::move(renderer)) {}
+
+    FrontendInput poll() override;
+    void present(const Frame &frame) override { renderer.render(frame); }
+};
+
+#endif // SDLFRONTEND_H
@@ -0,0 +1,70 @@
+#ifndef SAVESTATE_H
+#define SAVESTATE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Appends raw component state to a contiguous buffer. Values are copied
+ * byte for byte, so a snapshot is only valid for the build that wrote it;
+ * NES::saveState() prefixes a version number to reject anything else.
+ */
+class StateWriter {
+  private:
+    std::vector<uint8_t> &buffer;
+
+  public:
+    explicit StateWriter(std::vector<uint8_t> &buffer) : buffer(buffer) {}
+
+    void writeBytes(const void *data, std::size_t length) {
+        const std::size_t offset = buffer.size();
+        buffer.resize(offset + length);
+        std::memcpy(buffer.data() + offset, data, length);
+    }
+
+    template <typename T> void write(const T &value) {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "only trivially copyable state can be saved directly");
+        writeBytes(&value, sizeof(T));
+    }
+};
+
+/**
+ * Reads state written by StateWriter back in the same order. Throws
+ * std::runtime_error if the buffer ends early.
+ */
+class StateReader {
+  private:
+    const uint8_t *cursor;
+    const uint8_t *end;
+
+  public:
+    explicit StateReader(const std::vector<uint8_t> &buffer)
+        : cursor(buffer.data()), end(buffer.data() + buffer.size()) {}
+
+    void readBytes(void *data, std::size_t length) {
+        if (static_cast<std::size_t>(end - cursor) < length) {
+            throw std::runtime_error("Save state is truncated");
+        }
+        std::memcpy(data, cursor, length);
+        cursor += length;
+    }
+
+    template <typename T> T read() {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "only trivially copyable state can be loaded directly");
+        T value;
+        readBytes(&value, sizeof(T));
+        return value;
+    }
+
+    template <typename T> void read(T &value) { value = read<T>(); }
+
+    bool atEnd() const { return cursor == end; }
+};
+
+#endif // SAVESTATE_H
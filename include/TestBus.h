@@ -11,7 +11,7 @@
 
 #include "BusInterface.h"
 
-struct TestBus : public BusInterface {
+struct TestBus final : public BusInterface {
  private:
   std::array<uint8_t, 0x10000> memory = {};
 
@@ -0,0 +1,89 @@
+#ifndef TRACERECORDER_H
+#define TRACERECORDER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CPU/TraceRecord.h"
+
+/**
+ * Keeps the most recent traced instructions in a ring of TraceRecords
+ * allocated up front, so appending is a copy and never allocates. The ring
+ * lives in memory, or in a shared file mapping so the trace outlives the
+ * process; read a file back with readFile() and print records with
+ * Logger::format().
+ */
+class TraceRecorder {
+  public:
+    static constexpr char MAGIC[8] = {'N', 'E', 'S', 'T', 'R', 'A', 'C', 'E'};
+    static constexpr uint32_t VERSION = 1;
+
+    // start of a trace file, followed by capacity records
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t recordSize;
+        uint64_t capacity; // records in the ring, a power of two
+        uint64_t written;  // records ever appended, oldest is overwritten
+    };
+
+  private:
+    FileHeader *header = nullptr;
+    TraceRecord *records = nullptr;
+    uint64_t count = 0;
+    uint64_t mask = 0;
+    std::size_t bytes = 0;
+    bool mapped = false;                // unmapped on destruction
+    std::unique_ptr<uint8_t[]> owned;   // backing store when not mapped
+    std::string path;                   // written on destruction if not mapped
+
+    void allocate(std::size_t capacity);
+
+  public:
+    TraceRecorder(const TraceRecorder &) = delete;
+    TraceRecorder &operator=(const TraceRecorder &) = delete;
+    TraceRecorder(TraceRecorder &&) = delete;
+    TraceRecorder &operator=(TraceRecorder &&) = delete;
+
+    /**
+     * Ring in memory holding the last capacity records (rounded up to a power
+     * of two).
+     */
+    explicit TraceRecorder(std::size_t capacity);
+
+    /**
+     * Ring in the file at path, created or truncated and mapped shared.
+     * Written out on destruction on platforms without mmap. Throws
+     * std::runtime_error if the file cannot be created.
+     */
+    TraceRecorder(const std::string &path, std::size_t capacity);
+
+    ~TraceRecorder();
+
+    void append(const TraceRecord &record) {
+        records[count & mask] = record;
+        header->written = ++count;
+    }
+
+    uint64_t written() const { return count; }
+    std::size_t capacity() const { return static_cast<std::size_t>(mask + 1); }
+    std::size_t size() const {
+        return count < mask + 1 ? static_cast<std::size_t>(count) : capacity();
+    }
+
+    /**
+     * The records still in the ring, oldest first.
+     */
+    std::vector<TraceRecord> snapshot() const;
+
+    /**
+     * Reads the records of a trace file, oldest first. Throws
+     * std::runtime_error if it cannot be read or is not a trace file.
+     */
+    static std::vector<TraceRecord> readFile(const std::string &path);
+};
+
+#endif // TRACERECORDER_H
@@ -0,0 +1,509 @@
+#include "../../include/APU/APU.h"
+
+#include <algorithm>
+
+#include "../../include/Cartridge.h"
+#include "../../include/Clock.h"
+#include "../../include/RomHeader.h"
+#include "../../include/SaveState.h"
+
+namespace {
+
+// frame counter step events
+constexpr uint8_t QUARTER = 0x01; // envelopes and triangle linear counter
+constexpr uint8_t HALF = 0x02;    // length counters and sweeps
+constexpr uint8_t IRQ = 0x04;     // frame IRQ, unless inhibited
+constexpr uint8_t WRAP = 0x08;    // last step, the sequence restarts
+
+// https://www.nesdev.org/wiki/APU_Frame_Counter, in CPU cycles
+constexpr FrameSequence FOUR_STEP_NTSC = {{
+    {7457, QUARTER},
+    {14913, QUARTER | HALF},
+    {22371, QUARTER},
+    {29828, IRQ},
+    {29829, QUARTER | HALF | IRQ},
+    {29830, IRQ | WRAP},
+}};
+constexpr FrameSequence FIVE_STEP_NTSC = {{
+    {7457, QUARTER},
+    {14913, QUARTER | HALF},
+    {22371, QUARTER},
+    {29829, 0},
+    {37281, QUARTER | HALF},
+    {37282, WRAP},
+}};
+constexpr FrameSequence FOUR_STEP_PAL = {{
+    {8313, QUARTER},
+    {16627, QUARTER | HALF},
+    {24939, QUARTER},
+    {33252, IRQ},
+    {33253, QUARTER | HALF | IRQ},
+    {33254, IRQ | WRAP},
+}};
+constexpr FrameSequence FIVE_STEP_PAL = {{
+    {8313, QUARTER},
+    {16627, QUARTER | HALF},
+    {24939, QUARTER},
+    {33253, 0},
+    {41565, QUARTER | HALF},
+    {41566, WRAP},
+}};
+
+constexpr std::array<uint16_t, 16> NOISE_PERIODS_NTSC = {
+    4, 8, 16, 32, 64, 96, 128, 160, 202, 254, 380, 508, 762, 1016, 2034, 4068};
+constexpr std::array<uint16_t, 16> NOISE_PERIODS_PAL = {
+    4, 8, 14, 30, 60, 88, 118, 148, 188, 236, 354, 472, 708, 944, 1890, 3778};
+constexpr std::array<uint16_t, 16> DMC_PERIODS_NTSC = {
+    428, 380, 340, 320, 286, 254, 226, 214,
+    190, 160, 142, 128, 106, 84,  72,  54};
+constexpr std::array<uint16_t, 16> DMC_PERIODS_PAL = {
+    398, 354, 316, 298, 276, 236, 210, 198,
+    176, 148, 132, 118, 98,  78,  66,  50};
+
+// nonlinear DAC response, https://www.nesdev.org/wiki/APU_Mixer
+const std::array<float, 31> PULSE_TABLE = [] {
+    std::array<float, 31> table{};
+    for (std::size_t n = 1; n < table.size(); n++) {
+        table[n] = static_cast<float>(95.52 / (8128.0 / n + 100.0));
+    }
+    return table;
+}();
+
+// indexed by 3 * triangle + 2 * noise + dmc
+const std::array<float, 203> TND_TABLE = [] {
+    std::array<float, 203> table{};
+    for (std::size_t n = 1; n < table.size(); n++) {
+        table[n] = static_cast<float>(163.67 / (24329.0 / n + 100.0));
+    }
+    return table;
+}();
+
+// Samples are flushed without endFrame() once a frame is this long, which
+// a catch-up span (at most one frame counter step) can overshoot.
+constexpr uint32_t AUTO_FLUSH_CYCLES = 40000;
+constexpr uint32_t MAX_FRAME_CYCLES = AUTO_FLUSH_CYCLES + 16384;
+
+constexpr std::size_t RING_SAMPLES = 8192; // ~170 ms at 48 kHz
+
+// DMA cycles the CPU loses per DMC sample fetch; 1-4 on hardware depending
+// on what the CPU was doing
+constexpr uint32_t DMC_STALL_CYCLES = 4;
+
+// The channel structs have padding, so they are saved field by field rather
+// than as raw copies with indeterminate bytes in them. The same list serves
+// saving and loading.
+template <typename F> void forEachField(Envelope &e, F &&f) {
+    f(e.start);
+    f(e.loop);
+    f(e.constant);
+    f(e.period);
+    f(e.divider);
+    f(e.decay);
+}
+
+template <typename F> void forEachField(Pulse &p, F &&f) {
+    forEachField(p.envelope, f);
+    f(p.duty);
+    f(p.sequence);
+    f(p.period);
+    f(p.timer);
+    f(p.length);
+    f(p.enabled);
+    f(p.sweepEnabled);
+    f(p.sweepNegate);
+    f(p.sweepReload);
+    f(p.sweepPeriod);
+    f(p.sweepShift);
+    f(p.sweepDivider);
+}
+
+template <typename F> void forEachField(Triangle &t, F &&f) {
+    f(t.sequence);
+    f(t.period);
+    f(t.timer);
+    f(t.length);
+    f(t.enabled);
+    f(t.control);
+    f(t.linearReloadValue);
+    f(t.linear);
+    f(t.linearReload);
+}
+
+template <typename F> void forEachField(Noise &n, F &&f) {
+    forEachField(n.envelope, f);
+    f(n.shortMode);
+    f(n.shift);
+    f(n.period);
+    f(n.timer);
+    f(n.length);
+    f(n.enabled);
+}
+
+template <typename F> void forEachField(DMC &d, F &&f) {
+    f(d.irqEnabled);
+    f(d.loop);
+    f(d.irq);
+    f(d.period);
+    f(d.timer);
+    f(d.level);
+    f(d.sampleAddress);
+    f(d.sampleLength);
+    f(d.address);
+    f(d.bytesRemaining);
+    f(d.buffer);
+    f(d.bufferFull);
+    f(d.shift);
+    f(d.bitsRemaining);
+    f(d.silence);
+}
+
+template <typename Channel> void saveChannel(StateWriter &out, Channel &c) {
+    forEachField(c, [&out](const auto &field) { out.write(field); });
+}
+
+template <typename Channel> void loadChannel(StateReader &in, Channel &c) {
+    forEachField(c, [&in](auto &field) { in.read(field); });
+}
+
+} // namespace
+
+APU::APU(Cartridge &cart)
+    : cart(cart), noisePeriods(&NOISE_PERIODS_NTSC),
+      dmcPeriods(&DMC_PERIODS_NTSC), fourStepSequence(&FOUR_STEP_NTSC),
+      fiveStepSequence(&FIVE_STEP_NTSC), cpuHz(MASTER_SPEED_NTSC / 12.0),
+      blip(), ring(RING_SAMPLES), samples() {
+    pulse1.onesComplement = true;
+    noise.period = NOISE_PERIODS_NTSC[0];
+    setSampleRate(DEFAULT_SAMPLE_RATE);
+    schedule();
+}
+
+void APU::setRegion(NESRegion region) {
+    if (region == NESRegion::None) {
+        return;
+    }
+    const bool pal = region == NESRegion::PAL;
+    noisePeriods = pal ? &NOISE_PERIODS_PAL : &NOISE_PERIODS_NTSC;
+    dmcPeriods = pal ? &DMC_PERIODS_PAL : &DMC_PERIODS_NTSC;
+    fourStepSequence = pal ? &FOUR_STEP_PAL : &FOUR_STEP_NTSC;
+    fiveStepSequence = pal ? &FIVE_STEP_PAL : &FIVE_STEP_NTSC;
+    cpuHz = region == NESRegion::PAL     ? MASTER_SPEED_PAL / 16.0
+            : region == NESRegion::Dendy ? MASTER_SPEED_PAL / 15.0
+                                         : MASTER_SPEED_NTSC / 12.0;
+    setSampleRate(sampleRate);
+    schedule();
+}
+
+void APU::setSampleRate(double rate) {
+    sampleRate = rate;
+    blip.setRates(cpuHz, sampleRate, MAX_FRAME_CYCLES);
+    blip.setRateRatio(rateRatio);
+    time = 0;
+    mutedAt = 0;
+    // start from the current level, the triangle idles at 15 rather than 0
+    pulseIndex = static_cast<uint8_t>(pulse1.output() + pulse2.output());
+    tndIndex = static_cast<uint8_t>(3 * triangle.output() + 2 * noise.output() +
+                                    dmc.output());
+}
+
+/**
+ * Runs the cycles counted by clock(), stopping at each event on the way.
+ */
+void APU::catchUp() {
+    uint32_t remaining = pendingCycles;
+    pendingCycles = 0;
+    while (remaining > 0) {
+        const uint32_t span = std::min(remaining, cyclesToEvent);
+        run(span);
+        remaining -= span;
+        handleEvents();
+    }
+}
+
+void APU::run(uint32_t cycles) {
+    if (audioOutput) {
+        updateOutput(); // register writes and frame counter steps
+        runPulses(cycles);
+        runTND(cycles);
+    } else {
+        pulse1.run(cycles);
+        pulse2.run(cycles);
+        triangle.run(cycles);
+        noise.run(cycles);
+        dmc.run(cycles);
+    }
+    cycle += cycles;
+    time += cycles;
+    frameCycle += static_cast<int32_t>(cycles);
+    cyclesToEvent -= cycles;
+    if (audioOutput && time >= AUTO_FLUSH_CYCLES) {
+        flushSamples();
+    }
+}
+
+/**
+ * Adds steps for mixer inputs that changed since they were last added.
+ */
+void APU::updateOutput() {
+    const auto pulse = static_cast<uint8_t>(pulse1.output() + pulse2.output());
+    if (pulse != pulseIndex) {
+        blip.addDelta(time, PULSE_TABLE[pulse] - PULSE_TABLE[pulseIndex]);
+        pulseIndex = pulse;
+    }
+    const auto tnd = static_cast<uint8_t>(3 * triangle.output() +
+                                          2 * noise.output() + dmc.output());
+    if (tnd != tndIndex) {
+        blip.addDelta(time, TND_TABLE[tnd] - TND_TABLE[tndIndex]);
+        tndIndex = tnd;
+    }
+}
+
+// Each group advances its channels to the next timer expiry of an active
+// channel at a time, adding a step whenever the group's mixer input changes.
+void APU::runPulses(uint32_t cycles) {
+    uint32_t t = time;
+    const uint32_t end = time + cycles;
+    while (true) {
+        uint32_t span = end - t;
+        if (pulse1.active()) {
+            span = std::min(span, pulse1.timer);
+        }
+        if (pulse2.active()) {
+            span = std::min(span, pulse2.timer);
+        }
+        pulse1.run(span);
+        pulse2.run(span);
+        t += span;
+        if (t == end) {
+            return; // a change at end is added by the next updateOutput()
+        }
+        const auto pulse =
+            static_cast<uint8_t>(pulse1.output() + pulse2.output());
+        if (pulse != pulseIndex) {
+            blip.addDelta(t, PULSE_TABLE[pulse] - PULSE_TABLE[pulseIndex]);
+            pulseIndex = pulse;
+        }
+    }
+}
+
+void APU::runTND(uint32_t cycles) {
+    uint32_t t = time;
+    const uint32_t end = time + cycles;
+    while (true) {
+        uint32_t span = end - t;
+        if (triangle.active()) {
+            span = std::min(span, triangle.timer);
+        }
+        if (noise.active()) {
+            span = std::min(span, noise.timer);
+        }
+        if (dmc.active()) {
+            span = std::min(span, dmc.timer);
+        }
+        triangle.run(span);
+        noise.run(span);
+        dmc.run(span);
+        t += span;
+        if (t == end) {
+            return;
+        }
+        const auto tnd = static_cast<uint8_t>(
+            3 * triangle.output() + 2 * noise.output() + dmc.output());
+        if (tnd != tndIndex) {
+            blip.addDelta(t, TND_TABLE[tnd] - TND_TABLE[tndIndex]);
+            tndIndex = tnd;
+        }
+    }
+}
+
+/**
+ * Handles the frame counter steps and DMC fetch due at the current cycle,
+ * then schedules the next event.
+ */
+void APU::handleEvents() {
+    while (frameCycle >= sequence()[frameStep].cycle) {
+        const FrameCounterStep step = sequence()[frameStep];
+        if (step.events & WRAP) {
+            frameCycle -= step.cycle;
+            frameStep = 0;
+        } else {
+            frameStep++;
+        }
+        stepFrameCounter(step.events);
+    }
+    if (dmc.needsFetch()) {
+        fetchSample();
+    }
+    schedule();
+}
+
+void APU::schedule() {
+    uint32_t next =
+        static_cast<uint32_t>(sequence()[frameStep].cycle - frameCycle);
+    if (dmc.bufferFull && dmc.bytesRemaining > 0) {
+        next = std::min(next, dmc.cyclesUntilBufferEmpty());
+    }
+    cyclesToEvent = next;
+}
+
+void APU::stepFrameCounter(uint8_t events) {
+    if (events & QUARTER) {
+        clockQuarterFrame();
+    }
+    if (events & HALF) {
+        clockHalfFrame();
+    }
+    if ((events & IRQ) && !irqInhibit) {
+        frameIRQ = true;
+    }
+}
+
+void APU::clockQuarterFrame() {
+    pulse1.envelope.clock();
+    pulse2.envelope.clock();
+    noise.envelope.clock();
+    triangle.clockLinear();
+}
+
+void APU::clockHalfFrame() {
+    pulse1.clockLength();
+    pulse1.clockSweep();
+    pulse2.clockLength();
+    pulse2.clockSweep();
+    triangle.clockLength();
+    noise.clockLength();
+}
+
+/**
+ * DMC DMA: reads the next sample byte and stalls the CPU while doing so.
+ */
+void APU::fetchSample() {
+    dmc.fill(cart.read_prg_rom(dmc.address));
+    stallCycles += DMC_STALL_CYCLES;
+}
+
+void APU::flushSamples() {
+    blip.endFrame(time);
+    blip.setRateRatio(rateRatio);
+    time = 0;
+    samples.resize(blip.samplesAvailable());
+    blip.readSamples(samples.data(), samples.size());
+    ring.push(samples.data(), samples.size());
+}
+
+void APU::endFrame() {
+    catchUp();
+    if (audioOutput) {
+        flushSamples();
+    }
+}
+
+void APU::setAudioOutput(bool enabled) {
+    if (enabled == audioOutput) {
+        return;
+    }
+    catchUp();
+    if (enabled) {
+        time = mutedAt;
+    } else {
+        mutedAt = time;
+    }
+    audioOutput = enabled;
+}
+
+/**
+ * $4015 read: IF-D NT21, DMC and frame IRQ flags and which channels are
+ * still playing. Acknowledges the frame IRQ.
+ */
+uint8_t APU::readStatus() {
+    catchUp();
+    uint8_t status = 0;
+    status |= pulse1.length > 0 ? 0x01 : 0;
+    status |= pulse2.length > 0 ? 0x02 : 0;
+    status |= triangle.length > 0 ? 0x04 : 0;
+    status |= noise.length > 0 ? 0x08 : 0;
+    status |= dmc.bytesRemaining > 0 ? 0x10 : 0;
+    status |= frameIRQ ? 0x40 : 0;
+    status |= dmc.irq ? 0x80 : 0;
+    frameIRQ = false;
+    return status;
+}
+
+void APU::writeRegister(uint16_t addr, uint8_t value) {
+    catchUp();
+    if (addr <= 0x4003) {
+        pulse1.write(addr, value);
+    } else if (addr <= 0x4007) {
+        pulse2.write(addr, value);
+    } else if (addr <= 0x400B) {
+        triangle.write(addr, value);
+    } else if (addr <= 0x400F) {
+        noise.write(addr, value, *noisePeriods);
+    } else if (addr <= 0x4013) {
+        dmc.write(addr, value, *dmcPeriods);
+    } else if (addr == 0x4015) {
+        // ---D NT21, disabling a channel clears its length counter
+        pulse1.enabled = (value & 0x01) != 0;
+        pulse2.enabled = (value & 0x02) != 0;
+        triangle.enabled = (value & 0x04) != 0;
+        noise.enabled = (value & 0x08) != 0;
+        pulse1.length = pulse1.enabled ? pulse1.length : 0;
+        pulse2.length = pulse2.enabled ? pulse2.length : 0;
+        triangle.length = triangle.enabled ? triangle.length : 0;
+        noise.length = noise.enabled ? noise.length : 0;
+        if (!(value & 0x10)) {
+            dmc.bytesRemaining = 0;
+        } else if (dmc.bytesRemaining == 0) {
+            dmc.restart();
+        }
+        dmc.irq = false;
+    } else if (addr == 0x4017) {
+        // MI-- ----, the sequencer restarts 3 or 4 cycles after the write
+        // depending on its alignment with the APU clock
+        fiveStep = (value & 0x80) != 0;
+        irqInhibit = (value & 0x40) != 0;
+        if (irqInhibit) {
+            frameIRQ = false;
+        }
+        frameCycle = (cycle & 1) ? -4 : -3;
+        frameStep = 0;
+        if (fiveStep) {
+            clockQuarterFrame();
+            clockHalfFrame();
+        }
+    }
+    handleEvents();
+}
+
+void APU::saveState(StateWriter &out) {
+    catchUp();
+    saveChannel(out, pulse1);
+    saveChannel(out, pulse2);
+    saveChannel(out, triangle);
+    saveChannel(out, noise);
+    saveChannel(out, dmc);
+    out.write(fiveStep);
+    out.write(irqInhibit);
+    out.write(frameIRQ);
+    out.write(frameCycle);
+    out.write(frameStep);
+    out.write(cycle);
+    out.write(stallCycles);
+}
+
+void APU::loadState(StateReader &in) {
+    loadChannel(in, pulse1);
+    loadChannel(in, pulse2);
+    loadChannel(in, triangle);
+    loadChannel(in, noise);
+    loadChannel(in, dmc);
+    in.read(fiveStep);
+    in.read(irqInhibit);
+    in.read(frameIRQ);
+    in.read(frameCycle);
+    in.read(frameStep);
+    in.read(cycle);
+    pendingCycles = 0;
+    in.read(stallCycles);
+    schedule();
+}
@@ -0,0 +1,51 @@
+#include "../../include/APU/AudioDevice.h"
+
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+AudioDevice::AudioDevice(AudioRing &ring, int sampleRate)
+    : ring(ring), buffer(4096) {
+    if (!SDL_InitSubSystem(SDL_INIT_AUDIO)) {
+        throw std::runtime_error(std::string("SDL audio init Error: ") +
+                                 SDL_GetError());
+    }
+    SDL_AudioSpec spec{};
+    spec.format = SDL_AUDIO_S16;
+    spec.channels = 1;
+    spec.freq = sampleRate;
+    stream = SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK,
+                                       &spec, &AudioDevice::feed, this);
+    if (!stream) {
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        throw std::runtime_error(
+            std::string("SDL_OpenAudioDeviceStream Error: ") + SDL_GetError());
+    }
+    SDL_ResumeAudioStreamDevice(stream);
+}
+
+AudioDevice::~AudioDevice() {
+    SDL_DestroyAudioStream(stream); // stops the callback first
+    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+}
+
+// runs on SDL's audio thread
+void AudioDevice::feed(void *userdata, SDL_AudioStream *stream,
+                       int additionalAmount, int /* totalAmount */) {
+    auto &device = *static_cast<AudioDevice *>(userdata);
+    std::size_t wanted = static_cast<std::size_t>(additionalAmount) /
+                         sizeof(int16_t);
+    while (wanted > 0) {
+        const std::size_t count = std::min(wanted, device.buffer.size());
+        const std::size_t popped = device.ring.pop(device.buffer.data(), count);
+        if (popped > 0) {
+            device.lastSample = device.buffer[popped - 1];
+        }
+        std::fill(device.buffer.begin() + popped,
+                  device.buffer.begin() + count, device.lastSample);
+        SDL_PutAudioStreamData(stream, device.buffer.data(),
+                               static_cast<int>(count * sizeof(int16_t)));
+        wanted -= count;
+    }
+}
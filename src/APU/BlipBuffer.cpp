@@ -0,0 +1,92 @@
+#include "../../include/APU/BlipBuffer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace {
+
+// cutoff of the kernel as a fraction of the output Nyquist frequency
+constexpr double CUTOFF = 0.9;
+
+// the DC blocker's corner, well below anything the APU can play
+constexpr double HIGH_PASS_HZ = 20.0;
+
+} // namespace
+
+BlipBuffer::BlipBuffer() {
+    // Impulse response of a low-pass filter, sampled at each of PHASES
+    // fractional offsets and normalised so that every phase sums to 1,
+    // which makes the integrated steps exact.
+    const double half = TAPS / 2.0;
+    for (int phase = 0; phase < PHASES; phase++) {
+        double sum = 0.0;
+        std::array<double, TAPS> taps{};
+        for (int i = 0; i < TAPS; i++) {
+            const double x =
+                i - (half - 1.0) - static_cast<double>(phase) / PHASES;
+            const double angle = std::numbers::pi * CUTOFF * x;
+            const double sinc = x == 0.0 ? 1.0 : std::sin(angle) / angle;
+            const double w = std::numbers::pi * x / half;
+            const double blackman =
+                0.42 + 0.5 * std::cos(w) + 0.08 * std::cos(2.0 * w);
+            taps[i] = std::abs(x) < half ? sinc * blackman : 0.0;
+            sum += taps[i];
+        }
+        for (int i = 0; i < TAPS; i++) {
+            kernel[phase][i] = static_cast<float>(taps[i] / sum);
+        }
+    }
+}
+
+void BlipBuffer::setRates(double clockRate, double sampleRate,
+                          uint32_t maxFrameClocks) {
+    baseFactor = sampleRate / clockRate;
+    setRateRatio(1.0);
+    capacity = static_cast<std::size_t>(std::ceil(
+                   maxFrameClocks * baseFactor * MAX_RATE_RATIO)) +
+               1;
+    impulses.assign(capacity + TAPS, 0.0f);
+    highPassCoefficient = static_cast<float>(
+        1.0 - std::exp(-2.0 * std::numbers::pi * HIGH_PASS_HZ / sampleRate));
+    clear();
+}
+
+void BlipBuffer::setRateRatio(double ratio) {
+    ratio = std::clamp(ratio, 1.0 / MAX_RATE_RATIO, MAX_RATE_RATIO);
+    factor = static_cast<uint64_t>(
+        std::llround(baseFactor * ratio * std::ldexp(1.0, FRAC_BITS)));
+}
+
+void BlipBuffer::clear() {
+    std::fill(impulses.begin(), impulses.end(), 0.0f);
+    offset = 0;
+    available = 0;
+    integrator = 0.0f;
+    highPass = 0.0f;
+}
+
+void BlipBuffer::endFrame(uint32_t clocks) {
+    offset += clocks * factor;
+    available = static_cast<std::size_t>(offset >> FRAC_BITS);
+}
+
+std::size_t BlipBuffer::readSamples(int16_t *out, std::size_t count) {
+    count = std::min(count, available);
+    for (std::size_t i = 0; i < count; i++) {
+        integrator += impulses[i];
+        highPass += (integrator - highPass) * highPassCoefficient;
+        const float sample = (integrator - highPass) * 32767.0f;
+        out[i] = static_cast<int16_t>(std::clamp(sample, -32768.0f, 32767.0f));
+    }
+
+    // keep the impulses of samples that are not complete yet
+    const std::size_t used = available + TAPS;
+    std::copy(impulses.begin() + count, impulses.begin() + used,
+              impulses.begin());
+    std::fill(impulses.begin() + (used - count), impulses.begin() + used,
+              0.0f);
+    available -= count;
+    offset -= static_cast<uint64_t>(count) << FRAC_BITS;
+    return count;
+}
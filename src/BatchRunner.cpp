@@ -0,0 +1,157 @@
+#include "../include/BatchRunner.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+
+#include "../include/Hash.h"
+#include "../include/NES.h"
+
+using steady_clock = std::chrono::steady_clock;
+
+namespace {
+
+// jobs dealt to one thread; padded so threads do not share a cache line
+struct alignas(64) WorkQueue {
+    std::mutex mutex;
+    std::deque<std::size_t> jobs;
+
+    std::optional<std::size_t> takeFront() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (jobs.empty()) {
+            return std::nullopt;
+        }
+        const std::size_t job = jobs.front();
+        jobs.pop_front();
+        return job;
+    }
+
+    std::optional<std::size_t> takeBack() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (jobs.empty()) {
+            return std::nullopt;
+        }
+        const std::size_t job = jobs.back();
+        jobs.pop_back();
+        return job;
+    }
+};
+
+// xorshift64*, so a seed gives the same buttons on every platform
+uint8_t randomButtons(uint64_t &state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return static_cast<uint8_t>((state * 0x2545F4914F6CDD1DULL) >> 56);
+}
+
+} // namespace
+
+BatchRunner::BatchRunner(unsigned threads)
+    : threads(threads > 0 ? threads
+                          : std::max(1u, std::thread::hardware_concurrency())),
+      statistics() {}
+
+BatchResult BatchRunner::runJob(const BatchJob &job) {
+    BatchResult result;
+    const auto start = steady_clock::now();
+    try {
+        if (!job.rom) {
+            throw std::invalid_argument("Batch job has no ROM");
+        }
+        auto nes = std::make_unique<NES>(job.rom);
+        nes->log.mute();
+        nes->clock.setSyncMode(job.syncMode);
+        nes->apu.setAudioOutput(false); // nothing would play it
+
+        if (job.recordFrameHashes) {
+            result.frameHashes.reserve(job.frames);
+        }
+        const uint64_t startCycles = nes->cpu.getCycleCount();
+        uint64_t seed = job.inputSeed;
+        for (uint64_t frame = 0; frame < job.frames; frame++) {
+            uint8_t buttons = 0;
+            if (!job.inputMovie.empty()) {
+                buttons = frame < job.inputMovie.size() ? job.inputMovie[frame]
+                                                        : 0;
+            } else if (seed != 0) {
+                buttons = randomButtons(seed);
+            }
+            nes->bus.setJoypad1Buttons(buttons);
+
+            result.frameHash = nes->runFrame().hash();
+            result.frames++;
+            if (job.recordFrameHashes) {
+                result.frameHashes.push_back(result.frameHash);
+            }
+        }
+        result.cpuCycles = nes->cpu.getCycleCount() - startCycles;
+
+        result.ram = nes->bus.getCPURAM();
+        result.ramHash = fnv1a64(result.ram.data(), result.ram.size());
+    } catch (const std::exception &e) {
+        result.error = e.what();
+    }
+    result.elapsedSeconds =
+        std::chrono::duration<double>(steady_clock::now() - start).count();
+    return result;
+}
+
+std::vector<BatchResult> BatchRunner::run(const std::vector<BatchJob> &jobs) {
+    std::vector<BatchResult> results(jobs.size());
+    const auto workers = static_cast<unsigned>(
+        std::clamp<std::size_t>(jobs.size(), 1, threads));
+
+    std::vector<WorkQueue> queues(workers);
+    for (std::size_t i = 0; i < jobs.size(); i++) {
+        queues[i * workers / jobs.size()].jobs.push_back(i);
+    }
+
+    std::atomic<std::size_t> steals{0};
+    std::vector<double> busySeconds(workers, 0.0);
+    auto work = [&](unsigned self) {
+        for (;;) {
+            std::optional<std::size_t> job = queues[self].takeFront();
+            // jobs are never added, so once every queue is empty we are done
+            for (unsigned i = 1; !job && i < workers; i++) {
+                job = queues[(self + i) % workers].takeBack();
+                if (job) {
+                    steals.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            if (!job) {
+                return;
+            }
+            results[*job] = runJob(jobs[*job]);
+            busySeconds[self] += results[*job].elapsedSeconds;
+        }
+    };
+
+    const auto start = steady_clock::now();
+    std::vector<std::thread> helpers;
+    helpers.reserve(workers - 1);
+    for (unsigned i = 1; i < workers; i++) {
+        helpers.emplace_back(work, i);
+    }
+    work(0); // the calling thread is worker 0
+    for (std::thread &helper : helpers) {
+        helper.join();
+    }
+
+    statistics = BatchStats{};
+    statistics.threads = workers;
+    statistics.jobs = jobs.size();
+    statistics.steals = steals.load();
+    statistics.elapsedSeconds =
+        std::chrono::duration<double>(steady_clock::now() - start).count();
+    for (double busy : busySeconds) {
+        statistics.busySeconds += busy;
+    }
+    return results;
+}
@@ -1,11 +1,26 @@
 #include "../../include/CPU/CPU.h"
 
 #include <cstdint>
-#include <vector>
+#include <stdexcept>
+#include <type_traits>
+
+#include "../../include/SaveState.h"
+#include "../../include/TestBus.h"
 
 // https://github.com/SingleStepTests/65x02/tree/main/nes6502
 
 namespace {
+// reads an enum written by StateWriter, rejecting values past last
+template <typename Enum>
+Enum readEnum(StateReader& in, Enum last) {
+  using Underlying = std::underlying_type_t<Enum>;
+  const Underlying value = in.read<Underlying>();
+  if (value > static_cast<Underlying>(last)) {
+    throw std::runtime_error("Save state has an invalid CPU state");
+  }
+  return static_cast<Enum>(value);
+}
+
 inline bool isSideEffectReadAddress(uint16_t addr) {
   // PPU/APU/I/O reads can mutate internal device state. Avoid debug/log reads.
   return addr >= 0x2000 && addr <= 0x401F;
@@ -24,7 +39,8 @@ inline bool modeHasReadableOperand(AddressingMode mode) {
 }
 }  // namespace
 
-void CPU::tick() {
+template <typename BusType>
+void CPU<BusType>::tick() {
   cycleCount++;
   completedTakenBranchInLastTick = false;
 
@@ -57,8 +73,7 @@ void CPU::tick() {
       in_NMI_IRQ();
       return;
     }
-    if (pendingIRQ && !(status & FLAG_INTERRUPT)) {
-      pendingIRQ = false;
+    if (irqLine && !(status & FLAG_INTERRUPT)) {
       activeInterrupt = Interrupt::IRQ;
       in_NMI_IRQ();
       return;
@@ -68,11 +83,17 @@ void CPU::tick() {
   if (cyclesRemainingInCurrentInstr == 0) {
     // new instruction
     const bool traceEnabled = !logger.isMuted();
-    if (logState) {
+    if (tracePending) {
       if (traceEnabled) {
-        logger.log(*logState);  // log previous instruction
+        // operands and address of the previous instruction are final now
+        pendingTrace.opBytes = currentOpBytes;
+        pendingTrace.opByteCount = currentOpByteCount;
+        pendingTrace.address = currAddrResCtx.address;
+        pendingTrace.pointerAddress = currAddrResCtx.pointerAddress;
+        pendingTrace.valueAtAddr = currentValueAtAddress;
+        logger.log(pendingTrace);  // log previous instruction
       }
-      logState.reset();
+      tracePending = false;
     }
 
     // assumes pc has already been incremented past previous operand bytes
@@ -80,15 +101,20 @@ void CPU::tick() {
     currentOpCode = OpCode::getOpCode(opcode);
 
     // CAPTURE CPU STATE FOR LOGGING
-    // - pass references to currentOpBytes, currAddrResCtx, currentValueAtAddress
-    // - all other elements of logState are locked to their current state
-    // - call logger.log(logState) once currentOpBytes, currAddrResCtx, and
-    //   currentValueAtAddress have been computed
+    // - registers and timing are recorded as the instruction starts
+    // - operand bytes, address and value are filled in when it has finished,
+    //   at the start of the next instruction
     if (traceEnabled) {
-      logState = std::make_unique<CPUState>(
-          pc, *currentOpCode, currentOpBytes, currAddrResCtx,
-          currentValueAtAddress, a_register, x_register, y_register, status, sp,
-          bus.getPPUCycle(), bus.getPPUScanline(), cycleCount - 1);
+      pendingTrace.cycles = cycleCount - 1;
+      pendingTrace.pc = pc;
+      pendingTrace.ppuX = static_cast<uint16_t>(bus.getPPUCycle());
+      pendingTrace.ppuY = static_cast<uint16_t>(bus.getPPUScanline());
+      pendingTrace.A = a_register;
+      pendingTrace.X = x_register;
+      pendingTrace.Y = y_register;
+      pendingTrace.P = status;
+      pendingTrace.SP = sp;
+      tracePending = true;
     }
 
     // increment PC to point at first operand
@@ -98,8 +124,8 @@ void CPU::tick() {
     // reset values for new instruction
     currentHighByte = 0;
     branchTakenInCurrentInstr = false;
-    currentOpBytes.clear();
-    currentOpBytes.push_back(opcode);
+    currentOpBytes[0] = opcode;
+    currentOpByteCount = 1;
     currAddrResCtx.reset(currentOpCode->mode);
 
     // bus.read(pc) means this was a cycle, count cycle and return
@@ -135,7 +161,7 @@ void CPU::tick() {
   // execute instruction
   // std::cout << "absolute address = " <<
   // static_cast<int>(currAddrResCtx.address) << std::endl;
-  (this->*(currentOpCode->handler))(currAddrResCtx.address);
+  execute(currAddrResCtx.address);
 
   cyclesRemainingInCurrentInstr--;
   if (cyclesRemainingInCurrentInstr == 0) {
@@ -144,13 +170,123 @@ void CPU::tick() {
   return;
 }
 
+/**
+ * Saves registers and all mid-instruction/interrupt progress. The trace line
+ * of the current instruction (logged when the next one starts) is saved too,
+ * so a restored CPU produces the same trace.
+ */
+template <typename BusType>
+void CPU<BusType>::saveState(StateWriter& out) const {
+  out.write(a_register);
+  out.write(x_register);
+  out.write(y_register);
+  out.write(status);
+  out.write(pc);
+  out.write(sp);
+
+  out.write(currentOpCode != nullptr);
+  out.write(currentOpCode ? currentOpCode->code : uint8_t{0});
+  out.write(readBuffer);
+  out.write(currentOpBytes);
+  out.write(currentOpByteCount);
+  out.write(cyclesRemainingInCurrentInstr);
+  out.write(cyclesRemainingInCurrentInterrupt);
+  // field by field, the struct's padding bytes are indeterminate
+  out.write(currAddrResCtx.mode);
+  out.write(currAddrResCtx.state);
+  out.write(currAddrResCtx.address);
+  out.write(currAddrResCtx.pointerAddress);
+  out.write(currAddrResCtx.pointerUsed);
+  out.write(currAddrResCtx.waitPageCrossed);
+  out.write(currentValueAtAddress);
+
+  out.write(activeInterrupt);
+  out.write(pendingRES);
+  out.write(pendingNMI);
+  out.write(irqLine);
+  out.write(currentHighByte);
+  out.write(cycleCount);
+  out.write(branchTakenInCurrentInstr);
+  out.write(completedTakenBranchInLastTick);
+
+  out.write(tracePending);
+  if (tracePending) {
+    out.write(pendingTrace.pc);
+    out.write(pendingTrace.A);
+    out.write(pendingTrace.X);
+    out.write(pendingTrace.Y);
+    out.write(pendingTrace.P);
+    out.write(pendingTrace.SP);
+    out.write(pendingTrace.ppuX);
+    out.write(pendingTrace.ppuY);
+    out.write(pendingTrace.cycles);
+  }
+}
+
+template <typename BusType>
+void CPU<BusType>::loadState(StateReader& in) {
+  in.read(a_register);
+  in.read(x_register);
+  in.read(y_register);
+  in.read(status);
+  in.read(pc);
+  in.read(sp);
+
+  const bool hasOpCode = in.read<bool>();
+  const uint8_t opcode = in.read<uint8_t>();
+  currentOpCode = hasOpCode ? OpCode::getOpCode(opcode) : nullptr;
+  in.read(readBuffer);
+  in.read(currentOpBytes);
+  in.read(currentOpByteCount);
+  in.read(cyclesRemainingInCurrentInstr);
+  in.read(cyclesRemainingInCurrentInterrupt);
+  if (currentOpByteCount > currentOpBytes.size() ||
+      cyclesRemainingInCurrentInterrupt == 0 ||
+      cyclesRemainingInCurrentInterrupt > 7) {
+    throw std::runtime_error("Save state has an invalid CPU state");
+  }
+  currAddrResCtx.mode = readEnum(in, AddressingMode::IndirectY);
+  currAddrResCtx.state = readEnum(in, ResolutionState::Branch2);
+  in.read(currAddrResCtx.address);
+  in.read(currAddrResCtx.pointerAddress);
+  in.read(currAddrResCtx.pointerUsed);
+  in.read(currAddrResCtx.waitPageCrossed);
+  in.read(currentValueAtAddress);
+
+  activeInterrupt = readEnum(in, Interrupt::IRQ);
+  in.read(pendingRES);
+  in.read(pendingNMI);
+  in.read(irqLine);
+  in.read(currentHighByte);
+  in.read(cycleCount);
+  in.read(branchTakenInCurrentInstr);
+  in.read(completedTakenBranchInLastTick);
+
+  tracePending = in.read<bool>();
+  if (tracePending) {
+    in.read(pendingTrace.pc);
+    in.read(pendingTrace.A);
+    in.read(pendingTrace.X);
+    in.read(pendingTrace.Y);
+    in.read(pendingTrace.P);
+    in.read(pendingTrace.SP);
+    in.read(pendingTrace.ppuX);
+    in.read(pendingTrace.ppuY);
+    in.read(pendingTrace.cycles);
+    if (currentOpCode == nullptr) {
+      throw std::runtime_error("Save state has a trace line but no opcode");
+    }
+  }
+}
+
 /**
  * Function to return the address of the operand given the addressing mode.
  *
  * @param mode The addressing mode specified by the opcode
  * @return A 16-bit memory address
  */
-void CPU::computeAbsoluteAddress() {
+template <typename BusType>
+void CPU<BusType>::computeAbsoluteAddress() {
   switch (currentOpCode->mode) {
     case AddressingMode::Implied:
     case AddressingMode::Acc: {
@@ -434,7 +570,7 @@ void CPU::computeAbsoluteAddress() {
       throw std::runtime_error("Addressing mode not supported");
     }
   }
-  if (logState && currAddrResCtx.state == ResolutionState::Done &&
+  if (tracePending && currAddrResCtx.state == ResolutionState::Done &&
       modeHasReadableOperand(currentOpCode->mode)) {
     if (isSideEffectReadAddress(currAddrResCtx.address)) {
       currentValueAtAddress = bus.peek(currAddrResCtx.address);
@@ -457,7 +593,8 @@ void CPU::computeAbsoluteAddress() {
  *R  fetch PCL (A = FFFE for IRQ, A = FFFA for NMI), set I flag 7   A       R
  *fetch PCH (A = FFFF for IRQ, A = FFFB for NMI)
  */
-void CPU::in_NMI_IRQ() {
+template <typename BusType>
+void CPU<BusType>::in_NMI_IRQ() {
   cyclesRemainingInCurrentInterrupt--;
   switch (cyclesRemainingInCurrentInterrupt) {
     case 6: {
@@ -497,7 +634,8 @@ void CPU::in_NMI_IRQ() {
   }
 }
 
-void CPU::in_RES() {
+template <typename BusType>
+void CPU<BusType>::in_RES() {
   cyclesRemainingInCurrentInterrupt--;
   switch (cyclesRemainingInCurrentInterrupt) {
     case 6:
@@ -538,7 +676,8 @@ void CPU::in_RES() {
  * @param result Zero flag is set if result is 0, negative flag is set if
  * MSB of result is 1.
  */
-void CPU::updateZeroAndNegativeFlags(uint8_t result) {
+template <typename BusType>
+void CPU<BusType>::updateZeroAndNegativeFlags(uint8_t result) {
   // zero flag is bit 1
   if (result == 0) {
     status |= FLAG_ZERO;  // set zero flag if result is 0
@@ -554,7 +693,8 @@ void CPU::updateZeroAndNegativeFlags(uint8_t result) {
   }
 }
 
-void CPU::branch() {
+template <typename BusType>
+void CPU<BusType>::branch() {
   switch (currAddrResCtx.state) {
     case ResolutionState::Branch1: {
       // already readOperand();
@@ -585,7 +725,8 @@ void CPU::branch() {
   }
 }
 
-void CPU::op_ADC(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::op_ADC(uint16_t addr) {
   if (cyclesRemainingInCurrentInstr >= 2) {
     return;
   } else {
@@ -593,7 +734,8 @@ void CPU::op_ADC(uint16_t addr) {
     // all processing of adc_core is done in the same cycle as this read
   }
 }
-void CPU::op_ADC_CORE(uint8_t operand) {
+template <typename BusType>
+void CPU<BusType>::op_ADC_CORE(uint8_t operand) {
   // allows SBC to use ADC logic
   uint8_t carry = (status & 0x01);  // extract carry flag from status register
   uint16_t result = a_register + operand + carry;  // compute result
@@ -619,11 +761,13 @@ void CPU::op_ADC_CORE(uint8_t operand) {
 
   updateZeroAndNegativeFlags(a_register);
 }
-void CPU::op_AND(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::op_AND(uint16_t addr) {
   a_register &= bus.read(addr);
   updateZeroAndNegativeFlags(a_register);
 }
-void CPU::op_ASL(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::op_ASL(uint16_t addr) {
   switch (cyclesRemainingInCurrentInstr) {
     case 3:
       readBuffer = bus.read(addr);
@@ -639,13 +783,15 @@ void CPU::op_ASL(uint16_t addr) {
       break;
   }
 }
-void CPU::op_ASL_ACC(uint16_t /* implied */) {
+template <typename BusType>
+void CPU<BusType>::op_ASL_ACC(uint16_t /* implied */) {
   // store bit 7 before shift in carry flag
   status = (status & ~FLAG_CARRY) | ((a_register & 0x80) ? 0x01 : 0);
   a_register <<= 1;  // shift accumulator left
   updateZeroAndNegativeFlags(a_register);
 }
-void CPU::op_BCC(uint16_t /* calculated iff branch taken */) {
+template <typename BusType>
+void CPU<BusType>::op_BCC(uint16_t /* calculated iff branch taken */) {
   if (!(status & FLAG_CARRY)) {
     branch();  // branch if carry flag clear
   } else {
@@ -663,7 +809,8 @@ void CPU::op_BCC(uint16_t /* calculated iff branch taken */) {
     cyclesRemainingInCurrentInstr = 1;
   }
 }
-void CPU::op_BCS(uint16_t /* calculated iff branch taken */) {
+template <typename BusType>
+void CPU<BusType>::op_BCS(uint16_t /* calculated iff branch taken */) {
   if (status & FLAG_CARRY) {
     branch();  // branch if carry flag set
   } else {
@@ -676,7 +823,8 @@ void CPU::op_BCS(uint16_t /* calculated iff branch taken */) {
     cyclesRemainingInCurrentInstr = 1;
   }
 }
-void CPU::op_BEQ(uint16_t /* calculated iff branch taken */) {
+template <typename BusType>
+void CPU<BusType>::op_BEQ(uint16_t /* calculated iff branch taken */) {
   if (status & FLAG_ZERO) {
     branch();  // branch if zero flag is set
   } else {
@@ -689,7 +837,8 @@ void CPU::op_BEQ(uint16_t /* calculated iff branch taken */) {
     cyclesRemainingInCurrentInstr = 1;
   }
 }
-void CPU::op_BIT(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::op_BIT(uint16_t addr) {
   // - bits 7 and 6 of operand are transfered to bit 7 and 6 of SR (N,V);
   // - the zero-flag is set according to the result of the operand AND the
   // - accumulator (set, if the result is zero, unset otherwise).
@@ -700,7 +849,8 @@ void CPU::op_BIT(uint16_t addr) {
     status |= FLAG_ZERO;
   }
 }
-void CPU::op_BMI(uint16_t /* calculated iff branch taken */) {
+template <typename BusType>
+void CPU<BusType>::op_BMI(uint16_t /* calculated iff branch taken */) {
   if (status & FLAG_NEGATIVE) {
     branch();  // branch if negative flag is set
   } else {
@@ -713,7 +863,8 @@ void CPU::op_BMI(uint16_t /* calculated iff branch taken */) {
     cyclesRemainingInCurrentInstr = 1;
   }
 }
-void CPU::op_BNE(uint16_t /* calculated iff branch taken */) {
+template <typename BusType>
+void CPU<BusType>::op_BNE(uint16_t /* calculated iff branch taken */) {
   if (!(status & FLAG_ZERO)) {
     branch();  // branch if zero flag is clear
   } else {
@@ -726,7 +877,8 @@ void CPU::op_BNE(uint16_t /* calculated iff branch taken */) {
     cyclesRemainingInCurrentInstr = 1;
   }
 }
-void CPU::op_BPL(uint16_t /* calculated iff branch taken */) {
+template <typename BusType>
+void CPU<BusType>::op_BPL(uint16_t /* calculated iff branch taken */) {
   if (!(status & FLAG_NEGATIVE)) {
     branch();  // branch if negative flag is clear
   } else {
@@ -752,7 +904,8 @@ void CPU::op_BPL(uint16_t /* calculated iff branch taken */) {
  *  6   $FFFE   R  fetch PCL, set I flag
  *  7   $FFFF   R  fetch PCH
  */
-void CPU::op_BRK(uint16_t /* implied */) {
+template <typename BusType>
+void CPU<BusType>::op_BRK(uint16_t /* implied */) {
   // cycle 1 already completed by tick function
   switch (cyclesRemainingInCurrentInstr) {
     case 6:
@@ -780,7 +933,8 @@ void CPU::op_BRK(uint16_t /* implied */) {
       break;
   }
 }
-void CPU::op_BVC(uint16_t /* calculated iff branch taken */) {
+template <typename BusType>
+void CPU<BusType>::op_BVC(uint16_t /* calculated iff branch taken */) {
   if (!(status & FLAG_OVERFLOW)) {
     branch();  // branch if overflow flag is clear
   } else {
@@ -793,7 +947,8 @@ void CPU::op_BVC(uint16_t /* calculated iff branch taken */) {
     cyclesRemainingInCurrentInstr = 1;
   }
 }
-void CPU::op_BVS(uint16_t /* calculated iff branch taken */) {
+template <typename BusType>
+void CPU<BusType>::op_BVS(uint16_t /* calculated iff branch taken */) {
   if (status & FLAG_OVERFLOW) {
     branch();  // branch if overflow flag is set
   } else {
@@ -806,11 +961,16 @@ void CPU::op_BVS(uint16_t /* calculated iff branch taken */) {
     cyclesRemainingInCurrentInstr = 1;
   }
 }
-void CPU::op_CLC(uint16_t /* implied */) { status &= ~FLAG_CARRY; }
-void CPU::op_CLD(uint16_t /* implied */) { status &= ~FLAG_DECIMAL; }
-void CPU::op_CLI(uint16_t /* implied */) { status &= ~FLAG_INTERRUPT; }
-void CPU::op_CLV(uint16_t /* implied */) { status &= ~FLAG_OVERFLOW; }
-void CPU::op_CMP(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::op_CLC(uint16_t /* implied */) { status &= ~FLAG_CARRY; }
+template <typename BusType>
+void CPU<BusType>::op_CLD(uint16_t /* implied */) { status &= ~FLAG_DECIMAL; }
+template <typename BusType>
+void CPU<BusType>::op_CLI(uint16_t /* implied */) { status &= ~FLAG_INTERRUPT; }
+template <typename BusType>
+void CPU<BusType>::op_CLV(uint16_t /* implied */) { status &= ~FLAG_OVERFLOW; }
+template <typename BusType>
+void CPU<BusType>::op_CMP(uint16_t addr) {
   // C set if A >= M
   // Z set if A == M
   // N set if A < M
@@ -823,7 +983,8 @@ void CPU::op_CMP(uint16_t addr) {
   if (a_register >= readBuffer) status |= FLAG_CARRY;  // set carry if Y >= M
   if (result & 0x80) status |= FLAG_NEGATIVE;  // set neg if result is negative
 }
-void CPU::op_CPX(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::op_CPX(uint16_t addr) {
   // C set if X >= M
   // Z set if X == M
   // N set if X < M
@@ -836,7 +997,8 @@ void CPU::op_CPX(uint16_t addr) {
   if (x_register >= readBuffer) status |= FLAG_CARRY;  // set carry if Y >= M
   if (result & 0x80) status |= FLAG_NEGATIVE;  // set neg if result is negative
 }
-void CPU::op_CPY(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::op_CPY(uint16_t addr) {
   // C set if Y >= M
   // Z set if Y == M
   // N set if Y < M
@@ -849,7 +1011,8 @@ void CPU::op_CPY(uint16_t addr) {
   if (y_register >= readBuffer) status |= FLAG_CARRY;  // set carry if Y >= M
   if (result & 0x80) status |= FLAG_NEGATIVE;  // set neg if result is negative
 }
-void CPU::op_DEC(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::op_DEC(uint16_t addr) {
   switch (cyclesRemainingInCurrentInstr) {
     case 3:
       readBuffer = bus.read(addr);
@@ -864,19 +1027,23 @@ void CPU::op_DEC(uint16_t addr) {
       break;
   }
 }
-void CPU::op_DEX(uint16_t /* implied */) {
+template <typename BusType>
+void CPU<BusType>::op_DEX(uint16_t /* implied */) {
   x_register--;
   updateZeroAndNegativeFlags(x_register);
 }
-void CPU::op_DEY(uint16_t /* implied */) {
+template <typename BusType>
+void CPU<BusType>::op_DEY(uint16_t /* implied */) {
   y_register--;
   updateZeroAndNegativeFlags(y_register);
 }
-void CPU::op_EOR(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::op_EOR(uint16_t addr) {
   a_register ^= bus.read(addr);
   updateZeroAndNegativeFlags(a_register);
 }
-void CPU::op_INC(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::op_INC(uint16_t addr) {
   switch (cyclesRemainingInCurrentInstr) {
     case 3:
       readBuffer = bus.read(addr);
@@ -890,16 +1057,20 @@ void CPU::op_INC(uint16_t addr) {
       break;
   }
 }
-void CPU::op_INX(uint16_t /* implied */) {
+template <typename BusType>
+void CPU<BusType>::op_INX(uint16_t /* implied */) {
   x_register++;
   updateZeroAndNegativeFlags(x_register);
 }
-void CPU::op_INY(uint16_t /* implied */) {
+template <typename BusType>
+void CPU<BusType>::op_INY(uint16_t /* implied */) {
   y_register++;
   updateZeroAndNegativeFlags(y_register);
 }
-void CPU::op_JMP(uint16_t addr) { pc = addr; }
-void CPU::op_JSR(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::op_JMP(uint16_t addr) { pc = addr; }
+template <typename BusType>
+void CPU<BusType>::op_JSR(uint16_t addr) {
   switch (cyclesRemainingInCurrentInstr) {
     case 3:
       pc--;  // pc - 1 = the address minus one of the next instruction
@@ -911,20 +1082,24 @@ void CPU::op_JSR(uint16_t addr) {
       pc = addr;  // error point: no idea why this requires an extra cycle
   }
 }
-void CPU::op_LDA(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::op_LDA(uint16_t addr) {
   a_register = bus.read(addr);
   updateZeroAndNegativeFlags(a_register);
 }
-void CPU::op_LDX(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::op_LDX(uint16_t addr) {
   x_register = bus.read(addr);
   ;
   updateZeroAndNegativeFlags(x_register);
 }
-void CPU::op_LDY(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::op_LDY(uint16_t addr) {
   y_register = bus.read(addr);
   updateZeroAndNegativeFlags(y_register);
 }
-void CPU::op_LSR(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::op_LSR(uint16_t addr) {
   switch (cyclesRemainingInCurrentInstr) {
     case 3:
       readBuffer = bus.read(addr);
@@ -941,30 +1116,36 @@ void CPU::op_LSR(uint16_t addr) {
       break;
   }
 }
-void CPU::op_LSR_ACC(uint16_t /* implied */) {
+template <typename BusType>
+void CPU<BusType>::op_LSR_ACC(uint16_t /* implied */) {
   // store bit 0 before shift in carry flag
   status = (status & ~FLAG_CARRY) | ((a_register & 0x01) ? FLAG_CARRY : 0);
   a_register >>= 1;  // shift A register right
   updateZeroAndNegativeFlags(a_register);
 }
-void CPU::op_NOP(uint16_t /* implied */) { return; }
-void CPU::op_ORA(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::op_NOP(uint16_t /* implied */) { return; }
+template <typename BusType>
+void CPU<BusType>::op_ORA(uint16_t addr) {
   a_register |= bus.read(addr);
   updateZeroAndNegativeFlags(a_register);
 }
-void CPU::op_PHA(uint16_t /* implied */) {
+template <typename BusType>
+void CPU<BusType>::op_PHA(uint16_t /* implied */) {
   if (cyclesRemainingInCurrentInstr == 2)
     return;  // dummy read to pc happens here
   else
     push(a_register);
 }
-void CPU::op_PHP(uint16_t /* implied */) {
+template <typename BusType>
+void CPU<BusType>::op_PHP(uint16_t /* implied */) {
   if (cyclesRemainingInCurrentInstr == 2)
     return;  // dummy read to pc happens here
   else
     push(status | FLAG_BREAK | FLAG_CONSTANT);
 }
-void CPU::op_PLA(uint16_t /* implied */) {
+template <typename BusType>
+void CPU<BusType>::op_PLA(uint16_t /* implied */) {
   switch (cyclesRemainingInCurrentInstr) {
     case 3:
       // dummy read to pc
@@ -977,7 +1158,8 @@ void CPU::op_PLA(uint16_t /* implied */) {
       updateZeroAndNegativeFlags(a_register);
   }
 }
-void CPU::op_PLP(uint16_t /* implied */) {
+template <typename BusType>
+void CPU<BusType>::op_PLP(uint16_t /* implied */) {
   // act: 00101000
   // exp: 10101000
   // pul: 10001000
@@ -993,7 +1175,8 @@ void CPU::op_PLP(uint16_t /* implied */) {
       break;
   }
 }
-void CPU::op_ROL(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::op_ROL(uint16_t addr) {
   switch (cyclesRemainingInCurrentInstr) {
     case 3: {
       readBuffer = bus.read(addr);
@@ -1017,7 +1200,8 @@ void CPU::op_ROL(uint16_t addr) {
     }
   }
 }
-void CPU::op_ROL_ACC(uint16_t /* implied */) {
+template <typename BusType>
+void CPU<BusType>::op_ROL_ACC(uint16_t /* implied */) {
   // shift accumulator left and set LSB to carry bit
   uint8_t result = (a_register << 1) | (status & FLAG_CARRY ? 1 : 0);
 
@@ -1030,7 +1214,8 @@ void CPU::op_ROL_ACC(uint16_t /* implied */) {
   a_register = result;
   updateZeroAndNegativeFlags(a_register);
 }
-void CPU::op_ROR(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::op_ROR(uint16_t addr) {
   switch (cyclesRemainingInCurrentInstr) {
     case 3: {
       readBuffer = bus.read(addr);
@@ -1054,7 +1239,8 @@ void CPU::op_ROR(uint16_t addr) {
     }
   }
 }
-void CPU::op_ROR_ACC(uint16_t /* implied */) {
+template <typename BusType>
+void CPU<BusType>::op_ROR_ACC(uint16_t /* implied */) {
   // shift accumulator right and set MSB to carry bit
   uint8_t result = (a_register >> 1) | (status & FLAG_CARRY ? 0x80 : 0);
 
@@ -1067,7 +1253,8 @@ void CPU::op_ROR_ACC(uint16_t /* implied */) {
   a_register = result;
   updateZeroAndNegativeFlags(a_register);
 }
-void CPU::op_RTI(uint16_t /* implied */) {
+template <typename BusType>
+void CPU<BusType>::op_RTI(uint16_t /* implied */) {
   switch (cyclesRemainingInCurrentInstr) {
     case 5:
       activeInterrupt = Interrupt::NONE;
@@ -1088,7 +1275,8 @@ void CPU::op_RTI(uint16_t /* implied */) {
       break;
   }
 }
-void CPU::op_RTS(uint16_t /* implied */) {
+template <typename BusType>
+void CPU<BusType>::op_RTS(uint16_t /* implied */) {
   switch (cyclesRemainingInCurrentInstr) {
     case 5:
       // dummy read to operand
@@ -1108,7 +1296,8 @@ void CPU::op_RTS(uint16_t /* implied */) {
       break;
   }
 }
-void CPU::op_SBC(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::op_SBC(uint16_t addr) {
   // SBC:
   // A = A – M – (1 – C)
   //   = A + (~M) + C
@@ -1116,30 +1305,42 @@ void CPU::op_SBC(uint16_t addr) {
   // op_ADC_CORE is only one cycle so this is fine,
   // the read is not duplicated
 }
-void CPU::op_SEC(uint16_t /* implied */) { status |= FLAG_CARRY; }
-void CPU::op_SED(uint16_t /* implied */) { status |= FLAG_DECIMAL; }
-void CPU::op_SEI(uint16_t /* implied */) { status |= FLAG_INTERRUPT; }
-void CPU::op_STA(uint16_t addr) { bus.write(addr, a_register); }
-void CPU::op_STX(uint16_t addr) { bus.write(addr, x_register); }
-void CPU::op_STY(uint16_t addr) { bus.write(addr, y_register); }
-void CPU::op_TAX(uint16_t /* implied */) {
+template <typename BusType>
+void CPU<BusType>::op_SEC(uint16_t /* implied */) { status |= FLAG_CARRY; }
+template <typename BusType>
+void CPU<BusType>::op_SED(uint16_t /* implied */) { status |= FLAG_DECIMAL; }
+template <typename BusType>
+void CPU<BusType>::op_SEI(uint16_t /* implied */) { status |= FLAG_INTERRUPT; }
+template <typename BusType>
+void CPU<BusType>::op_STA(uint16_t addr) { bus.write(addr, a_register); }
+template <typename BusType>
+void CPU<BusType>::op_STX(uint16_t addr) { bus.write(addr, x_register); }
+template <typename BusType>
+void CPU<BusType>::op_STY(uint16_t addr) { bus.write(addr, y_register); }
+template <typename BusType>
+void CPU<BusType>::op_TAX(uint16_t /* implied */) {
   x_register = a_register;
   updateZeroAndNegativeFlags(x_register);
 }
-void CPU::op_TAY(uint16_t /* implied */) {
+template <typename BusType>
+void CPU<BusType>::op_TAY(uint16_t /* implied */) {
   y_register = a_register;
   updateZeroAndNegativeFlags(y_register);
 }
-void CPU::op_TSX(uint16_t /* implied */) {
+template <typename BusType>
+void CPU<BusType>::op_TSX(uint16_t /* implied */) {
   x_register = sp;
   updateZeroAndNegativeFlags(x_register);
 }
-void CPU::op_TXA(uint16_t /* implied */) {
+template <typename BusType>
+void CPU<BusType>::op_TXA(uint16_t /* implied */) {
   a_register = x_register;
   updateZeroAndNegativeFlags(a_register);
 }
-void CPU::op_TXS(uint16_t /* implied */) { sp = x_register; }
-void CPU::op_TYA(uint16_t /* implied */) {
+template <typename BusType>
+void CPU<BusType>::op_TXS(uint16_t /* implied */) { sp = x_register; }
+template <typename BusType>
+void CPU<BusType>::op_TYA(uint16_t /* implied */) {
   a_register = y_register;
   updateZeroAndNegativeFlags(a_register);
 }
@@ -1151,13 +1352,15 @@ void CPU::op_TYA(uint16_t /* implied */) {
 // http://www.ffd2.com/fridge/docs/6502-NMOS.extra.opcodes (descriptions)
 // https://www.oxyron.de/html/opcodes02.html (status register impact)
 
-void CPU::opi_ALR(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::opi_ALR(uint16_t addr) {
   /* ANDs the contents of the A register with an immediate value and then LSRs
    * the result. */
   op_AND(addr);
   op_LSR_ACC(0);  // implied addressing
 }
-void CPU::opi_ANC(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::opi_ANC(uint16_t addr) {
   /* ANC ANDs the contents of the A register with an immediate value and then
    * moves bit 7 of A into the Carry flag.  This opcode works basically
    * identically to AND #immed. except that the Carry flag is set to the
@@ -1170,14 +1373,16 @@ void CPU::opi_ANC(uint16_t addr) {
     status &= ~FLAG_CARRY;
   }
 }
-void CPU::opi_ANE(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::opi_ANE(uint16_t addr) {
   /* aka XAA: transfers the contents of the X register to the A register
   and
    * then ANDs the A register with an immediate value. Highly unstable. */
   op_TXA(0);
   op_AND(addr);
 }
-void CPU::opi_ARR(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::opi_ARR(uint16_t addr) {
   /* ANDs the contents of the A register with an immediate value and then
   RORs
    * the result. The carry flag is set to the value of bit 6 of the result.
@@ -1199,20 +1404,23 @@ void CPU::opi_ARR(uint16_t addr) {
     status &= ~FLAG_OVERFLOW;
   }
 }
-void CPU::opi_DCP(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::opi_DCP(uint16_t addr) {
   /* aka DCM: DECs the contents of a memory location and then CMPs the result
    * with the A register. */
   op_DEC(addr);
   if (cyclesRemainingInCurrentInstr == 1) op_CMP(addr);
 }
-void CPU::opi_ISC(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::opi_ISC(uint16_t addr) {
   /* aka INS: INCs the contents of a memory location and then SBCs the
   result
    * from the A register.*/
   op_INC(addr);
   if (cyclesRemainingInCurrentInstr == 1) op_SBC(addr);
 }
-void CPU::opi_LAS(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::opi_LAS(uint16_t addr) {
   /* ANDs the contents of a memory location with the contents of the stack
    * pointer register and stores the result in the accumulator, the X
    * register, and the stack pointer.  Affected flags: N Z.*/
@@ -1221,13 +1429,15 @@ void CPU::opi_LAS(uint16_t addr) {
   x_register = sp;
   updateZeroAndNegativeFlags(sp);
 }
-void CPU::opi_LAX(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::opi_LAX(uint16_t addr) {
   /* This opcode loads both the accumulator and the X register with the
    * contents of a memory location. */
   op_LDA(addr);
   op_LDX(addr);
 }
-void CPU::opi_LXA(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::opi_LXA(uint16_t addr) {
   /* aka OAL: ORs the A register with #$EE, ANDs the result with an
   immediate
    * value, and then stores the result in both A and X. Highly unstable. */
@@ -1235,28 +1445,32 @@ void CPU::opi_LXA(uint16_t addr) {
   op_AND(addr);
   op_TAX(0);
 }
-void CPU::opi_RLA(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::opi_RLA(uint16_t addr) {
   /* ROLs the contents of a memory location and then ANDs the result with
   the
    * accumulator. */
   op_ROL(addr);
   if (cyclesRemainingInCurrentInstr == 1) op_AND(addr);
 }
-void CPU::opi_RRA(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::opi_RRA(uint16_t addr) {
   /* RORs the contents of a memory location and then ADCs the result with
   the
    * accumulator. */
   op_ROR(addr);
   if (cyclesRemainingInCurrentInstr == 1) op_ADC(addr);
 }
-void CPU::opi_SAX(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::opi_SAX(uint16_t addr) {
   /* aka AXS+AAX: ANDs the contents of the A and X registers (without
   changing
    * the contents of either register) and stores the result in memory. Does
    * not affect any flags in the processor status register.*/
   bus.write(addr, a_register & x_register);
 }
-void CPU::opi_SBX(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::opi_SBX(uint16_t addr) {
   /* aka AXS+SAX: ANDs the contents of the A and X registers (leaving the
    * contents of A intact), subtracts an immediate value, and then stores
    the
@@ -1270,46 +1484,54 @@ void CPU::opi_SBX(uint16_t addr) {
    * the Carry flag, though it does affect the Carry flag. It does not
    affect
    * the Overflow flag. */
-  x_register = (a_register & x_register) - bus.read(addr);
-  // set carry flag (C) if result > 255
-  if (x_register > 0xFF) {
+  const uint8_t masked = a_register & x_register;
+  const uint8_t operand = bus.read(addr);
+  x_register = masked - operand;
+  // set carry flag (C) if no borrow, as CMP does
+  if (masked >= operand) {
     status |= FLAG_CARRY;
   } else {
     status &= ~FLAG_CARRY;  // else clear carry flag
   }
   updateZeroAndNegativeFlags(x_register);
 }
-void CPU::opi_SHA(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::opi_SHA(uint16_t addr) {
   /* Stores A AND X AND (high-byte of addr. + 1) at addr. Unstable. */
   uint8_t high_plus_one = currentHighByte + 1;
   bus.write(addr, (a_register & x_register) & high_plus_one);
 }
-void CPU::opi_SHX(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::opi_SHX(uint16_t addr) {
   /* aka A11,SXA,XAS: Stores X AND (high-byte of addr. + 1) at addr.
   Unstable.
    */
   uint8_t high_plus_one = currentHighByte + 1;
   bus.write(addr, x_register & high_plus_one);
 }
-void CPU::opi_SHY(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::opi_SHY(uint16_t addr) {
   /* aka SAY: Stores Y AND (high-byte of addr. + 1) at addr. Unstable. */
   uint8_t high_plus_one = currentHighByte + 1;
   bus.write(addr, y_register & high_plus_one);
 }
-void CPU::opi_SLO(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::opi_SLO(uint16_t addr) {
   /* This opcode ASLs the contents of a memory location and then ORs the
   result with the accumulator. */
   op_ASL(addr);
   if (cyclesRemainingInCurrentInstr == 1) op_ORA(addr);
 }
-void CPU::opi_SRE(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::opi_SRE(uint16_t addr) {
   /* aka LSE: LSRs the contents of a memory location and then EORs the
   result
    * with the accumulator. */
   op_LSR(addr);
   if (cyclesRemainingInCurrentInstr == 1) op_EOR(addr);
 }
-void CPU::opi_TAS(uint16_t addr) {
+template <typename BusType>
+void CPU<BusType>::opi_TAS(uint16_t addr) {
   /* ANDs the contents of the A and X registers (without changing the
   contents
    * of either register) and transfers the result to the stack pointer. It
@@ -1319,6 +1541,13 @@ void CPU::opi_TAS(uint16_t addr) {
   sp = a_register & x_register;
   bus.write(addr, sp & high_plus_one);
 }
-void CPU::opi_SBC(uint16_t addr) { op_SBC(addr); }
-void CPU::opi_NOP(uint16_t addr) { return; }
-void CPU::opi_KIL(uint16_t addr) { return; }
+template <typename BusType>
+void CPU<BusType>::opi_SBC(uint16_t addr) { op_SBC(addr); }
+template <typename BusType>
+void CPU<BusType>::opi_NOP(uint16_t addr) { return; }
+template <typename BusType>
+void CPU<BusType>::opi_KIL(uint16_t addr) { return; }
+
+// step(), stepByTicks() and resolveAddress() are instantiated in CPUStep.cpp
+template class CPU<Bus>;
+template class CPU<TestBus>;
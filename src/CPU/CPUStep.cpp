@@ -0,0 +1,212 @@
+#include <stdexcept>
+
+#include "../../include/CPU/CPU.h"
+#include "../../include/TestBus.h"
+
+template <typename BusType>
+uint8_t CPU<BusType>::step() {
+  // the per-cycle path is needed to produce trace logs, and to finish an
+  // instruction or interrupt that tick() has already started
+  if (!logger.isMuted() || activeInterrupt != Interrupt::NONE ||
+      cyclesRemainingInCurrentInstr != 0) {
+    return stepByTicks();
+  }
+
+  completedTakenBranchInLastTick = false;
+
+  if (pendingRES || pendingNMI ||
+      (irqLine && !(status & FLAG_INTERRUPT))) {
+    if (pendingRES) {
+      pendingRES = false;
+      activeInterrupt = Interrupt::RES;
+    } else if (pendingNMI) {
+      pendingNMI = false;
+      activeInterrupt = Interrupt::NMI;
+    } else {
+      activeInterrupt = Interrupt::IRQ;
+    }
+    // interrupt sequences take 7 cycles, see in_RES and in_NMI_IRQ
+    while (activeInterrupt != Interrupt::NONE) {
+      if (activeInterrupt == Interrupt::RES) {
+        in_RES();
+      } else {
+        in_NMI_IRQ();
+      }
+    }
+    cycleCount += 7;
+    return 7;
+  }
+
+  // fetch opcode, same as the first cycle of tick()
+  uint8_t opcode = bus.read(pc);
+  currentOpCode = OpCode::getOpCode(opcode);
+  pc++;
+  currentHighByte = 0;
+  branchTakenInCurrentInstr = false;
+  currentOpBytes[0] = opcode;
+  currentOpByteCount = 1;
+  currAddrResCtx.reset(currentOpCode->mode);
+
+  const uint8_t addressCycles = resolveAddress();
+  uint8_t cyclesUsed = 1 + addressCycles;
+  if (currAddrResCtx.waitPageCrossed) {
+    currAddrResCtx.waitPageCrossed = false;
+    cyclesUsed++;
+  }
+
+  // Handlers are written per cycle and switch on the cycles remaining, so
+  // call them exactly as tick() would. Branch handlers adjust the remaining
+  // cycle count themselves.
+  cyclesRemainingInCurrentInstr = currentOpCode->cycles - 1 - addressCycles;
+  while (cyclesRemainingInCurrentInstr > 0) {
+    execute(currAddrResCtx.address);
+    cyclesRemainingInCurrentInstr--;
+    cyclesUsed++;
+  }
+
+  completedTakenBranchInLastTick = branchTakenInCurrentInstr;
+  cycleCount += cyclesUsed;
+  return cyclesUsed;
+}
+
+/**
+ * Runs tick() until the current instruction or interrupt has completed.
+ */
+template <typename BusType>
+uint8_t CPU<BusType>::stepByTicks() {
+  uint8_t cycles = 0;
+  do {
+    tick();
+    cycles++;
+  } while (cyclesRemainingInCurrentInstr != 0 ||
+           activeInterrupt != Interrupt::NONE);
+  return cycles;
+}
+
+/**
+ * Resolves the operand address of the current opcode in a single call,
+ * performing the same bus reads as computeAbsoluteAddress().
+ *
+ * @return Number of cycles computeAbsoluteAddress() takes before the
+ * instruction handler first runs (excluding any page crossing penalty).
+ */
+template <typename BusType>
+uint8_t CPU<BusType>::resolveAddress() {
+  switch (currentOpCode->mode) {
+    case AddressingMode::Implied:
+    case AddressingMode::Acc: {
+      currAddrResCtx.state = ResolutionState::Done;
+      return 0;
+    }
+    case AddressingMode::Relative: {
+      readOperand();
+      currAddrResCtx.state = ResolutionState::Branch1;
+      return 0;
+    }
+    case AddressingMode::Immediate: {
+      currAddrResCtx.address = pc;
+      readOperand();
+      currAddrResCtx.state = ResolutionState::Done;
+      return 0;
+    }
+    case AddressingMode::ZeroPage: {
+      readOperand();
+      currAddrResCtx.address = currentOpBytes[1];
+      currAddrResCtx.state = ResolutionState::Done;
+      return 1;
+    }
+    case AddressingMode::Absolute: {
+      readOperand();
+      readOperand();
+      currAddrResCtx.address =
+          assembleBytes(currentOpBytes[2], currentOpBytes[1]);
+      currAddrResCtx.state = ResolutionState::Done;
+      // JMP computes its address in the same cycle as the second read
+      return (currentOpCode->code == 0x4C) ? 1 : 2;
+    }
+    case AddressingMode::ZeroPageX: {
+      readOperand();
+      currAddrResCtx.address =
+          static_cast<uint8_t>(currentOpBytes[1] + x_register);
+      currAddrResCtx.state = ResolutionState::Done;
+      return 2;
+    }
+    case AddressingMode::ZeroPageY: {
+      readOperand();
+      currAddrResCtx.address =
+          static_cast<uint8_t>(currentOpBytes[1] + y_register);
+      currAddrResCtx.state = ResolutionState::Done;
+      return 1;
+    }
+    case AddressingMode::AbsoluteX:
+    case AddressingMode::AbsoluteY: {
+      readOperand();
+      readOperand();
+      currentHighByte = currentOpBytes[2];  // for SHA, SHX, SHY
+      const uint16_t base = assembleBytes(currentOpBytes[2], currentOpBytes[1]);
+      const uint8_t index = (currentOpCode->mode == AddressingMode::AbsoluteX)
+                                ? x_register
+                                : y_register;
+      currAddrResCtx.address = base + index;
+      if (((base & 0xFF00) != (currAddrResCtx.address & 0xFF00)) &&
+          !currentOpCode->ignorePageCrossings) {
+        currAddrResCtx.waitPageCrossed = true;
+      }
+      currAddrResCtx.state = ResolutionState::Done;
+      return 2;
+    }
+    case AddressingMode::Indirect: {
+      readOperand();
+      readOperand();
+      currAddrResCtx.pointerAddress =
+          assembleBytes(currentOpBytes[2], currentOpBytes[1]);
+      const uint8_t lsb = bus.read(currAddrResCtx.pointerAddress);
+      // emulate page boundary bug, see computeAbsoluteAddress()
+      const uint8_t msb =
+          ((currAddrResCtx.pointerAddress & 0x00FF) == 0x00FF)
+              ? bus.read(currAddrResCtx.pointerAddress & 0xFF00)
+              : bus.read(currAddrResCtx.pointerAddress + 1);
+      currAddrResCtx.address = assembleBytes(msb, lsb);
+      currAddrResCtx.state = ResolutionState::Done;
+      return 3;
+    }
+    case AddressingMode::IndirectX: {
+      readOperand();
+      currAddrResCtx.pointerAddress =
+          static_cast<uint8_t>(currentOpBytes[1] + x_register);
+      currAddrResCtx.pointerUsed = true;
+      const uint8_t low = bus.read(currAddrResCtx.pointerAddress);
+      const uint8_t high =
+          bus.read(static_cast<uint8_t>(currAddrResCtx.pointerAddress + 1));
+      currAddrResCtx.address = assembleBytes(high, low);
+      currAddrResCtx.state = ResolutionState::Done;
+      return 4;
+    }
+    case AddressingMode::IndirectY: {
+      readOperand();
+      currAddrResCtx.pointerUsed = true;
+      const uint8_t low = bus.read(currentOpBytes[1]);
+      const uint8_t high =
+          bus.read(static_cast<uint8_t>(currentOpBytes[1] + 1));
+      currAddrResCtx.pointerAddress = assembleBytes(high, low);
+      currAddrResCtx.address = currAddrResCtx.pointerAddress + y_register;
+      if (((currAddrResCtx.pointerAddress & 0xFF00) !=
+           (currAddrResCtx.address & 0xFF00)) &&
+          !currentOpCode->ignorePageCrossings) {
+        currAddrResCtx.waitPageCrossed = true;
+      }
+      currAddrResCtx.state = ResolutionState::Done;
+      return 3;
+    }
+    default: {
+      throw std::runtime_error("Addressing mode not supported");
+    }
+  }
+}
+
+template uint8_t CPU<Bus>::step();
+template uint8_t CPU<Bus>::stepByTicks();
+template uint8_t CPU<Bus>::resolveAddress();
+template uint8_t CPU<TestBus>::step();
+template uint8_t CPU<TestBus>::stepByTicks();
+template uint8_t CPU<TestBus>::resolveAddress();
@@ -1,10 +1,46 @@
 #include "../include/Cartridge.h"
 
+#include <cstring>
+#include <mutex>
 #include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+#include "../include/Hash.h"
+#include "../include/RomDatabase.h"
+#include "../include/SaveState.h"
+
+namespace {
+
+// Hash and decoded CHR ROM of each image, shared by cartridges that load
+// it. Keyed by address: a live entry keeps its image alive, so the address
+// cannot be reused by another ROM.
+std::shared_ptr<const SharedRomData> sharedRomData(
+    std::span<const uint8_t> image, std::span<const uint8_t> rom,
+    std::span<const uint8_t> chr) {
+    static std::mutex mutex;
+    static std::unordered_map<const uint8_t *,
+                              std::weak_ptr<const SharedRomData>>
+        derived;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::erase_if(derived, [](const auto &e) { return e.second.expired(); });
+    std::weak_ptr<const SharedRomData> &entry = derived[image.data()];
+    if (auto data = entry.lock()) {
+        return data;
+    }
+    auto data = std::make_shared<SharedRomData>();
+    data->crc32 = crc32(rom.data(), rom.size());
+    data->chrTiles.rebuild(chr);
+    entry = data;
+    return data;
+}
+
+} // namespace
 
 /**
- * Read from PRG ROM, panics if no cartridge is loaded or PRG ROM is empty.
- * Mirrors down address if PRG ROM is 16KiB.
+ * Read from PRG ROM through the mapper's current banks, panics if no cartridge
+ * is loaded or PRG ROM is empty.
  */
 uint8_t Cartridge::read_prg_rom(uint16_t addr) {
     if (empty) {
@@ -14,14 +50,7 @@ uint8_t Cartridge::read_prg_rom(uint16_t addr) {
         throw std::runtime_error("Error: cartridge PRG ROM is empty.");
     }
 
-    size_t index = static_cast<size_t>(addr - 0x8000);
-
-    // mirror if prg_rom is 16KiB. Will need to modify this if additional
-    // mappers are implemented.
-    if ((prg_rom.size() == 0x4000) && (index >= 0x4000)) {
-        index %= 0x4000;
-    }
-
+    const size_t index = mapper->prgOffset(addr);
     if (index >= prg_rom.size()) {
         throw std::out_of_range("PRG ROM read out of range");
     }
@@ -29,6 +58,40 @@ uint8_t Cartridge::read_prg_rom(uint16_t addr) {
     return prg_rom[index];
 }
 
+/**
+ * Start of the 256 byte PRG ROM page that addr ($8000-$FFFF) is currently
+ * banked to, or nullptr if no PRG ROM is loaded. Used by the bus to read ROM
+ * without a call per access, so it must be asked again after a bank switch.
+ */
+const uint8_t *Cartridge::prg_page(uint16_t addr) const {
+    if (empty || prg_rom.empty() || addr < 0x8000) {
+        return nullptr;
+    }
+    return prg_rom.data() + mapper->prgOffset(addr & 0xFF00);
+}
+
+/**
+ * Start of the 256 byte PRG RAM page that addr ($6000-$7FFF) falls in, or
+ * nullptr if the cartridge has no PRG RAM.
+ */
+uint8_t *Cartridge::prg_ram_page(uint16_t addr) {
+    if (prg_ram.empty() || addr < 0x6000 || addr >= 0x8000) {
+        return nullptr;
+    }
+    return prg_ram.data() + ((addr - 0x6000) & 0xFF00);
+}
+
+/**
+ * CPU write to $8000-$FFFF, which goes to the mapper's registers. Ignored with
+ * no cartridge loaded. The caller must remap PRG pages afterwards.
+ */
+void Cartridge::write_prg(uint16_t addr, uint8_t value) {
+    if (empty) {
+        return;
+    }
+    mapper->writeRegister(addr, value);
+}
+
 /**
  * Read from CHR ROM, panics if no cartridge is loaded or CHR ROM is empty
  */
@@ -41,89 +104,147 @@ uint8_t Cartridge::read_chr_rom(uint16_t addr) {
         throw std::runtime_error(
             "Error: attempted to read from CHR memory but CHR ROM is empty.");
     }
-    return chr_rom[addr % chr_rom.size()];
+    return chr_rom[mapper->chrOffset(addr) % chr_rom.size()];
 }
 
 /**
- * Write to CHR RAM, panics if CHR is ROM (or empty)
+ * Read one pre-decoded pattern row, panics if no cartridge is loaded or CHR ROM
+ * is empty. addr is the pattern table address of the row's low plane byte.
  */
-void Cartridge::write_chr_ram(uint16_t addr, uint8_t value) {
+const TileRow &Cartridge::read_chr_tile_row(uint16_t addr,
+                                            bool flipHorizontal) {
     if (empty) {
         throw std::runtime_error(
-            "Error: attempted to write to CHR RAM with no cartridge loaded.");
+            "Error: attempted to read from CHR ROM with no cartridge loaded.");
     }
-    // if (!chr_is_ram) {
-    //     throw std::runtime_error("Error: attempted to write to CHR ROM.");
-    // }
-    if (chr_rom.empty()) {
-        throw std::runtime_error("Error: attempted to write to empty CHR RAM.");
+    if (chr_tiles->empty()) {
+        throw std::runtime_error(
+            "Error: attempted to read from CHR memory but CHR ROM is empty.");
     }
-    chr_rom[addr % chr_rom.size()] = value;
+    return chr_tiles->row(mapper->chrOffset(addr) % chr_rom.size(),
+                          flipHorizontal);
 }
 
 /**
- * Load a cartridge from an iNES 1.0 ROM dump
+ * Write to CHR RAM, panics if no cartridge is loaded. Writes to CHR ROM are
+ * ignored, as on hardware; the ROM image is read-only.
  */
-void Cartridge::load(const std::vector<uint8_t> &romDump) {
-    // validate iNES header
-    // 0-3 | Constant "NES" ($4E $45 $53 $1A - ASCII "NES" followed by EOF char)
-    if (romDump.size() < 16 || romDump[0] != 'N' || romDump[1] != 'E' ||
-        romDump[2] != 'S' || romDump[3] != 0x1A) {
-        throw std::invalid_argument("File is not in iNES file format");
+void Cartridge::write_chr_ram(uint16_t addr, uint8_t value) {
+    if (empty) {
+        throw std::runtime_error(
+            "Error: attempted to write to CHR RAM with no cartridge loaded.");
     }
-
-    uint8_t ines_ver = (romDump[7] >> 2) & 0b00000011;
-    if (ines_ver != 0) {
-        throw std::invalid_argument("NES2.0 format is not supported yet.");
+    if (!chr_is_ram) {
+        return;
     }
+    const size_t index = mapper->chrOffset(addr) % chr_ram.size();
+    chr_ram[index] = value;
+    chr_ram_tiles.update(chr_ram, index);
+}
 
-    mapper = (romDump[7] & 0b11110000) | (romDump[6] >> 4);
+void Cartridge::load(const std::vector<uint8_t> &romDump) {
+    load(RomImage::copy(romDump));
+}
 
-    // FLAGS 9
-    // 76543210
-    // ||||||||
-    // |||||||+- TV system (0: NTSC; 1: PAL)
-    // +++++++-- Reserved, set to zero
-    region = romDump[9] == 0 ? NESRegion::NTSC : NESRegion::PAL;
+void Cartridge::load(const std::vector<uint8_t> &romDump,
+                     const RomDatabase &database) {
+    load(RomImage::copy(romDump), database);
+}
 
-    if (mapper != 0x00) {
-        throw std::runtime_error("mapper not implemented");
-    }
+void Cartridge::load(std::shared_ptr<const RomImage> romImage) {
+    load(std::move(romImage), RomDatabase::standard());
+}
 
-    prg_rom_size = romDump[4] * 16384; // PRG ROM size given in 16KiB blocks
-    chr_rom_size = romDump[5] * 8192;  // CHR ROM size given in 8KiB blocks
+void Cartridge::load(std::shared_ptr<const RomImage> romImage,
+                     const RomDatabase &database) {
+    const std::span<const uint8_t> romDump = romImage->bytes();
+    RomHeader parsed = RomHeader::parse(romDump);
+
+    const std::span<const uint8_t> new_prg_rom =
+        romDump.subspan(parsed.prgRomOffset(), parsed.prgRomSize);
+    const std::span<const uint8_t> new_chr_rom = romDump.subspan(
+        parsed.prgRomOffset() + parsed.prgRomSize, parsed.chrRomSize);
+    auto newShared = sharedRomData(
+        romDump,
+        romDump.subspan(parsed.prgRomOffset(),
+                        parsed.prgRomSize + parsed.chrRomSize),
+        new_chr_rom);
+    if (const RomDatabaseEntry *entry = database.find(newShared->crc32)) {
+        entry->applyTo(parsed);
+    }
 
-    // determine mirroring mode:
-    if (romDump[6] & 0b00001000) {
-        // bit 3 of flags 6 is set [alt layout]
-        mirroring = MirroringMode::FourScreen;
+    // boards without CHR ROM or declared CHR RAM get 8 KiB of CHR RAM
+    const size_t chr_ram_size = parsed.chrRamSize + parsed.chrNvramSize;
+    const size_t chr_size = parsed.chrRomSize != 0 ? parsed.chrRomSize
+                            : chr_ram_size != 0    ? chr_ram_size
+                                                   : 8192;
+    auto newMapper = Mapper::create(parsed.mapper, parsed.prgRomSize,
+                                    chr_size, parsed.mirroring);
+
+    prg_rom = new_prg_rom;
+    if (parsed.chrRomSize == 0) {
+        chr_ram.assign(chr_size, 0);
+        chr_ram_tiles.rebuild(chr_ram);
+        chr_rom = chr_ram;
+        chr_tiles = &chr_ram_tiles;
+        chr_is_ram = true;
     } else {
-        // bit 0 of flags 6 set ? vertical mirroring, else horizontal
-        mirroring = (romDump[6] & 0b1) ? MirroringMode::Vertical
-                                       : MirroringMode::Horizontal;
+        chr_ram.clear();
+        chr_ram_tiles.rebuild(chr_ram);
+        chr_rom = new_chr_rom;
+        chr_tiles = &newShared->chrTiles;
+        chr_is_ram = false;
     }
 
-    bool skip_trainer = (romDump[6] & 0b00000100) != 0;
+    // Only the first 8 KiB are mapped, PRG RAM banking is not modelled.
+    // iNES 1.0 does not record volatile PRG RAM, so the mapper decides.
+    const bool has_prg_ram =
+        parsed.prgRamSize + parsed.prgNvramSize != 0 ||
+        (parsed.format == RomFormat::INES && newMapper->hasPRGRAM());
+    prg_ram.assign(has_prg_ram ? 0x2000 : 0, 0);
 
-    size_t prg_rom_start = 16 + (skip_trainer ? 512 : 0);
-    size_t chr_rom_start = prg_rom_start + prg_rom_size;
-    size_t rom_payload_size = prg_rom_size + chr_rom_size;
+    mirroring = parsed.mirroring;
+    header = parsed;
+    mapper = std::move(newMapper);
+    shared = std::move(newShared);
+    image = std::move(romImage);
+    ppuA12 = false;
 
-    if (romDump.size() < prg_rom_start + rom_payload_size) {
-        throw std::invalid_argument("Invalid ROM file: insufficient data");
+    empty = false;
+}
+
+void Cartridge::saveState(StateWriter &out) const {
+    if (empty) {
+        throw std::runtime_error("Error: no cartridge loaded.");
     }
+    mapper->saveState(out);
+    out.writeBytes(prg_ram.data(), prg_ram.size());
+    out.write(ppuA12);
+    if (chr_is_ram) {
+        out.writeBytes(chr_ram.data(), chr_ram.size());
+    }
+}
 
-    prg_rom.assign(romDump.begin() + prg_rom_start,
-                   romDump.begin() + prg_rom_start + prg_rom_size);
-    if (chr_rom_size == 0) {
-        // iNES uses CHR size 0 to indicate 8 KiB of CHR-RAM
-        chr_rom.assign(8192, 0);
-        chr_is_ram = true;
-    } else {
-        chr_rom.assign(romDump.begin() + chr_rom_start,
-                       romDump.begin() + chr_rom_start + chr_rom_size);
-        chr_is_ram = false;
+void Cartridge::loadState(StateReader &in) {
+    if (empty) {
+        throw std::runtime_error("Error: no cartridge loaded.");
+    }
+    mapper->loadState(in);
+    in.readBytes(prg_ram.data(), prg_ram.size());
+    in.read(ppuA12);
+    if (!chr_is_ram) {
+        return;
     }
 
-    empty = false;
+    // only re-decode tiles that differ, snapshots are usually close together
+    std::array<uint8_t, 16> tile;
+    for (size_t offset = 0; offset < chr_ram.size(); offset += tile.size()) {
+        in.readBytes(tile.data(), tile.size());
+        if (std::memcmp(&chr_ram[offset], tile.data(), tile.size()) != 0) {
+            std::memcpy(&chr_ram[offset], tile.data(), tile.size());
+            for (size_t row = 0; row < 8; row++) {
+                chr_ram_tiles.update(chr_ram, offset + row);
+            }
+        }
+    }
 }
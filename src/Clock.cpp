@@ -1,17 +1,26 @@
 #include "../include/Clock.h"
 
-#include <SDL3/SDL.h>
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <exception>
+#include <stdexcept>
 #include <thread>
 
+#include "../include/Frontend.h"
 #include "../include/NES.h"
+#include "../include/SaveState.h"
 
 using steady_clock = std::chrono::steady_clock;
 
 Clock::Clock(NES &nes)
-    : nes(nes), region(NESRegion::None), running(false), lastNMIState(false),
-      pendingNMIEdge(false),
-      frameDuration(std::chrono::steady_clock::duration::zero()) {}
+    : nes(nes), region(NESRegion::None), syncMode(SyncMode::CycleStepped),
+      running(false), lastNMIState(false), pendingNMIEdge(false), rewind(),
+      rewindSnapshot(), rewinding(false), joypad1Input(0), presented(),
+      runAheadFrames(0), runAheadSnapshot(), runAheadStats(),
+      frameDuration(std::chrono::steady_clock::duration::zero()),
+      pacingMode(PacingMode::Timer), pacingStats(), nextFrameTime(),
+      lastFrameTime(), refreshMicros(0.0), presents(0) {}
 
 void Clock::setRegion(NESRegion region) {
     if (region == NESRegion::None) {
@@ -20,9 +29,16 @@ void Clock::setRegion(NESRegion region) {
 
     this->region = region;
 
-    double cyclesPerFrame = (region == NESRegion::NTSC) ? 29780.5 : 33247.5;
-    double cpuHz = (region == NESRegion::NTSC) ? MASTER_SPEED_NTSC / 12.0
-                                               : MASTER_SPEED_PAL / 16.0;
+    double cyclesPerFrame = 29780.5;
+    double cpuHz = MASTER_SPEED_NTSC / 12.0;
+    if (region == NESRegion::PAL) {
+        cyclesPerFrame = 33247.5;
+        cpuHz = MASTER_SPEED_PAL / 16.0;
+    } else if (region == NESRegion::Dendy) {
+        // PAL master clock and 312 scanlines, but 3 dots per CPU cycle
+        cyclesPerFrame = 35464.0;
+        cpuHz = MASTER_SPEED_PAL / 15.0;
+    }
 
     // calculate frame duration
     const double framerate = cpuHz / cyclesPerFrame;
@@ -30,130 +46,381 @@ void Clock::setRegion(NESRegion region) {
         std::chrono::duration<double>(1.0 / framerate));
 }
 
+double Clock::getFrameRate() const {
+    return 1.0 / std::chrono::duration<double>(frameDuration).count();
+}
+
+PacingStats Clock::getPacingStats() const {
+    PacingStats stats = pacingStats;
+    stats.audioUnderruns = nes.apu.output().underrunCount();
+    stats.audioOverruns = nes.apu.output().overrunCount();
+    return stats;
+}
+
 // start game loop
-void Clock::start() {
+void Clock::start(Frontend &frontend) {
+    reset();
+
+    // window events and rendering must stay on this thread, so emulation moves
+    std::exception_ptr emulationError;
+    std::thread emulation([this, &emulationError] {
+        try {
+            gameLoop();
+        } catch (...) {
+            emulationError = std::current_exception();
+        }
+        running = false;
+    });
+
+    try {
+        presentLoop(frontend);
+    } catch (...) {
+        stop();
+        emulation.join();
+        throw;
+    }
+    stop();
+    emulation.join();
+    if (emulationError) {
+        std::rethrow_exception(emulationError);
+    }
+}
+
+HeadlessResult Clock::runHeadless(uint64_t frameCount) {
+    reset();
+
+    HeadlessResult result;
+    const uint64_t startCycles = nes.cpu.getCycleCount();
+    const auto startTime = steady_clock::now();
+    while (result.frames < frameCount) {
+        auto frame = step();
+        if (frame) {
+            result.frames++;
+            deliverFrame(*frame);
+            recordOrRewind();
+            result.frameHash =
+                runAheadFrames > 0 ? runAhead().hash() : frame->hash();
+        }
+    }
+    result.elapsedSeconds =
+        std::chrono::duration<double>(steady_clock::now() - startTime).count();
+    result.cpuCycles = nes.cpu.getCycleCount() - startCycles;
+    running = false;
+    nes.ppu.setVideoOutput(true);
+    return result;
+}
+
+const Frame &Clock::runFrame() {
+    enterRunLoop();
+    const Frame &frame = emulateFrame();
+    deliverFrame(frame);
+    return frame;
+}
+
+uint64_t Clock::runCycles(uint64_t cycles) {
+    const uint64_t end = nes.cpu.getCycleCount() + cycles;
+    return runUntil([&] { return nes.cpu.getCycleCount() >= end; });
+}
+
+void Clock::requireRegion() const {
     if (region == NESRegion::None) {
         throw std::runtime_error("No region set");
-    } else {
-        running = true;
-        lastNMIState = false;
-        pendingNMIEdge = false;
-        gameLoop();
     }
 }
 
-void Clock::gameLoop() {
-    auto nextFrameTime = steady_clock::now() + frameDuration;
-    uint32_t cpuTicksUntilEventPoll = 1024;
-    while (running) {
-        // tick CPU
+void Clock::enterRunLoop() {
+    requireRegion();
+    // every frame is shown here, whatever run-ahead turned off in start()
+    nes.ppu.setVideoOutput(true);
+}
+
+void Clock::reset() {
+    requireRegion();
+    running = true;
+    // with run-ahead only the frames from the future are ever shown
+    nes.ppu.setVideoOutput(runAheadFrames == 0);
+}
+
+void Clock::saveState(StateWriter &out) const {
+    out.write(lastNMIState);
+    out.write(pendingNMIEdge);
+}
+
+void Clock::loadState(StateReader &in) {
+    in.read(lastNMIState);
+    in.read(pendingNMIEdge);
+}
+
+/**
+ * Advances the console by one CPU cycle, or one CPU instruction in
+ * InstructionStepped mode, and the PPU by three dots per CPU cycle. Returns
+ * the frame completed by the PPU during this step, if any.
+ */
+const Frame *Clock::step() {
+    // tick CPU
+    uint32_t cpuCycles = 1;
+    if (syncMode == SyncMode::InstructionStepped) {
+        cpuCycles = nes.cpu.step();
+    } else {
         nes.cpu.tick();
+    }
 
-        // process input events every 1024 CPU ticks
-        if (--cpuTicksUntilEventPoll == 0) {
-            this->processEvents();
-            cpuTicksUntilEventPoll = 1024;
-            if (!running) {
-                break;
-            }
-        }
+    nes.apu.clock(cpuCycles);
+    // the CPU is halted while the DMC reads a sample byte, the rest of the
+    // machine keeps running
+    if (const uint32_t stall = nes.apu.takeStallCycles()) {
+        nes.apu.clock(stall);
+        cpuCycles += stall;
+    }
 
-        // trigger NMI if pending
-        if (pendingNMIEdge) {
-            nes.cpu.triggerNMI();
-            pendingNMIEdge = false;
-        }
+    // trigger NMI if pending
+    if (pendingNMIEdge) {
+        nes.cpu.triggerNMI();
+        pendingNMIEdge = false;
+    }
 
-        // tick PPU three times for each CPU tick
-        for (int i = 0; i < 3; i++) {
-            auto frame = nes.ppu.tick();
-            const bool nmiState = nes.bus.ppuNMI();
-            // check if NMI has just been raised:
-            if (nmiState && !lastNMIState) {
-                // CPU timing quirk: NMI is not actioned if the CPU completed a
-                // branch on the previous tick, mark pending
-                if (nes.cpu.completedTakenBranchLastTick()) {
-                    pendingNMIEdge = true;
-                } else {
-                    nes.cpu.triggerNMI();
-                }
-            }
-            lastNMIState = nmiState;
-            if (frame) {
-                // ppu has generated a new frame, render it and process events
-                render(*frame);
-                this->processEvents();
-                if (!running) {
-                    break;
-                }
-                // maintain frame timing:
-                const auto now = steady_clock::now();
-                if (now < nextFrameTime) {
-                    std::this_thread::sleep_until(nextFrameTime);
-                } else {
-                    nextFrameTime = now;
-                }
-                nextFrameTime += frameDuration;
-            }
-        }
+    return catchUpPPU(cpuCycles);
+}
+
+/**
+ * Called once per completed frame. Adds the machine state to the rewind
+ * history, or while rewinding restores the previous frame's state instead.
+ */
+void Clock::recordOrRewind() {
+    if (!rewind.enabled()) {
+        return;
     }
+    if (rewinding) {
+        rewindFrame();
+        return;
+    }
+    nes.saveState(rewindSnapshot);
+    rewind.push(rewindSnapshot);
 }
 
-// read inputs
-void Clock::processEvents() {
-    SDL_Event event;
-    while (SDL_PollEvent(&event)) {
-        if (event.type == SDL_EVENT_QUIT) {
-            running = false;
-        } else if (event.type == SDL_EVENT_KEY_DOWN ||
-                   event.type == SDL_EVENT_KEY_UP) {
-            switch (event.key.key) {
-            case SDLK_ESCAPE:
-                if (event.type == SDL_EVENT_KEY_DOWN && !event.key.repeat) {
-                    running = false;
-                }
-                break;
-            default:
-                break;
-            }
+bool Clock::rewindFrame() {
+    if (!rewind.stepBack(rewindSnapshot)) {
+        return false;
+    }
+    nes.loadState(rewindSnapshot);
+    return true;
+}
+
+/**
+ * Steps the console until the PPU completes a frame.
+ */
+const Frame &Clock::emulateFrame() {
+    while (true) {
+        if (const Frame *frame = step()) {
+            return *frame;
         }
     }
+}
 
-    int keyCount = 0;
-    const bool *keys = SDL_GetKeyboardState(&keyCount);
-    auto isPressed = [&](SDL_Scancode code) -> bool {
-        const int idx = static_cast<int>(code);
-        return idx >= 0 && idx < keyCount && keys[idx];
-    };
+/**
+ * Emulates runAheadFrames frames with the current input, drawing only the
+ * last, then restores the machine to where it started.
+ */
+const Frame &Clock::runAhead() {
+    const auto start = steady_clock::now();
+    nes.apu.setAudioOutput(false); // these frames are heard when run for real
+    nes.saveState(runAheadSnapshot);
+    const auto saved = steady_clock::now();
 
-    uint8_t joypad1State = 0;
-    if (isPressed(SDL_SCANCODE_Z) || isPressed(SDL_SCANCODE_J)) {
-        joypad1State |= Bus::JOYPAD_A;
+    for (uint32_t i = 1; i < runAheadFrames; i++) {
+        emulateFrame();
     }
-    if (isPressed(SDL_SCANCODE_X) || isPressed(SDL_SCANCODE_K)) {
-        joypad1State |= Bus::JOYPAD_B;
+    nes.ppu.setVideoOutput(true);
+    const Frame &future = emulateFrame();
+    nes.ppu.setVideoOutput(false);
+
+    const auto emulated = steady_clock::now();
+    nes.loadState(runAheadSnapshot);
+    nes.apu.setAudioOutput(true);
+    const auto end = steady_clock::now();
+
+    using micros = std::chrono::duration<double, std::micro>;
+    runAheadStats.hostFrames++;
+    runAheadStats.framesRun += runAheadFrames;
+    runAheadStats.emulateMicros += micros(emulated - saved).count();
+    runAheadStats.saveLoadMicros +=
+        micros(saved - start).count() + micros(end - emulated).count();
+    return future;
+}
+
+/**
+ * Ticks the PPU three times for each of the given CPU cycles, raising NMI on
+ * the CPU when the PPU's NMI output rises, and drives the CPU's IRQ line from
+ * the cartridge's and APU's IRQ outputs. Audio is flushed at the end of each
+ * video frame.
+ */
+const Frame *Clock::catchUpPPU(uint32_t cpuCycles) {
+    const Frame *completedFrame = nullptr;
+    const uint32_t dots = cpuCycles * 3;
+    for (uint32_t i = 0; i < dots; i++) {
+        const Frame *frame = nes.ppu.tick();
+        const bool nmiState = nes.bus.ppuNMI();
+        // check if NMI has just been raised:
+        if (nmiState && !lastNMIState) {
+            // CPU timing quirk: NMI is not actioned if the CPU completed a
+            // branch on the previous tick, mark pending
+            const bool duringLastCPUCycle = (i >= dots - 3);
+            if (duringLastCPUCycle && nes.cpu.completedTakenBranchLastTick()) {
+                pendingNMIEdge = true;
+            } else {
+                nes.cpu.triggerNMI();
+            }
+        }
+        lastNMIState = nmiState;
+        if (frame) {
+            completedFrame = frame;
+        }
     }
-    if (isPressed(SDL_SCANCODE_RETURN) || isPressed(SDL_SCANCODE_KP_ENTER) ||
-        isPressed(SDL_SCANCODE_SPACE)) {
-        joypad1State |= Bus::JOYPAD_START;
+
+    if (completedFrame) {
+        nes.apu.endFrame();
     }
-    if (isPressed(SDL_SCANCODE_TAB) || isPressed(SDL_SCANCODE_LSHIFT) ||
-        isPressed(SDL_SCANCODE_RSHIFT)) {
-        joypad1State |= Bus::JOYPAD_SELECT;
+
+    // the mapper IRQ only changes on PPU A12 edges and register writes, and
+    // the APU IRQ at events the APU catches up for, so once per step is
+    // precise enough. IRQ is a shared level: a source raised while another
+    // holds the line must still be seen once the first is acknowledged
+    nes.cpu.setIRQLine(nes.cart.irqAsserted() || nes.apu.irqAsserted());
+    return completedFrame;
+}
+
+void Clock::gameLoop() {
+    nextFrameTime = steady_clock::now() + frameDuration;
+    lastFrameTime = steady_clock::time_point{};
+    uint32_t cpuTicksUntilInputPoll = 1024;
+    while (running) {
+        auto frame = step();
+
+        // pick up input from the presenting thread every 1024 steps
+        if (--cpuTicksUntilInputPoll == 0) {
+            applyInput();
+            cpuTicksUntilInputPoll = 1024;
+        }
+
+        if (frame) {
+            // ppu has generated a new frame, hand it to the presenting
+            // thread. Input is read first so that run-ahead frames see it.
+            applyInput();
+            deliverFrame(*frame);
+            recordOrRewind();
+            const uint64_t shown = presents.load(std::memory_order_acquire);
+            if (runAheadFrames > 0) {
+                presented.publish(runAhead());
+            } else {
+                presented.publish(*frame);
+            }
+            pace(shown);
+        }
     }
-    if (isPressed(SDL_SCANCODE_UP) || isPressed(SDL_SCANCODE_W)) {
-        joypad1State |= Bus::JOYPAD_UP;
+}
+
+/**
+ * Waits until the next frame is due, by the pacing mode, and records how
+ * evenly frames are spaced. shown is the number of frames the presenting
+ * thread had shown before this one was published.
+ */
+void Clock::pace(uint64_t shown) {
+    bool audioLow = false;
+    if (pacingMode != PacingMode::Timer) {
+        steerAudio();
+        // rather than run dry at startup or after a stall, the buffer is
+        // refilled by not waiting for frames while it is below half its
+        // target
+        audioLow = nes.apu.output().size() <
+                   nes.apu.getSampleRate() * AUDIO_LATENCY / 2.0;
     }
-    if (isPressed(SDL_SCANCODE_DOWN) || isPressed(SDL_SCANCODE_S)) {
-        joypad1State |= Bus::JOYPAD_DOWN;
+
+    if (pacingMode == PacingMode::VSync) {
+        // the presenting thread blocks in VSync, so waiting for it to show
+        // a frame paces emulation to the display
+        if (!audioLow) {
+            presents.wait(shown, std::memory_order_acquire);
+        }
+    } else {
+        const auto now = steady_clock::now();
+        if (now < nextFrameTime && !audioLow) {
+            std::this_thread::sleep_until(nextFrameTime);
+        } else {
+            nextFrameTime = now;
+        }
+        nextFrameTime += frameDuration;
     }
-    if (isPressed(SDL_SCANCODE_LEFT) || isPressed(SDL_SCANCODE_A)) {
-        joypad1State |= Bus::JOYPAD_LEFT;
+
+    const auto now = steady_clock::now();
+    if (lastFrameTime != steady_clock::time_point{}) {
+        const double interval =
+            std::chrono::duration<double, std::micro>(now - lastFrameTime)
+                .count();
+        double expected =
+            std::chrono::duration<double, std::micro>(frameDuration).count();
+        if (pacingMode == PacingMode::VSync) {
+            // the display's refresh interval is only known by measuring it
+            refreshMicros = refreshMicros == 0.0
+                                ? interval
+                                : refreshMicros + (interval - refreshMicros) / 64;
+            expected = refreshMicros;
+        }
+        const double jitter = std::abs(interval - expected);
+        pacingStats.frames++;
+        pacingStats.totalJitterMicros += jitter;
+        pacingStats.maxJitterMicros =
+            std::max(pacingStats.maxJitterMicros, jitter);
     }
-    if (isPressed(SDL_SCANCODE_RIGHT) || isPressed(SDL_SCANCODE_D)) {
-        joypad1State |= Bus::JOYPAD_RIGHT;
+    lastFrameTime = now;
+}
+
+/**
+ * Dynamic rate control: sets the audio rate ratio in proportion to how far
+ * the buffered audio is from its target, so the emulator produces samples
+ * as fast as the device consumes them and the fill level settles there.
+ */
+void Clock::steerAudio() {
+    const double target = nes.apu.getSampleRate() * AUDIO_LATENCY;
+    const auto fill = static_cast<double>(nes.apu.output().size());
+    const double error = std::clamp((target - fill) / target, -1.0, 1.0);
+    const double ratio = 1.0 + error * MAX_RATE_ADJUSTMENT;
+    nes.apu.setRateRatio(ratio);
+
+    pacingStats.rateRatio = ratio;
+    pacingStats.minRateRatio = std::min(pacingStats.minRateRatio, ratio);
+    pacingStats.maxRateRatio = std::max(pacingStats.maxRateRatio, ratio);
+}
+
+// ends the run and wakes an emulation thread waiting for a present
+void Clock::stop() {
+    running = false;
+    presents.fetch_add(1, std::memory_order_release);
+    presents.notify_all();
+}
+
+/**
+ * Runs on the thread that owns the window. Frames the emulation thread
+ * completes while a present is blocked on VSync are skipped, not queued.
+ */
+void Clock::presentLoop(Frontend &frontend) {
+    while (running) {
+        const FrontendInput input = frontend.poll();
+        joypad1Input.store(input.joypad1, std::memory_order_relaxed);
+        rewinding = input.rewind;
+        if (input.quit) {
+            running = false;
+        }
+
+        if (const Frame *frame = presented.take()) {
+            frontend.present(*frame);
+            presents.fetch_add(1, std::memory_order_release);
+            presents.notify_all();
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
     }
-    nes.bus.setJoypad1Buttons(joypad1State);
 }
 
-void Clock::render(const Frame &frame) { nes.renderer.render(frame); }
+void Clock::applyInput() {
+    nes.bus.setJoypad1Buttons(joypad1Input.load(std::memory_order_relaxed));
+}
@@ -1,32 +1,27 @@
 #include <SDL3/SDL_main.h>
 
-#include <fstream>
-#include <iterator>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "../include/APU/AudioDevice.h"
 #include "../include/Constants.h"
+#include "../include/Hash.h"
 #include "../include/NES.h"
 #include "../include/Renderer/Renderer.h" // includes SDH.h
-
-std::vector<uint8_t> readROM(char *filename) {
-    std::ifstream file(filename, std::ios::binary);
-    if (!file) {
-        throw std::runtime_error("Could not open file: " +
-                                 std::string(filename));
-    }
-
-    // read rom file into vector
-    std::vector<uint8_t> romDump((std::istreambuf_iterator<char>(file)),
-                                 std::istreambuf_iterator<char>());
-
-    return romDump;
-}
+#include "../include/RomDatabase.h"
+#include "../include/RomImage.h"
+#include "../include/SDLFrontend.h"
+#include "../include/TraceRecorder.h"
 
 void initialise_SDL(SDL_Window *&sdlWindow, SDL_Renderer *&sdlRenderer,
-                    SDL_Texture *&sdlTexture) {
+                    SDL_Texture *&sdlTexture, int textureWidth,
+                    int textureHeight) {
     if (!SDL_Init(SDL_INIT_VIDEO)) {
         throw std::runtime_error(std::string("SDL_Init Error: ") +
                                  SDL_GetError());
@@ -47,10 +42,11 @@ void initialise_SDL(SDL_Window *&sdlWindow, SDL_Renderer *&sdlRenderer,
                   << std::endl;
     }
 
-    // Create a streaming texture for updating pixel data
-    sdlTexture = SDL_CreateTexture(sdlRenderer, SDL_PIXELFORMAT_RGB24,
-                                   SDL_TEXTUREACCESS_STREAMING, RENDER_WIDTH,
-                                   RENDER_HEIGHT);
+    // Create a streaming texture for updating pixel data, stretched over
+    // the window with nearest filtering
+    sdlTexture = SDL_CreateTexture(sdlRenderer, SDL_PIXELFORMAT_RGBA32,
+                                   SDL_TEXTUREACCESS_STREAMING, textureWidth,
+                                   textureHeight);
 
     if (!sdlTexture) {
         SDL_DestroyRenderer(sdlRenderer);
@@ -70,33 +66,233 @@ void initialise_SDL(SDL_Window *&sdlWindow, SDL_Renderer *&sdlRenderer,
     }
 }
 
+// print final machine state and throughput of a headless run
+void printHeadlessReport(NES &nes, const HeadlessResult &result) {
+    const auto &ram = nes.bus.getCPURAM();
+    std::printf("frames:      %llu\n",
+                static_cast<unsigned long long>(result.frames));
+    std::printf("cpu cycles:  %llu\n",
+                static_cast<unsigned long long>(result.cpuCycles));
+    std::printf("frame hash:  %016llx\n",
+                static_cast<unsigned long long>(result.frameHash));
+    std::printf("ram hash:    %016llx\n",
+                static_cast<unsigned long long>(
+                    fnv1a64(ram.data(), ram.size())));
+    std::printf("cpu:         PC:%04X A:%02X X:%02X Y:%02X P:%02X SP:%02X\n",
+                nes.cpu.getPC(), nes.cpu.getA(), nes.cpu.getX(),
+                nes.cpu.getY(), nes.cpu.getStatus(), nes.cpu.getSP());
+    std::printf("ppu:         scanline %u, dot %u\n", nes.ppu.getScanline(),
+                nes.ppu.getCycle());
+    std::printf("elapsed:     %.3f s\n", result.elapsedSeconds);
+    std::printf("fps:         %.1f\n", result.framesPerSecond());
+}
+
+// print size and cost of the rewind history
+void printRewindReport(const RewindStats &stats) {
+    std::printf("rewind:      %zu frames, %.2f MiB of %.0f MiB, "
+                "%zu B snapshot\n",
+                stats.frames, stats.historyBytes / (1024.0 * 1024.0),
+                stats.budgetBytes / (1024.0 * 1024.0), stats.snapshotBytes);
+    std::printf("rewind cost: %.2f us/frame avg, %.2f us last\n",
+                stats.averageCompressMicros(), stats.lastCompressMicros);
+}
+
+PacingMode pacingModeFromName(const std::string &name) {
+    if (name == "timer") {
+        return PacingMode::Timer;
+    }
+    if (name == "audio") {
+        return PacingMode::Audio;
+    }
+    if (name == "vsync") {
+        return PacingMode::VSync;
+    }
+    throw std::invalid_argument("Unknown pacing mode: " + name);
+}
+
+// refresh rate of the display showing the window, 0 if unknown
+double displayRefreshRate(SDL_Window *window) {
+    const SDL_DisplayMode *mode =
+        SDL_GetCurrentDisplayMode(SDL_GetDisplayForWindow(window));
+    return mode ? mode->refresh_rate : 0.0;
+}
+
+// print frame pacing and audio buffer health of a windowed run
+void printPacingReport(const PacingStats &stats) {
+    std::printf("pacing:      %.0f us avg jitter, %.0f us max over %llu "
+                "frames\n",
+                stats.averageJitterMicros(), stats.maxJitterMicros,
+                static_cast<unsigned long long>(stats.frames));
+    std::printf("audio:       %llu underruns, %llu overruns, rate ratio "
+                "%.4f (%.4f-%.4f)\n",
+                static_cast<unsigned long long>(stats.audioUnderruns),
+                static_cast<unsigned long long>(stats.audioOverruns),
+                stats.rateRatio, stats.minRateRatio, stats.maxRateRatio);
+}
+
+// print the extra host time spent on run-ahead
+void printRunAheadReport(const RunAheadStats &stats) {
+    std::printf("run-ahead:   %llu extra frames for %llu shown\n",
+                static_cast<unsigned long long>(stats.framesRun),
+                static_cast<unsigned long long>(stats.hostFrames));
+    std::printf("run-ahead cost: %.1f us/extra frame, %.2f us/frame "
+                "save+load\n",
+                stats.microsPerFrame(), stats.saveLoadMicrosPerHostFrame());
+}
+
 int main(int argc, char *argv[]) {
-    if (argc < 2 || argc > 3) {
-        throw std::invalid_argument("Usage: nesemu <rom.nes> [--trace]");
+    const std::string usage =
+        "Usage: nesemu <rom.nes> [--trace] [--trace-file PATH] "
+        "[--trace-records N] [--headless] [--frames N] "
+        "[--instruction-stepped] [--scanline-ppu] [--rewind-mb N] "
+        "[--run-ahead N] [--scaler gpu|nearest|scanlines|epx] "
+        "[--pacing timer|audio|vsync] [--rom-db PATH]";
+    if (argc < 2) {
+        throw std::invalid_argument(usage);
     }
 
     bool enableTrace = false;
-    if (argc == 3) {
-        if (std::string(argv[2]) == "--trace") {
+    std::optional<std::string> traceFile;
+    std::size_t traceRecords = std::size_t{1} << 22; // 128 MiB of records
+    bool headless = false;
+    bool instructionStepped = false;
+    bool scanlinePPU = false;
+    std::optional<std::size_t> rewindMegabytes; // default: 64 with a window
+    uint32_t runAheadFrames = 0;
+    ScalerKind scalerKind = ScalerKind::GPU;
+    std::optional<PacingMode> pacingMode; // default: audio if there is sound
+    uint64_t headlessFrames = 600; // 10 seconds of NTSC emulation
+    std::optional<std::string> romDatabase;
+    for (int i = 2; i < argc; i++) {
+        const std::string option(argv[i]);
+        if (option == "--trace") {
             enableTrace = true;
+        } else if (option == "--trace-file" && i + 1 < argc) {
+            traceFile = argv[++i];
+        } else if (option == "--trace-records" && i + 1 < argc) {
+            traceRecords = std::stoull(argv[++i]);
+        } else if (option == "--headless") {
+            headless = true;
+        } else if (option == "--instruction-stepped") {
+            instructionStepped = true;
+        } else if (option == "--scanline-ppu") {
+            scanlinePPU = true;
+        } else if (option == "--rewind-mb" && i + 1 < argc) {
+            rewindMegabytes = std::stoull(argv[++i]);
+        } else if (option == "--run-ahead" && i + 1 < argc) {
+            runAheadFrames = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (option == "--scaler" && i + 1 < argc) {
+            scalerKind = scalerKindFromName(argv[++i]);
+        } else if (option == "--pacing" && i + 1 < argc) {
+            pacingMode = pacingModeFromName(argv[++i]);
+        } else if (option == "--frames" && i + 1 < argc) {
+            headlessFrames = std::stoull(argv[++i]);
+        } else if (option == "--rom-db" && i + 1 < argc) {
+            romDatabase = argv[++i];
         } else {
-            throw std::invalid_argument("Unknown option: " +
-                                        std::string(argv[2]));
+            throw std::invalid_argument("Unknown option: " + option + "\n" +
+                                        usage);
         }
     }
 
+    // header corrections for known bad dumps, before the ROM is loaded
+    if (romDatabase) {
+        RomDatabase::install(RomDatabase::readFile(*romDatabase));
+    }
+
+    // mapped read-only, the cartridge reads ROM from the file mapping
+    const std::shared_ptr<const RomImage> romImage = RomImage::open(argv[1]);
+    const SyncMode syncMode = instructionStepped ? SyncMode::InstructionStepped
+                                                 : SyncMode::CycleStepped;
+    const PPURenderMode renderMode =
+        scanlinePPU ? PPURenderMode::Scanline : PPURenderMode::Dot;
+
+    // binary trace of the last traceRecords instructions, see nesemu_trace
+    std::unique_ptr<TraceRecorder> traceRecorder;
+    if (traceFile) {
+        traceRecorder =
+            std::make_unique<TraceRecorder>(*traceFile, traceRecords);
+    }
+
+    if (headless) {
+        NES nes(romImage);
+        if (traceRecorder) {
+            nes.log.recordTo(traceRecorder.get());
+        } else if (!enableTrace) {
+            nes.log.mute();
+        }
+        nes.clock.setSyncMode(syncMode);
+        nes.ppu.setRenderMode(renderMode);
+        nes.clock.setRewindBudget(rewindMegabytes.value_or(0));
+        nes.clock.setRunAhead(runAheadFrames);
+        const HeadlessResult result = nes.runHeadless(headlessFrames);
+        printHeadlessReport(nes, result);
+        if (rewindMegabytes.value_or(0) > 0) {
+            printRewindReport(nes.clock.getRewindStats());
+        }
+        if (runAheadFrames > 0) {
+            printRunAheadReport(nes.clock.getRunAheadStats());
+        }
+        return 0;
+    }
+
     SDL_Window *sdlWindow = nullptr;
     SDL_Renderer *sdlRenderer = nullptr;
     SDL_Texture *sdlTexture = nullptr;
-    initialise_SDL(sdlWindow, sdlRenderer, sdlTexture);
+    std::unique_ptr<Scaler> scaler = makeScaler(scalerKind, SCREEN_SCALING);
+    initialise_SDL(sdlWindow, sdlRenderer, sdlTexture, scaler->outputWidth(),
+                   scaler->outputHeight());
 
-    std::vector<uint8_t> romDump = readROM(argv[1]); // read ROM from file
-    Renderer renderer(sdlWindow, sdlRenderer, sdlTexture);
-    NES nes(std::move(renderer), romDump); // instantiate a virtual NES console
-    if (!enableTrace) {
+    // outlives the console and audio device, it shuts SDL down
+    SDLFrontend frontend(
+        Renderer(sdlWindow, sdlRenderer, sdlTexture, std::move(scaler)));
+    NES nes(romImage); // instantiate a virtual NES console
+    if (traceRecorder) {
+        nes.log.recordTo(traceRecorder.get());
+    } else if (!enableTrace) {
         nes.log.mute();
     }
-    nes.start();
+    nes.clock.setSyncMode(syncMode);
+    nes.ppu.setRenderMode(renderMode);
+    nes.clock.setRewindBudget(rewindMegabytes.value_or(64));
+    nes.clock.setRunAhead(runAheadFrames);
+
+    // without an audio device the console runs silently
+    std::unique_ptr<AudioDevice> audio;
+    try {
+        audio = std::make_unique<AudioDevice>(
+            nes.apu.output(), static_cast<int>(nes.apu.getSampleRate()));
+    } catch (const std::runtime_error &e) {
+        std::cerr << "Warning: " << e.what() << std::endl;
+    }
+
+    // without sound there is no audio rate to steer
+    PacingMode pacing =
+        pacingMode.value_or(audio ? PacingMode::Audio : PacingMode::Timer);
+    if (pacing == PacingMode::Audio && !audio) {
+        pacing = PacingMode::Timer;
+    }
+    if (pacing == PacingMode::VSync) {
+        const double refresh = displayRefreshRate(sdlWindow);
+        const double frameRate = nes.clock.getFrameRate();
+        if (std::abs(refresh - frameRate) >
+            frameRate * Clock::MAX_RATE_ADJUSTMENT) {
+            std::cerr << "Warning: display refreshes at " << refresh
+                      << " Hz, too far from the console's " << frameRate
+                      << " Hz to pace by VSync" << std::endl;
+            pacing = audio ? PacingMode::Audio : PacingMode::Timer;
+        }
+    }
+    nes.clock.setPacing(pacing);
+
+    nes.start(frontend);
+    printPacingReport(nes.clock.getPacingStats());
+    if (rewindMegabytes.value_or(64) > 0) {
+        printRewindReport(nes.clock.getRewindStats());
+    }
+    if (runAheadFrames > 0) {
+        printRunAheadReport(nes.clock.getRunAheadStats());
+    }
 
     return 0;
 }
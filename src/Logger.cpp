@@ -1,228 +1,213 @@
 #include "../include/Logger.h"
 
-#include <iomanip>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
 #include <iostream>
-#include <sstream>
-
-std::string Logger::disassembleInstr(const CPUState &state) {
-    // helper to print 2-digit hex (uppercase) with leading zeros
-    auto hex2 = [&](uint8_t v) {
-        std::ostringstream oss;
-        oss << std::uppercase << std::setw(2) << std::setfill('0') << std::hex
-            << (int)v;
-        return oss.str();
-    };
-
-    // helper to print 4-digit hex (uppercase) with leading zeros
-    auto hex4 = [&](uint16_t v) {
-        std::ostringstream oss;
-        oss << std::uppercase << std::setw(4) << std::setfill('0') << std::hex
-            << (int)v;
-        return oss.str();
-    };
-
-    // start building disassembly string: "name "
-    std::ostringstream out;
-
-    if (state.op.isDocumented) {
-        out << " ";
-    } else {
-        out << "*";
+#include <string_view>
+
+#include "../include/CPU/OpCode.h"
+
+namespace {
+
+/**
+ * Writes fields left to right into a line buffer, no allocation or streams.
+ */
+class LineWriter {
+  private:
+    static constexpr char HEX[] = "0123456789ABCDEF";
+    char *line;
+    std::size_t pos = 0;
+
+  public:
+    explicit LineWriter(char *line) : line(line) {}
+
+    std::size_t length() const { return pos; }
+    void column(std::size_t column) { pos = column; }
+
+    void text(std::string_view text) {
+        std::memcpy(line + pos, text.data(), text.size());
+        pos += text.size();
+    }
+
+    void hex2(uint8_t value) {
+        line[pos++] = HEX[value >> 4];
+        line[pos++] = HEX[value & 0x0F];
+    }
+
+    void hex4(uint16_t value) {
+        hex2(static_cast<uint8_t>(value >> 8));
+        hex2(static_cast<uint8_t>(value));
     }
-    out << std::uppercase << state.op.name << " ";
 
-    // For the addressing modes, build the operand string in nestest style.
-    switch (state.op.mode) {
+    // right aligned in width characters, wider if it does not fit
+    void decimal(uint64_t value, std::size_t width = 0) {
+        char digits[20];
+        const std::size_t count =
+            std::to_chars(digits, digits + sizeof(digits), value).ptr - digits;
+        for (std::size_t i = count; i < width; i++) {
+            line[pos++] = ' ';
+        }
+        text({digits, count});
+    }
+};
+
+// e.g. " LDA ($89),Y = 0300 @ 0300 = 89", "*NOP $04 = 00"
+void disassemble(LineWriter &out, const TraceRecord &record) {
+    const OpCode *op = OpCode::getOpCode(record.opBytes[0]);
+    if (op == nullptr) {
+        out.text("*???");
+        return;
+    }
+    out.text(op->isDocumented() ? " " : "*");
+    out.text(op->name());
+    out.text(" ");
+
+    const uint16_t absolute =
+        static_cast<uint16_t>((record.opBytes[2] << 8) | record.opBytes[1]);
+    switch (op->mode) {
     case AddressingMode::Implied:
-        // e.g. "CLC", "INX", no operand needed
-        // out << "" (nothing)
         break;
 
     case AddressingMode::Acc:
-        // e.g. "ROL A"
-        out << "A";
+        out.text("A");
         break;
 
     case AddressingMode::Immediate:
-        // e.g. "CMP #$AA"
-        out << "#$" << hex2(state.opBytes.at(1));
+        out.text("#$");
+        out.hex2(record.opBytes[1]);
         break;
 
     case AddressingMode::Relative:
-        // e.g. "BNE $D038"
-        // The final address is already in addrInfo.address
-        out << "$" << hex4(state.addrInfo.address);
+        // the branch target, whether or not it was taken
+        out.text("$");
+        out.hex4(record.address);
         break;
 
     case AddressingMode::ZeroPage:
-        // e.g. "LDA $03 = AB"
-        out << "$" << hex2(state.opBytes.at(1));
-        out << " = " << hex2(state.valueAtAddr);
+        out.text("$");
+        out.hex2(record.opBytes[1]);
+        out.text(" = ");
+        out.hex2(record.valueAtAddr);
         break;
 
     case AddressingMode::ZeroPageX:
-        // e.g. "LDA $03,X = AB"
-        out << "$" << hex2(state.opBytes.at(1)) << ",X";
-        out << " @ "
-            << hex2(state.addrInfo.address); // Include computed address
-        out << " = " << hex2(state.valueAtAddr);
-        break;
-
     case AddressingMode::ZeroPageY:
-        // e.g. "LDA $03,Y = AB"
-        out << "$" << hex2(state.opBytes.at(1)) << ",Y";
-        out << " @ "
-            << hex2(state.addrInfo.address); // Include computed address
-        out << " = " << hex2(state.valueAtAddr);
+        out.text("$");
+        out.hex2(record.opBytes[1]);
+        out.text(op->mode == AddressingMode::ZeroPageX ? ",X @ " : ",Y @ ");
+        out.hex2(static_cast<uint8_t>(record.address));
+        out.text(" = ");
+        out.hex2(record.valueAtAddr);
         break;
 
-    case AddressingMode::Absolute:
-        out << "$" << hex4((state.opBytes.at(2) << 8) | state.opBytes.at(1));
-        if (state.op.name != "JSR" &&
-            state.op.name != "JMP") { // Skip = XX for JSR and JMP
-            out << " = " << hex2(state.valueAtAddr);
+    case AddressingMode::Absolute: {
+        out.text("$");
+        out.hex4(absolute);
+        const std::string_view name = op->name();
+        if (name != "JSR" && name != "JMP") { // no value for jumps
+            out.text(" = ");
+            out.hex2(record.valueAtAddr);
         }
         break;
+    }
 
     case AddressingMode::AbsoluteX:
-        out << "$" << hex4((state.opBytes.at(2) << 8) | state.opBytes.at(1))
-            << ",X";
-        out << " @ "
-            << hex4(state.addrInfo.address); // Include computed address
-        out << " = " << hex2(state.valueAtAddr);
-        break;
-
     case AddressingMode::AbsoluteY:
-        out << "$" << hex4((state.opBytes.at(2) << 8) | state.opBytes.at(1))
-            << ",Y";
-        out << " @ "
-            << hex4(state.addrInfo.address); // Include computed address
-        out << " = " << hex2(state.valueAtAddr);
+        out.text("$");
+        out.hex4(absolute);
+        out.text(op->mode == AddressingMode::AbsoluteX ? ",X @ " : ",Y @ ");
+        out.hex4(record.address);
+        out.text(" = ");
+        out.hex2(record.valueAtAddr);
         break;
 
     case AddressingMode::Indirect:
-        out << "($" << hex4((state.opBytes.at(2) << 8) | state.opBytes.at(1))
-            << ")";
-        out << " = "
-            << hex4(state.addrInfo
-                        .address); // Show final resolved address, no = XX
+        // the jump target, no value
+        out.text("($");
+        out.hex4(absolute);
+        out.text(") = ");
+        out.hex4(record.address);
         break;
 
     case AddressingMode::IndirectX:
-        out << "($" << hex2(state.opBytes.at(1)) << ",X)";
-        out << " @ "
-            << hex2(state.addrInfo
-                        .pointerAddress); // Intermediate zero-page pointer
-        out << " = " << hex4(state.addrInfo.address); // Final resolved address
-        out << " = " << hex2(state.valueAtAddr);      // Value at final address
+        out.text("($");
+        out.hex2(record.opBytes[1]);
+        out.text(",X) @ ");
+        out.hex2(static_cast<uint8_t>(record.pointerAddress));
+        out.text(" = ");
+        out.hex4(record.address);
+        out.text(" = ");
+        out.hex2(record.valueAtAddr);
         break;
 
     case AddressingMode::IndirectY:
-        // Expected format: "LDA ($89),Y = 0300 @ 0300 = 89"
-        out << "($" << hex2(state.opBytes.at(1)) << "),Y";
-        out << " = "
-            << hex4(state.addrInfo.pointerAddress); // Show base pointer
-        out << " @ "
-            << hex4(state.addrInfo.address);     // Show final computed address
-        out << " = " << hex2(state.valueAtAddr); // Show value at final address
+        out.text("($");
+        out.hex2(record.opBytes[1]);
+        out.text("),Y = ");
+        out.hex4(record.pointerAddress);
+        out.text(" @ ");
+        out.hex4(record.address);
+        out.text(" = ");
+        out.hex2(record.valueAtAddr);
         break;
 
     default:
-        // Fallback if you have other modes not shown
         break;
     }
-
-    return out.str();
 }
 
-void Logger::log(const CPUState &state) {
-    if (silenced)
-        return;
-
-    std::string line(94, ' '); // allocate 94 char string
-    // std::string line(73, ' ');  // allocate 73 char string (no ppu + cycle)
-
-    // Field 1: PC at index 0 (4 characters)
-    {
-        std::ostringstream oss;
-        oss << std::uppercase << std::hex << std::setw(4) << std::setfill('0')
-            << state.pc;
-        line.replace(0, 4, oss.str());
-    }
-
-    // Field 2: Opcode bytes at index 6 (9 characters wide)
-    {
-        std::ostringstream oss;
-        oss << std::uppercase << std::hex << std::setfill('0');
-        // Print up to 3 opcode bytes separated by spaces.
-        for (size_t i = 0; i < state.opBytes.size() && i < 3; i++) {
-            oss << std::setw(2) << static_cast<int>(state.opBytes.at(i));
-            if (i < 2) {
-                oss << " ";
-            }
-        }
-        std::string opStr = oss.str();
-        // Pad the opcode field to exactly 9 characters.
-        if (opStr.size() < 9) {
-            opStr.append(9 - opStr.size(), ' ');
-        }
-        line.replace(6, 9, opStr);
-    }
+} // namespace
 
-    // Field 3: Disassembly at index 17 (28 characters wide)
-    {
-        std::string dis = disassembleInstr(state);
-        if (dis.size() < 31) {
-            dis.append(31 - dis.size(), ' ');
-        } else if (dis.size() > 31) {
-            dis = dis.substr(0, 31);
-        }
-        line.replace(15, 31, dis);
-    }
+std::size_t Logger::format(const TraceRecord &record, char *line) {
+    constexpr std::size_t DISASSEMBLY_COLUMN = 15;
+    constexpr std::size_t DISASSEMBLY_WIDTH = 31;
+    constexpr std::size_t CYCLES_COLUMN = 86;
 
-    // Field 4: Registers at index 49 (25 characters wide)
-    // Format: "A:XX X:XX Y:XX P:XX SP:XX"
-    {
-        std::ostringstream oss;
-        oss << std::uppercase << std::hex << std::setfill('0')
-            << "A:" << std::setw(2) << static_cast<int>(state.A) << " "
-            << "X:" << std::setw(2) << static_cast<int>(state.X) << " "
-            << "Y:" << std::setw(2) << static_cast<int>(state.Y) << " "
-            << "P:" << std::setw(2) << static_cast<int>(state.P) << " "
-            << "SP:" << std::setw(2) << static_cast<int>(state.SP);
-        std::string regStr = oss.str();
-        if (regStr.size() < 25) {
-            regStr.append(25 - regStr.size(), ' ');
-        } else if (regStr.size() > 25) {
-            regStr = regStr.substr(0, 25);
-        }
-        line.replace(48, 25, regStr);
-    }
+    std::memset(line, ' ', CYCLES_COLUMN);
+    LineWriter out(line);
+    out.hex4(record.pc);
 
-    // Field 5: PPU at index 75 (11 characters wide)
-    // Format: "PPU:XXX,YYY"
-    {
-        std::ostringstream oss;
-        // Use "PPU:" without an extra trailing space
-        oss << "PPU:" << std::setw(3) << std::setfill(' ') << std::right
-            << state.ppuX << "," << std::setw(3) << std::setfill(' ')
-            << std::right << state.ppuY;
-        std::string ppuStr = oss.str();
-        if (ppuStr.size() < 11) {
-            ppuStr.append(11 - ppuStr.size(), ' ');
-        } else if (ppuStr.size() > 11) {
-            ppuStr = ppuStr.substr(0, 11);
-        }
-        line.replace(74, 11, ppuStr);
+    for (std::size_t i = 0; i < record.opByteCount && i < 3; i++) {
+        out.column(6 + i * 3);
+        out.hex2(record.opBytes[i]);
     }
 
-    // Field 6: Cycles at index 86 (8 characters wide)
-    // Format: "CYC:XXXX" (no extra preceding space)
-    {
-        std::ostringstream oss;
-        oss << "CYC:" << state.cycles;
-        line.replace(86, 8, oss.str());
-    }
+    // disassembled in place, then cut to its field and the rest blanked
+    out.column(DISASSEMBLY_COLUMN);
+    disassemble(out, record);
+    const std::size_t end =
+        std::min(out.length(), DISASSEMBLY_COLUMN + DISASSEMBLY_WIDTH);
+    std::memset(line + end, ' ', CYCLES_COLUMN - end);
+
+    out.column(48);
+    out.text("A:");
+    out.hex2(record.A);
+    out.text(" X:");
+    out.hex2(record.X);
+    out.text(" Y:");
+    out.hex2(record.Y);
+    out.text(" P:");
+    out.hex2(record.P);
+    out.text(" SP:");
+    out.hex2(record.SP);
+
+    out.column(74);
+    out.text("PPU:");
+    out.decimal(record.ppuX, 3);
+    out.text(",");
+    out.decimal(record.ppuY, 3);
+
+    out.column(CYCLES_COLUMN);
+    out.text("CYC:");
+    out.decimal(record.cycles);
+    return out.length();
+}
 
-    std::cout << line << "\r\n";
+void Logger::print(const TraceRecord &record) {
+    char line[MAX_LINE_LENGTH + 2];
+    std::size_t length = format(record, line);
+    line[length++] = '\r';
+    line[length++] = '\n';
+    std::cout.write(line, static_cast<std::streamsize>(length));
 }
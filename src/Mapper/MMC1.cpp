@@ -0,0 +1,109 @@
+#include "../../include/Mapper/MMC1.h"
+
+#include "../../include/SaveState.h"
+
+MMC1::MMC1(std::size_t prgSize, std::size_t chrSize, MirroringMode mirroring)
+    : Mapper(prgSize, chrSize, mirroring) {
+    updateBanks();
+}
+
+/**
+ * Writes with bit 7 set reset the shift register and return to PRG mode 3.
+ * Otherwise bit 0 is shifted in, and the fifth write commits.
+ * Writes on consecutive CPU cycles (RMW instructions) are not ignored as on
+ * hardware.
+ */
+void MMC1::writeRegister(uint16_t addr, uint8_t value) {
+    if (value & 0x80) {
+        shift = 0;
+        shiftCount = 0;
+        control |= 0x0C;
+        updateBanks();
+        return;
+    }
+
+    shift |= static_cast<uint8_t>((value & 0x01) << shiftCount);
+    if (++shiftCount < 5) {
+        return;
+    }
+
+    switch ((addr >> 13) & 0x03) {
+    case 0:
+        control = shift;
+        break;
+    case 1:
+        chrBank0 = shift;
+        break;
+    case 2:
+        chrBank1 = shift;
+        break;
+    case 3:
+        prgBank = shift;
+        break;
+    }
+    shift = 0;
+    shiftCount = 0;
+    updateBanks();
+}
+
+void MMC1::updateBanks() {
+    switch (control & 0x03) {
+    case 0:
+        mirroring = MirroringMode::SingleScreenLower;
+        break;
+    case 1:
+        mirroring = MirroringMode::SingleScreenUpper;
+        break;
+    case 2:
+        mirroring = MirroringMode::Vertical;
+        break;
+    case 3:
+        mirroring = MirroringMode::Horizontal;
+        break;
+    }
+
+    // SUROM: bit 4 of the CHR bank register picks the 256 KiB half of a
+    // 512 KiB PRG ROM. Harmless on smaller boards, where it wraps away.
+    const int outer = (chrBank0 & 0x10);
+    const int bank = prgBank & 0x0F;
+    switch ((control >> 2) & 0x03) {
+    case 0:
+    case 1:
+        setPrg16k(0, outer | (bank & ~0x01));
+        setPrg16k(1, outer | (bank | 0x01));
+        break;
+    case 2:
+        setPrg16k(0, outer);
+        setPrg16k(1, outer | bank);
+        break;
+    case 3:
+        setPrg16k(0, outer | bank);
+        setPrg16k(1, outer | 0x0F);
+        break;
+    }
+
+    if (control & 0x10) {
+        setChr4k(0, chrBank0);
+        setChr4k(1, chrBank1);
+    } else {
+        setChr8k(chrBank0 >> 1);
+    }
+}
+
+void MMC1::saveRegisters(StateWriter &out) const {
+    out.write(shift);
+    out.write(shiftCount);
+    out.write(control);
+    out.write(chrBank0);
+    out.write(chrBank1);
+    out.write(prgBank);
+}
+
+void MMC1::loadRegisters(StateReader &in) {
+    in.read(shift);
+    in.read(shiftCount);
+    in.read(control);
+    in.read(chrBank0);
+    in.read(chrBank1);
+    in.read(prgBank);
+}
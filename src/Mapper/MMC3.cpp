@@ -0,0 +1,105 @@
+#include "../../include/Mapper/MMC3.h"
+
+#include "../../include/SaveState.h"
+
+MMC3::MMC3(std::size_t prgSize, std::size_t chrSize, MirroringMode mirroring)
+    : Mapper(prgSize, chrSize, mirroring),
+      fourScreen(mirroring == MirroringMode::FourScreen) {
+    updateBanks();
+}
+
+/**
+ * Registers are decoded from address bits 13-14 and bit 0 (even/odd).
+ * PRG RAM protection ($A001) is not modelled, PRG RAM is always writable.
+ */
+void MMC3::writeRegister(uint16_t addr, uint8_t value) {
+    const bool odd = (addr & 0x01) != 0;
+    switch (addr & 0xE000) {
+    case 0x8000:
+        if (odd) {
+            registers[bankSelect & 0x07] = value;
+        } else {
+            bankSelect = value;
+        }
+        updateBanks();
+        break;
+    case 0xA000:
+        if (!odd && !fourScreen) {
+            mirroring = (value & 0x01) ? MirroringMode::Horizontal
+                                       : MirroringMode::Vertical;
+        }
+        break;
+    case 0xC000:
+        if (odd) {
+            irqCounter = 0;
+            irqReload = true;
+        } else {
+            irqLatch = value;
+        }
+        break;
+    case 0xE000:
+        // $E000 also acknowledges a pending IRQ
+        irqEnabled = odd;
+        if (!odd) {
+            irq = false;
+        }
+        break;
+    }
+}
+
+/**
+ * Clocks the scanline counter. With the usual setup (background at $0000,
+ * sprites at $1000) A12 rises once per rendered scanline.
+ */
+void MMC3::ppuA12Rise() {
+    if (irqCounter == 0 || irqReload) {
+        irqCounter = irqLatch;
+        irqReload = false;
+    } else {
+        irqCounter--;
+    }
+    if (irqCounter == 0 && irqEnabled) {
+        irq = true;
+    }
+}
+
+void MMC3::updateBanks() {
+    if (bankSelect & 0x40) {
+        setPrg8k(0, -2);
+        setPrg8k(2, registers[6] & 0x3F);
+    } else {
+        setPrg8k(0, registers[6] & 0x3F);
+        setPrg8k(2, -2);
+    }
+    setPrg8k(1, registers[7] & 0x3F);
+    setPrg8k(3, -1);
+
+    // A12 inversion swaps the 2 KiB and 1 KiB halves of pattern memory
+    const std::size_t twoKiBHalf = (bankSelect & 0x80) ? 4 : 0;
+    const std::size_t oneKiBHalf = 4 - twoKiBHalf;
+    setChr1k(twoKiBHalf + 0, registers[0] & 0xFE);
+    setChr1k(twoKiBHalf + 1, registers[0] | 0x01);
+    setChr1k(twoKiBHalf + 2, registers[1] & 0xFE);
+    setChr1k(twoKiBHalf + 3, registers[1] | 0x01);
+    for (std::size_t i = 0; i < 4; i++) {
+        setChr1k(oneKiBHalf + i, registers[2 + i]);
+    }
+}
+
+void MMC3::saveRegisters(StateWriter &out) const {
+    out.write(registers);
+    out.write(bankSelect);
+    out.write(irqLatch);
+    out.write(irqCounter);
+    out.write(irqReload);
+    out.write(irqEnabled);
+}
+
+void MMC3::loadRegisters(StateReader &in) {
+    in.read(registers);
+    in.read(bankSelect);
+    in.read(irqLatch);
+    in.read(irqCounter);
+    in.read(irqReload);
+    in.read(irqEnabled);
+}
@@ -0,0 +1,139 @@
+#include "../../include/Mapper/Mapper.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "../../include/Mapper/AxROM.h"
+#include "../../include/Mapper/CNROM.h"
+#include "../../include/Mapper/MMC1.h"
+#include "../../include/Mapper/MMC3.h"
+#include "../../include/Mapper/NROM.h"
+#include "../../include/Mapper/UxROM.h"
+#include "../../include/SaveState.h"
+
+std::unique_ptr<Mapper> Mapper::create(uint16_t id, std::size_t prgSize,
+                                       std::size_t chrSize,
+                                       MirroringMode mirroring) {
+    switch (id) {
+    case 0:
+        return std::make_unique<NROM>(prgSize, chrSize, mirroring);
+    case 1:
+        return std::make_unique<MMC1>(prgSize, chrSize, mirroring);
+    case 2:
+        return std::make_unique<UxROM>(prgSize, chrSize, mirroring);
+    case 3:
+        return std::make_unique<CNROM>(prgSize, chrSize, mirroring);
+    case 4:
+        return std::make_unique<MMC3>(prgSize, chrSize, mirroring);
+    case 7:
+        return std::make_unique<AxROM>(prgSize, chrSize);
+    default:
+        throw std::runtime_error("mapper not implemented: " +
+                                 std::to_string(id));
+    }
+}
+
+Mapper::Mapper(std::size_t prgSize, std::size_t chrSize,
+               MirroringMode mirroring)
+    : mirroring(mirroring), prgSize(prgSize), chrSize(chrSize) {}
+
+std::size_t Mapper::bankOffset(int bank, std::size_t bankSize,
+                               std::size_t memorySize) {
+    const int count = static_cast<int>(memorySize / bankSize);
+    if (count == 0) {
+        return 0;
+    }
+    bank %= count;
+    if (bank < 0) {
+        bank += count;
+    }
+    return static_cast<std::size_t>(bank) * bankSize;
+}
+
+std::size_t Mapper::readBank(StateReader &in, std::size_t bankSize,
+                             std::size_t memorySize) {
+    const uint32_t bank = in.read<uint32_t>();
+    const std::size_t count = std::max<std::size_t>(memorySize / bankSize, 1);
+    if (bank >= count) {
+        throw std::runtime_error("Bank " + std::to_string(bank) +
+                                 " in save state is out of range");
+    }
+    return bankOffset(static_cast<int>(bank), bankSize, memorySize);
+}
+
+void Mapper::setPrg8k(std::size_t window, int bank) {
+    prgBanks[window] = bankOffset(bank, PRG_WINDOW, prgSize);
+}
+
+void Mapper::setPrg16k(std::size_t window, int bank) {
+    setPrg8k(window * 2, bank * 2);
+    setPrg8k(window * 2 + 1, bank * 2 + 1);
+}
+
+void Mapper::setPrg32k(int bank) {
+    for (int i = 0; i < 4; i++) {
+        setPrg8k(static_cast<std::size_t>(i), bank * 4 + i);
+    }
+}
+
+void Mapper::setChr1k(std::size_t window, int bank) {
+    chrBanks[window] = bankOffset(bank, CHR_WINDOW, chrSize);
+}
+
+void Mapper::setChr2k(std::size_t window, int bank) {
+    setChr1k(window * 2, bank * 2);
+    setChr1k(window * 2 + 1, bank * 2 + 1);
+}
+
+void Mapper::setChr4k(std::size_t window, int bank) {
+    for (int i = 0; i < 4; i++) {
+        setChr1k(window * 4 + static_cast<std::size_t>(i), bank * 4 + i);
+    }
+}
+
+void Mapper::setChr8k(int bank) {
+    for (int i = 0; i < 8; i++) {
+        setChr1k(static_cast<std::size_t>(i), bank * 8 + i);
+    }
+}
+
+/**
+ * Bank tables are saved as bank numbers, so a state can only ever select
+ * banks of the memory present.
+ */
+void Mapper::saveState(StateWriter &out) const {
+    for (std::size_t offset : prgBanks) {
+        out.write(static_cast<uint32_t>(offset / PRG_WINDOW));
+    }
+    for (std::size_t offset : chrBanks) {
+        out.write(static_cast<uint32_t>(offset / CHR_WINDOW));
+    }
+    out.write(mirroring);
+    out.write(irq);
+    saveRegisters(out);
+}
+
+/**
+ * Throws std::runtime_error if the state selects a bank beyond the end of
+ * PRG or CHR memory, or an unknown mirroring mode.
+ */
+void Mapper::loadState(StateReader &in) {
+    std::array<std::size_t, PRG_WINDOWS> newPrgBanks;
+    for (std::size_t &offset : newPrgBanks) {
+        offset = readBank(in, PRG_WINDOW, prgSize);
+    }
+    std::array<std::size_t, CHR_WINDOWS> newChrBanks;
+    for (std::size_t &offset : newChrBanks) {
+        offset = readBank(in, CHR_WINDOW, chrSize);
+    }
+    const MirroringMode newMirroring = in.read<MirroringMode>();
+    if (newMirroring > MirroringMode::SingleScreenUpper) {
+        throw std::runtime_error("Bad mirroring mode in save state");
+    }
+    prgBanks = newPrgBanks;
+    chrBanks = newChrBanks;
+    mirroring = newMirroring;
+    in.read(irq);
+    loadRegisters(in);
+}
@@ -1,26 +1,25 @@
 #include "../../include/PPU/PPU.h"
+#include <algorithm>
 #include <string>
 
+#include "../../include/SaveState.h"
+
 namespace {
 
 // Sprite rendering happens after the background pass, so it writes directly
-// into the frame buffer instead of advancing Frame::currentPixel.
+// into the frame buffer instead of advancing Frame::currentPixelIndex.
 inline void setFramePixel(Frame &frame, int x, int y, uint8_t colour) {
     if (x < 0 || x >= SCREEN_WIDTH || y < 0 || y >= SCREEN_HEIGHT) {
         return;
     }
 
-    const std::size_t index = 3 * (static_cast<std::size_t>(y) * SCREEN_WIDTH +
-                                   static_cast<std::size_t>(x));
-    if (index + 2 >= frame.pixelData.size()) {
+    const std::size_t index =
+        static_cast<std::size_t>(y) * SCREEN_WIDTH + static_cast<std::size_t>(x);
+    if (index >= frame.pixelData.size()) {
         return;
     }
 
-    uint8_t r, g, b;
-    std::tie(r, g, b) = NES_PALETTE[colour & 0x3F];
-    frame.pixelData[index] = r;
-    frame.pixelData[index + 1] = g;
-    frame.pixelData[index + 2] = b;
+    frame.pixelData[index] = colour & 0x3F;
 }
 
 inline bool frameBackgroundPixelOpaque(const Frame &frame, int x, int y) {
@@ -36,13 +35,6 @@ inline bool frameBackgroundPixelOpaque(const Frame &frame, int x, int y) {
     return frame.backgroundOpaque[index] != 0;
 }
 
-inline uint8_t decodePatternPixel(uint8_t patternLow, uint8_t patternHigh,
-                                  uint8_t bit) {
-    const uint8_t lowBit = (patternLow >> bit) & 0x01;
-    const uint8_t highBit = (patternHigh >> bit) & 0x01;
-    return static_cast<uint8_t>((highBit << 1) | lowBit);
-}
-
 } // namespace
 
 uint8_t PPU::mirrorPaletteAddress(uint8_t addr) {
@@ -66,21 +58,218 @@ void PPU::pushBackgroundPixelPair(Frame &frame, uint8_t attributeQuadrant,
 
     for (int bit = leftBit; bit >= static_cast<int>(leftBit) - 1; --bit) {
         const uint8_t pixelValue =
-            backgroundRenderingEnabled
-                ? decodePatternPixel(patternLow, patternHigh,
-                                     static_cast<uint8_t>(bit))
-                : 0;
+            backgroundRenderingEnabled ? tilePixels[7 - bit] : 0;
         const uint8_t paletteIndex = mirrorPaletteAddress(static_cast<uint8_t>(
             pixelValue == 0 ? 0 : (paletteSelection * 4) + pixelValue));
-        frame.push(palette_table[paletteIndex], pixelValue != 0);
+        if (videoOutput) {
+            frame.push(palette_table[paletteIndex], pixelValue != 0);
+        }
+
+        const int screenX = (cycles & ~0x07) + (7 - bit);
+        evaluateSpriteZeroHit(screenX, scanline, pixelValue != 0);
+    }
+}
+
+// Produces the same fetches, pixels and sprite zero hits as the visible-dot
+// branch of tick() for dots [from, to) of the current scanline. Anything that
+// cannot change without a register write is computed once per call.
+void PPU::renderBackgroundDots(uint16_t from, uint16_t to) {
+    if (from >= to) {
+        return;
+    }
+
+    const int scrolledY = scanline + scroll.scroll_y;
+    const uint8_t pixelY = static_cast<uint8_t>(scrolledY % SCREEN_HEIGHT);
+    const uint8_t coarseY = static_cast<uint8_t>(pixelY >> 3);
+    const uint8_t fineY = static_cast<uint8_t>(pixelY & 0x07);
+
+    const uint16_t baseNametable = ctrl.nametable_addr();
+    const uint8_t baseNtX = static_cast<uint8_t>(
+        (baseNametable == 0x2400 || baseNametable == 0x2C00) ? 1 : 0);
+    const uint8_t baseNtY =
+        static_cast<uint8_t>((baseNametable >= 0x2800) ? 1 : 0);
+    const uint8_t ntY = static_cast<uint8_t>(
+        (baseNtY + (scrolledY / SCREEN_HEIGHT)) & 0x01);
+
+    // Mirroring is linear within a nametable, so only the two nametables a
+    // scanline can scroll across need mirroring.
+    std::array<uint16_t, 2> nametableBase{};
+    for (uint8_t ntX = 0; ntX < 2; ntX++) {
+        nametableBase[ntX] = mirrorVRAMAddress(static_cast<uint16_t>(
+            0x2000 + (((ntY << 1) | ntX) * 0x400)));
+    }
+    const uint16_t tileRowOffset = static_cast<uint16_t>(coarseY * 32);
+    const uint16_t attributeRowOffset =
+        static_cast<uint16_t>(0x03C0 + ((coarseY / 4) * 8));
+    const uint8_t attributeQuadrantY = (coarseY & 0x02) ? 2 : 0;
+    const uint16_t patternRow =
+        static_cast<uint16_t>(ctrl.bg_pattern_addr() + fineY);
+
+    const bool showBackground = mask.show_background();
+    const bool showLeftmostBackground = mask.leftmost_8pxl_background();
+
+    // Skip per-pixel sprite zero checks on scanlines sprite zero cannot hit.
+    const int spriteZeroY = static_cast<int>(oam_data[0]) + 1;
+    const bool checkSpriteZero =
+        (status.snapshot() & PPUStatus::SPRITE_ZERO_HIT) == 0 &&
+        showBackground && mask.show_sprites() && scanline >= spriteZeroY &&
+        scanline < spriteZeroY + ctrl.sprite_size();
+
+    Frame *frame = currentFrame;
+
+    for (uint16_t dot = from; dot < to; dot++) {
+        const int scrolledX = static_cast<int>(dot) + scroll.scroll_x;
+        const uint8_t ntX =
+            static_cast<uint8_t>((baseNtX + (scrolledX / SCREEN_WIDTH)) & 0x01);
+        const uint8_t coarseX =
+            static_cast<uint8_t>((scrolledX % SCREEN_WIDTH) >> 3);
+
+        const uint8_t phase = dot % 8;
+        switch (phase) {
+        case 0:
+            tileID = vram[nametableBase[ntX] + tileRowOffset + coarseX];
+            break;
+        case 1:
+            attribute = vram[nametableBase[ntX] + attributeRowOffset +
+                             (coarseX / 4)];
+            break;
+        case 2:
+            // both pattern planes arrive pre-decoded on phase 3
+            break;
+        case 3:
+            tilePixels = cart.read_chr_tile_row(
+                static_cast<uint16_t>(patternRow + (tileID * 16)), false);
+            break;
+        default: {
+            if (!videoOutput && !checkSpriteZero) {
+                break; // nothing visible depends on these pixels
+            }
+            const uint8_t attributeQuadrant = static_cast<uint8_t>(
+                attributeQuadrantY | ((coarseX & 0x02) ? 1 : 0));
+            const uint8_t paletteSelection = static_cast<uint8_t>(
+                (attribute >> (attributeQuadrant * 2)) & 0b11);
+            const bool backgroundRenderingEnabled =
+                showBackground && (showLeftmostBackground || dot >= 8);
+            const uint8_t leftBit = static_cast<uint8_t>(15 - (phase * 2));
+
+            for (int bit = leftBit; bit >= static_cast<int>(leftBit) - 1;
+                 --bit) {
+                const uint8_t pixelValue =
+                    backgroundRenderingEnabled ? tilePixels[7 - bit] : 0;
+                const uint8_t paletteIndex =
+                    mirrorPaletteAddress(static_cast<uint8_t>(
+                        pixelValue == 0 ? 0
+                                        : (paletteSelection * 4) + pixelValue));
+                if (videoOutput) {
+                    frame->push(palette_table[paletteIndex], pixelValue != 0);
+                }
+
+                if (checkSpriteZero) {
+                    const int screenX = (dot & ~0x07) + (7 - bit);
+                    evaluateSpriteZeroHit(screenX, scanline, pixelValue != 0);
+                }
+            }
+            break;
+        }
+        }
+    }
+}
 
-        const std::size_t pixelIndex = frame.currentPixelIndex - 1;
-        const int screenX = static_cast<int>(pixelIndex % SCREEN_WIDTH);
-        const int screenY = static_cast<int>(pixelIndex / SCREEN_WIDTH);
-        evaluateSpriteZeroHit(screenX, screenY, pixelValue != 0);
+void PPU::catchUpBackground() {
+    if (renderMode != PPURenderMode::Scanline || scanline >= 240) {
+        return;
+    }
+
+    const uint16_t elapsedDots = std::min<uint16_t>(cycles, SCREEN_WIDTH);
+    if (renderedDots < elapsedDots) {
+        renderBackgroundDots(renderedDots, elapsedDots);
+        renderedDots = elapsedDots;
     }
 }
 
+void PPU::setRenderMode(PPURenderMode mode) {
+    catchUpBackground();
+    renderMode = mode;
+    renderedDots = std::min<uint16_t>(cycles, SCREEN_WIDTH);
+}
+
+void PPU::setVideoOutput(bool enabled) {
+    catchUpBackground();
+    videoOutput = enabled;
+}
+
+void PPU::saveState(StateWriter &out) {
+    // a snapshot never holds undrawn dots, so loading works in either mode
+    catchUpBackground();
+
+    out.write(tileID);
+    out.write(attribute);
+    out.write(tilePixels);
+    out.write(ctrl);
+    out.write(mask);
+    out.write(status);
+    out.write(scroll);
+    out.write(addr);
+    out.write(data_buf);
+    out.write(oam_addr);
+    out.write(oam_data);
+    out.write(palette_table);
+    out.write(vram);
+    out.write(cycles);
+    out.write(scanline);
+    out.write(oddFrame);
+    out.write(nmiInterrupt);
+    out.write(suppressVblankThisFrame);
+    out.write(last_written_value);
+
+    // only the pixels pushed so far, between frames there are none
+    out.write(currentFrame != nullptr);
+    if (currentFrame) {
+        const std::size_t pixels = currentFrame->currentPixelIndex;
+        out.write(pixels);
+        out.writeBytes(currentFrame->pixelData.data(), pixels);
+        out.writeBytes(currentFrame->backgroundOpaque.data(), pixels);
+    }
+}
+
+void PPU::loadState(StateReader &in) {
+    in.read(tileID);
+    in.read(attribute);
+    in.read(tilePixels);
+    in.read(ctrl);
+    in.read(mask);
+    in.read(status);
+    in.read(scroll);
+    in.read(addr);
+    in.read(data_buf);
+    in.read(oam_addr);
+    in.read(oam_data);
+    in.read(palette_table);
+    in.read(vram);
+    in.read(cycles);
+    in.read(scanline);
+    in.read(oddFrame);
+    in.read(nmiInterrupt);
+    in.read(suppressVblankThisFrame);
+    in.read(last_written_value);
+    renderedDots = std::min<uint16_t>(cycles, SCREEN_WIDTH);
+
+    if (!in.read<bool>()) {
+        currentFrame = nullptr;
+        return;
+    }
+    const std::size_t pixels = in.read<std::size_t>();
+    if (pixels > static_cast<std::size_t>(SCREEN_WIDTH * SCREEN_HEIGHT)) {
+        throw std::runtime_error("Save state has an invalid frame size");
+    }
+    if (!currentFrame) {
+        beginFrame();
+    }
+    in.readBytes(currentFrame->pixelData.data(), pixels);
+    in.readBytes(currentFrame->backgroundOpaque.data(), pixels);
+    currentFrame->currentPixelIndex = pixels;
+}
+
 bool PPU::spriteZeroPixelOpaque(int screenX, int screenY) const {
     const uint8_t spriteHeight = ctrl.sprite_size();
     const int spriteY = static_cast<int>(oam_data[0]) + 1;
@@ -122,12 +311,8 @@ bool PPU::spriteZeroPixelOpaque(int screenX, int screenY) const {
 
     const uint16_t patternAddress =
         static_cast<uint16_t>(patternBase + (tileNumber * 16) + fineY);
-    const uint8_t patternLow = cart.read_chr_rom(patternAddress);
-    const uint8_t patternHigh = cart.read_chr_rom(patternAddress + 8);
-    const int bit = flipHorizontal ? spriteColumn : (7 - spriteColumn);
-
-    return decodePatternPixel(patternLow, patternHigh,
-                              static_cast<uint8_t>(bit)) != 0;
+    return cart.read_chr_tile_row(patternAddress,
+                                  flipHorizontal)[spriteColumn] != 0;
 }
 
 void PPU::evaluateSpriteZeroHit(int screenX, int screenY,
@@ -199,8 +384,8 @@ void PPU::renderSprites(Frame &frame) {
 
             const uint16_t patternAddress =
                 static_cast<uint16_t>(patternBase + (tileNumber * 16) + fineY);
-            const uint8_t patternLow = cart.read_chr_rom(patternAddress);
-            const uint8_t patternHigh = cart.read_chr_rom(patternAddress + 8);
+            const TileRow &spritePixels =
+                cart.read_chr_tile_row(patternAddress, flipHorizontal);
 
             for (int px = 0; px < 8; px++) {
                 const int screenX = spriteX + px;
@@ -211,9 +396,7 @@ void PPU::renderSprites(Frame &frame) {
                     continue;
                 }
 
-                const int bit = flipHorizontal ? px : (7 - px);
-                const uint8_t spritePixel = decodePatternPixel(
-                    patternLow, patternHigh, static_cast<uint8_t>(bit));
+                const uint8_t spritePixel = spritePixels[px];
                 if (spritePixel == 0) {
                     continue;
                 }
@@ -233,13 +416,39 @@ void PPU::renderSprites(Frame &frame) {
     }
 }
 
-std::optional<Frame> PPU::tick() {
+// Sprite patterns are fetched on dots 257-320 and the next scanline's first
+// background tiles on dots 321-336. Fetches are not modelled per dot, so A12
+// follows the pattern table of each fetch phase as it starts. 8x16 sprites
+// are assumed to come from $1000, where unused sprite slots fetch from.
+void PPU::clockPatternTableA12() {
+    if (cycles == 257) {
+        cart.ppuAddressA12(ctrl.sprite_size() == 16 ||
+                           ctrl.sprite_pattern_addr() != 0);
+    } else {
+        cart.ppuAddressA12(ctrl.bg_pattern_addr() != 0);
+    }
+}
+
+void PPU::beginFrame() {
+    currentFrame = &frameBuffers[nextFrameBuffer];
+    nextFrameBuffer = (nextFrameBuffer + 1) % FRAME_BUFFERS;
+    currentFrame->restart();
+}
+
+const Frame *PPU::tick() {
     if (scanline == 0 && cycles == 1) {
-        currentFrame.emplace(); // initialise new frame
+        beginFrame();
     }
 
     if (scanline < 240) {
-        if (cycles < 256) {
+        if (renderMode == PPURenderMode::Scanline) {
+            // draw the whole scanline on its last visible dot, unless a
+            // register write has already drawn part of it
+            if (cycles == SCREEN_WIDTH - 1) {
+                renderBackgroundDots(renderedDots, SCREEN_WIDTH);
+                renderedDots = SCREEN_WIDTH;
+            }
+        } else if (cycles < 256) {
             // visible pixels
 
             // apply scroll
@@ -298,15 +507,13 @@ std::optional<Frame> PPU::tick() {
                 break;
             }
             case 2: {
-                const uint16_t address =
-                    ctrl.bg_pattern_addr() + (tileID * 16) + fineY;
-                patternLow = cart.read_chr_rom(address);
+                // both pattern planes arrive pre-decoded on phase 3
                 break;
             }
             case 3: {
                 const uint16_t address =
-                    ctrl.bg_pattern_addr() + (tileID * 16) + fineY + 8;
-                patternHigh = cart.read_chr_rom(address);
+                    ctrl.bg_pattern_addr() + (tileID * 16) + fineY;
+                tilePixels = cart.read_chr_tile_row(address, false);
                 break;
             }
             case 4:
@@ -329,7 +536,9 @@ std::optional<Frame> PPU::tick() {
         // trigger vblank at (241, 1).
         if (cycles == 1) {
             // start vblank
-            renderSprites(*currentFrame);
+            if (videoOutput) {
+                renderSprites(*currentFrame);
+            }
 
             if (!suppressVblankThisFrame) {
                 status.set_vblank_status(true);
@@ -338,8 +547,8 @@ std::optional<Frame> PPU::tick() {
                 }
             }
             suppressVblankThisFrame = false;
-            std::optional<Frame> completedFrame = std::move(currentFrame);
-            currentFrame.reset();
+            const Frame *completedFrame = currentFrame;
+            currentFrame = nullptr;
             cycles++;
             return completedFrame;
         }
@@ -355,12 +564,19 @@ std::optional<Frame> PPU::tick() {
     // this point is reached on all scanlines/cycles except for (241, 1), which
     // returns a completed frame (see above)
 
+    if ((cycles == 257 || cycles == 321) &&
+        (scanline < 240 || scanline == 261) &&
+        (mask.show_background() || mask.show_sprites())) {
+        clockPatternTableA12();
+    }
+
     if (scanline == 261 && cycles == 339 && oddFrame &&
         (mask.show_background() || mask.show_sprites())) {
         scanline = 0;
         cycles = 0;
+        renderedDots = 0;
         oddFrame = false;
-        return std::nullopt;
+        return nullptr;
     }
 
     cycles++;
@@ -369,6 +585,7 @@ std::optional<Frame> PPU::tick() {
     if (cycles > 340) {
         // reset cycle counter and inc scanline
         cycles = 0;
+        renderedDots = 0;
         scanline++;
         // check end of frame reached
         if (scanline > 261) {
@@ -378,12 +595,13 @@ std::optional<Frame> PPU::tick() {
     }
 
     // return null option until frame complete
-    return std::nullopt;
+    return nullptr;
 }
 
 uint8_t PPU::cpuRead() {
     uint16_t addr_val = addr.get();
     addr.increment(ctrl.vram_addr_increment());
+    cart.ppuAddressA12((addr_val & 0x1000) != 0);
 
     if (addr_val <= 0x1FFF) {
         uint8_t result = data_buf;
@@ -409,10 +627,12 @@ uint8_t PPU::cpuRead() {
 }
 
 void PPU::cpuWrite(uint8_t value) {
+    catchUpBackground();
     last_written_value = value;
 
     uint16_t addr_val = addr.get();
     addr.increment(ctrl.vram_addr_increment());
+    cart.ppuAddressA12((addr_val & 0x1000) != 0);
 
     if (addr_val <= 0x1FFF) {
         cart.write_chr_ram(addr_val, value);
@@ -443,6 +663,10 @@ uint16_t PPU::mirrorVRAMAddress(uint16_t addr) {
     case MirroringMode::FourScreen:
         // The core only models 2 KiB of CIRAM, so four-screen mode wraps.
         return static_cast<uint16_t>(addr & 0x07FF);
+    case MirroringMode::SingleScreenLower:
+        return tileOffset;
+    case MirroringMode::SingleScreenUpper:
+        return static_cast<uint16_t>(0x0400 + tileOffset);
     default:
         throw std::runtime_error(
             "PPU attempted to mirror VRAM address, but no mirroring mode is "
@@ -453,6 +677,7 @@ uint16_t PPU::mirrorVRAMAddress(uint16_t addr) {
 // Writes to PPUCTRL can assert or clear NMI immediately when the write lands
 // during vblank.
 void PPU::write_to_ctrl(uint8_t value) {
+    catchUpBackground();
     last_written_value = value;
     bool priorNMI = ctrl.generate_vblank_nmi();
     ctrl.update(value);
@@ -465,11 +690,13 @@ void PPU::write_to_ctrl(uint8_t value) {
 }
 
 void PPU::write_to_mask(uint8_t value) {
+    catchUpBackground();
     last_written_value = value;
     mask.update(value);
 }
 
 uint8_t PPU::read_status() {
+    catchUpBackground(); // elapsed dots may set sprite zero hit
     uint8_t statusSnapshot = status.snapshot();
 
     // read at (240,338) is one tick before vblank and suppresses vblank for
@@ -502,6 +729,7 @@ void PPU::write_to_oam_addr(uint8_t value) {
 }
 
 void PPU::write_to_oam_data(uint8_t value) {
+    catchUpBackground();
     last_written_value = value;
     oam_data[oam_addr] = value;
     oam_addr = static_cast<uint8_t>(oam_addr + 1);
@@ -513,6 +741,7 @@ uint8_t PPU::read_oam_data() {
 }
 
 void PPU::write_to_scroll(uint8_t value) {
+    catchUpBackground();
     last_written_value = value;
     scroll.write(value);
 }
@@ -523,6 +752,7 @@ void PPU::write_to_ppu_addr(uint8_t value) {
 }
 
 void PPU::write_oam_dma(const std::array<uint8_t, 256> &data) {
+    catchUpBackground();
     for (const auto &x : data) {
         oam_data[oam_addr] = x;
         oam_addr = static_cast<uint8_t>(oam_addr + 1);
@@ -0,0 +1,276 @@
+#include "../../include/Renderer/PaletteConversion.h"
+
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+#include "../../include/Renderer/Frame.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) &&                              \
+    (defined(__GNUC__) || defined(__clang__))
+#define PALETTE_CONVERSION_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__)
+#define PALETTE_CONVERSION_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+// NES_PALETTE split into one 64 entry table per channel, for byte lookups
+template <std::size_t Channel> constexpr std::array<uint8_t, 64> channelTable() {
+    std::array<uint8_t, 64> table{};
+    for (std::size_t i = 0; i < table.size(); i++) {
+        table[i] = std::get<Channel>(NES_PALETTE[i]);
+    }
+    return table;
+}
+
+alignas(16) constexpr std::array<uint8_t, 64> PALETTE_R = channelTable<0>();
+alignas(16) constexpr std::array<uint8_t, 64> PALETTE_G = channelTable<1>();
+alignas(16) constexpr std::array<uint8_t, 64> PALETTE_B = channelTable<2>();
+constexpr const uint8_t *PALETTE_CHANNELS[3] = {
+    PALETTE_R.data(), PALETTE_G.data(), PALETTE_B.data()};
+
+void convertScalar(const uint8_t *indices, std::size_t count, uint8_t *rgba) {
+    for (std::size_t i = 0; i < count; i++) {
+        const uint8_t colour = indices[i] & 0x3F;
+        rgba[i * 4] = PALETTE_R[colour];
+        rgba[i * 4 + 1] = PALETTE_G[colour];
+        rgba[i * 4 + 2] = PALETTE_B[colour];
+        rgba[i * 4 + 3] = 0xFF;
+    }
+}
+
+/*
+ * The x86 paths look colours up with a 16 entry byte shuffle, once for each
+ * quarter of the palette. For quarter q, index - 16q is pushed through a
+ * saturating add of 0x70: indices inside the quarter keep their low nibble
+ * and stay below 0x80, all others reach 0x80 or more, which the shuffle
+ * turns into 0. OR-ing the four lookups leaves exactly one colour per byte.
+ * Each function returns the number of pixels it converted; the caller
+ * finishes the rest with convertScalar().
+ */
+#ifdef PALETTE_CONVERSION_X86
+
+__attribute__((target("ssse3"))) std::size_t
+convertSSSE3(const uint8_t *indices, std::size_t count, uint8_t *rgba) {
+    __m128i tables[3][4];
+    for (int channel = 0; channel < 3; channel++) {
+        for (int quarter = 0; quarter < 4; quarter++) {
+            tables[channel][quarter] = _mm_load_si128(
+                reinterpret_cast<const __m128i *>(PALETTE_CHANNELS[channel] +
+                                                  quarter * 16));
+        }
+    }
+    const __m128i colourMask = _mm_set1_epi8(0x3F);
+    const __m128i outOfQuarter = _mm_set1_epi8(0x70);
+    const __m128i alpha = _mm_set1_epi8(static_cast<char>(0xFF));
+
+    std::size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m128i colour = _mm_and_si128(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(indices + i)),
+            colourMask);
+
+        __m128i channels[3] = {_mm_setzero_si128(), _mm_setzero_si128(),
+                               _mm_setzero_si128()};
+        for (int quarter = 0; quarter < 4; quarter++) {
+            const __m128i select = _mm_adds_epu8(
+                _mm_sub_epi8(colour, _mm_set1_epi8(
+                                         static_cast<char>(quarter * 16))),
+                outOfQuarter);
+            for (int channel = 0; channel < 3; channel++) {
+                channels[channel] = _mm_or_si128(
+                    channels[channel],
+                    _mm_shuffle_epi8(tables[channel][quarter], select));
+            }
+        }
+
+        // interleave the planes into R, G, B, A
+        const __m128i rgLow = _mm_unpacklo_epi8(channels[0], channels[1]);
+        const __m128i rgHigh = _mm_unpackhi_epi8(channels[0], channels[1]);
+        const __m128i baLow = _mm_unpacklo_epi8(channels[2], alpha);
+        const __m128i baHigh = _mm_unpackhi_epi8(channels[2], alpha);
+        __m128i *out = reinterpret_cast<__m128i *>(rgba + i * 4);
+        _mm_storeu_si128(out, _mm_unpacklo_epi16(rgLow, baLow));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(rgLow, baLow));
+        _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(rgHigh, baHigh));
+        _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(rgHigh, baHigh));
+    }
+    return i;
+}
+
+__attribute__((target("avx2"))) std::size_t
+convertAVX2(const uint8_t *indices, std::size_t count, uint8_t *rgba) {
+    // vpshufb looks up within each 128-bit lane, so both lanes get the table
+    __m256i tables[3][4];
+    for (int channel = 0; channel < 3; channel++) {
+        for (int quarter = 0; quarter < 4; quarter++) {
+            tables[channel][quarter] = _mm256_broadcastsi128_si256(
+                _mm_load_si128(reinterpret_cast<const __m128i *>(
+                    PALETTE_CHANNELS[channel] + quarter * 16)));
+        }
+    }
+    const __m256i colourMask = _mm256_set1_epi8(0x3F);
+    const __m256i outOfQuarter = _mm256_set1_epi8(0x70);
+    const __m256i alpha = _mm256_set1_epi8(static_cast<char>(0xFF));
+
+    std::size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        const __m256i colour = _mm256_and_si256(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(indices + i)),
+            colourMask);
+
+        __m256i channels[3] = {_mm256_setzero_si256(), _mm256_setzero_si256(),
+                               _mm256_setzero_si256()};
+        for (int quarter = 0; quarter < 4; quarter++) {
+            const __m256i select = _mm256_adds_epu8(
+                _mm256_sub_epi8(colour, _mm256_set1_epi8(
+                                            static_cast<char>(quarter * 16))),
+                outOfQuarter);
+            for (int channel = 0; channel < 3; channel++) {
+                channels[channel] = _mm256_or_si256(
+                    channels[channel],
+                    _mm256_shuffle_epi8(tables[channel][quarter], select));
+            }
+        }
+
+        // Unpacks also work per lane: a holds pixels 0-3 and 16-19, b 4-7
+        // and 20-23, c 8-11 and 24-27, d 12-15 and 28-31.
+        const __m256i rgLow = _mm256_unpacklo_epi8(channels[0], channels[1]);
+        const __m256i rgHigh = _mm256_unpackhi_epi8(channels[0], channels[1]);
+        const __m256i baLow = _mm256_unpacklo_epi8(channels[2], alpha);
+        const __m256i baHigh = _mm256_unpackhi_epi8(channels[2], alpha);
+        const __m256i a = _mm256_unpacklo_epi16(rgLow, baLow);
+        const __m256i b = _mm256_unpackhi_epi16(rgLow, baLow);
+        const __m256i c = _mm256_unpacklo_epi16(rgHigh, baHigh);
+        const __m256i d = _mm256_unpackhi_epi16(rgHigh, baHigh);
+        __m256i *out = reinterpret_cast<__m256i *>(rgba + i * 4);
+        _mm256_storeu_si256(out, _mm256_permute2x128_si256(a, b, 0x20));
+        _mm256_storeu_si256(out + 1, _mm256_permute2x128_si256(c, d, 0x20));
+        _mm256_storeu_si256(out + 2, _mm256_permute2x128_si256(a, b, 0x31));
+        _mm256_storeu_si256(out + 3, _mm256_permute2x128_si256(c, d, 0x31));
+    }
+    return i;
+}
+
+#endif // PALETTE_CONVERSION_X86
+
+#ifdef PALETTE_CONVERSION_NEON
+
+// tbl looks up from all 64 bytes of a channel at once
+std::size_t convertNEON(const uint8_t *indices, std::size_t count,
+                        uint8_t *rgba) {
+    uint8x16x4_t tables[3];
+    for (int channel = 0; channel < 3; channel++) {
+        for (int quarter = 0; quarter < 4; quarter++) {
+            tables[channel].val[quarter] =
+                vld1q_u8(PALETTE_CHANNELS[channel] + quarter * 16);
+        }
+    }
+    const uint8x16_t colourMask = vdupq_n_u8(0x3F);
+
+    std::size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const uint8x16_t colour = vandq_u8(vld1q_u8(indices + i), colourMask);
+        uint8x16x4_t pixels;
+        pixels.val[0] = vqtbl4q_u8(tables[0], colour);
+        pixels.val[1] = vqtbl4q_u8(tables[1], colour);
+        pixels.val[2] = vqtbl4q_u8(tables[2], colour);
+        pixels.val[3] = vdupq_n_u8(0xFF);
+        vst4q_u8(rgba + i * 4, pixels);
+    }
+    return i;
+}
+
+#endif // PALETTE_CONVERSION_NEON
+
+} // namespace
+
+const char *paletteConversionPathName(PaletteConversionPath path) {
+    switch (path) {
+    case PaletteConversionPath::Scalar:
+        return "scalar";
+    case PaletteConversionPath::SSSE3:
+        return "ssse3";
+    case PaletteConversionPath::AVX2:
+        return "avx2";
+    case PaletteConversionPath::NEON:
+        return "neon";
+    }
+    return "unknown";
+}
+
+bool paletteConversionSupported(PaletteConversionPath path) {
+    switch (path) {
+    case PaletteConversionPath::Scalar:
+        return true;
+#ifdef PALETTE_CONVERSION_X86
+    case PaletteConversionPath::SSSE3:
+        return __builtin_cpu_supports("ssse3");
+    case PaletteConversionPath::AVX2:
+        return __builtin_cpu_supports("avx2");
+#endif
+#ifdef PALETTE_CONVERSION_NEON
+    case PaletteConversionPath::NEON:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+PaletteConversionPath bestPaletteConversionPath() {
+    static const PaletteConversionPath best = [] {
+        for (PaletteConversionPath path :
+             {PaletteConversionPath::AVX2, PaletteConversionPath::SSSE3,
+              PaletteConversionPath::NEON}) {
+            if (paletteConversionSupported(path)) {
+                return path;
+            }
+        }
+        return PaletteConversionPath::Scalar;
+    }();
+    return best;
+}
+
+void convertPaletteIndicesToRGBA(const uint8_t *indices, std::size_t count,
+                                 uint8_t *rgba) {
+    convertPaletteIndicesToRGBA(bestPaletteConversionPath(), indices, count,
+                                rgba);
+}
+
+void convertPaletteIndicesToRGBA(PaletteConversionPath path,
+                                 const uint8_t *indices, std::size_t count,
+                                 uint8_t *rgba) {
+    if (!paletteConversionSupported(path)) {
+        throw std::invalid_argument(
+            std::string("Palette conversion path not supported: ") +
+            paletteConversionPathName(path));
+    }
+
+    std::size_t converted = 0;
+    switch (path) {
+#ifdef PALETTE_CONVERSION_X86
+    case PaletteConversionPath::SSSE3:
+        converted = convertSSSE3(indices, count, rgba);
+        break;
+    case PaletteConversionPath::AVX2:
+        converted = convertAVX2(indices, count, rgba);
+        break;
+#endif
+#ifdef PALETTE_CONVERSION_NEON
+    case PaletteConversionPath::NEON:
+        converted = convertNEON(indices, count, rgba);
+        break;
+#endif
+    default:
+        break;
+    }
+    convertScalar(indices + converted, count - converted,
+                  rgba + converted * 4);
+}
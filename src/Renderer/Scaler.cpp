@@ -0,0 +1,404 @@
+#include "../../include/Renderer/Scaler.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "../../include/Constants.h"
+
+#if defined(__SSE2__)
+#define SCALER_SSE2 1
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#define SCALER_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+// alpha byte of an RGBA pixel read as a native uint32_t
+constexpr uint32_t ALPHA =
+    std::endian::native == std::endian::little ? 0xFF000000u : 0x000000FFu;
+
+/*
+ * Each scaler is written once against a small set of lane-wise operations
+ * on 32-bit pixels. ScalarOps handles one pixel at a time, the vector ops
+ * four. store2/store3 write their arguments' lanes interleaved, so lane i
+ * of a, b and c lands at out[2i], out[2i + 1] and so on.
+ */
+struct ScalarOps {
+    using Reg = uint32_t;
+    static constexpr int LANES = 1;
+
+    static Reg load(const uint32_t *pixels) { return *pixels; }
+    static void store(uint32_t *out, Reg a) { *out = a; }
+    static void store2(uint32_t *out, Reg a, Reg b) {
+        out[0] = a;
+        out[1] = b;
+    }
+    static void store3(uint32_t *out, Reg a, Reg b, Reg c) {
+        out[0] = a;
+        out[1] = b;
+        out[2] = c;
+    }
+    static Reg equal(Reg a, Reg b) { return a == b ? ~0u : 0u; }
+    static Reg bitAnd(Reg a, Reg b) { return a & b; }
+    static Reg bitOr(Reg a, Reg b) { return a | b; }
+    static Reg andNot(Reg a, Reg b) { return ~a & b; }
+    static Reg select(Reg mask, Reg a, Reg b) { return (mask & a) | (~mask & b); }
+    static Reg darken(Reg a) { return ((a >> 1) & 0x7F7F7F7Fu) | ALPHA; }
+};
+
+#ifdef SCALER_SSE2
+
+struct SSE2Ops {
+    using Reg = __m128i;
+    static constexpr int LANES = 4;
+
+    static Reg load(const uint32_t *pixels) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels));
+    }
+    static void store(uint32_t *out, Reg a) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), a);
+    }
+    static void store2(uint32_t *out, Reg a, Reg b) {
+        store(out, _mm_unpacklo_epi32(a, b));
+        store(out + 4, _mm_unpackhi_epi32(a, b));
+    }
+    static void store3(uint32_t *out, Reg a, Reg b, Reg c) {
+        // (a0 b0 c0 a1) (b1 c1 a2 b2) (c2 a3 b3 c3), from pairs of inputs
+        const __m128 ab = _mm_castsi128_ps(_mm_unpacklo_epi32(a, b));
+        const __m128 ca = _mm_castsi128_ps(_mm_unpacklo_epi32(c, a));
+        const __m128 bc = _mm_castsi128_ps(_mm_unpacklo_epi32(b, c));
+        const __m128 abHigh = _mm_castsi128_ps(_mm_unpackhi_epi32(a, b));
+        const __m128 caHigh = _mm_castsi128_ps(_mm_unpackhi_epi32(c, a));
+        const __m128 bcHigh = _mm_castsi128_ps(_mm_unpackhi_epi32(b, c));
+        store(out, _mm_castps_si128(
+                       _mm_shuffle_ps(ab, ca, _MM_SHUFFLE(3, 0, 1, 0))));
+        store(out + 4, _mm_castps_si128(_mm_shuffle_ps(
+                           bc, abHigh, _MM_SHUFFLE(1, 0, 3, 2))));
+        store(out + 8, _mm_castps_si128(_mm_shuffle_ps(
+                           caHigh, bcHigh, _MM_SHUFFLE(3, 2, 3, 0))));
+    }
+    static Reg equal(Reg a, Reg b) { return _mm_cmpeq_epi32(a, b); }
+    static Reg bitAnd(Reg a, Reg b) { return _mm_and_si128(a, b); }
+    static Reg bitOr(Reg a, Reg b) { return _mm_or_si128(a, b); }
+    static Reg andNot(Reg a, Reg b) { return _mm_andnot_si128(a, b); }
+    static Reg select(Reg mask, Reg a, Reg b) {
+        return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+    }
+    static Reg darken(Reg a) {
+        return _mm_or_si128(
+            _mm_and_si128(_mm_srli_epi32(a, 1), _mm_set1_epi32(0x7F7F7F7F)),
+            _mm_set1_epi32(static_cast<int>(ALPHA)));
+    }
+};
+using VectorOps = SSE2Ops;
+
+#elif defined(SCALER_NEON)
+
+struct NEONOps {
+    using Reg = uint32x4_t;
+    static constexpr int LANES = 4;
+
+    static Reg load(const uint32_t *pixels) { return vld1q_u32(pixels); }
+    static void store(uint32_t *out, Reg a) { vst1q_u32(out, a); }
+    static void store2(uint32_t *out, Reg a, Reg b) {
+        uint32x4x2_t pair;
+        pair.val[0] = a;
+        pair.val[1] = b;
+        vst2q_u32(out, pair);
+    }
+    static void store3(uint32_t *out, Reg a, Reg b, Reg c) {
+        uint32x4x3_t triple;
+        triple.val[0] = a;
+        triple.val[1] = b;
+        triple.val[2] = c;
+        vst3q_u32(out, triple);
+    }
+    static Reg equal(Reg a, Reg b) { return vceqq_u32(a, b); }
+    static Reg bitAnd(Reg a, Reg b) { return vandq_u32(a, b); }
+    static Reg bitOr(Reg a, Reg b) { return vorrq_u32(a, b); }
+    static Reg andNot(Reg a, Reg b) { return vbicq_u32(b, a); }
+    static Reg select(Reg mask, Reg a, Reg b) { return vbslq_u32(mask, a, b); }
+    static Reg darken(Reg a) {
+        const uint8x16_t halved = vshrq_n_u8(vreinterpretq_u8_u32(a), 1);
+        return vorrq_u32(vreinterpretq_u32_u8(halved), vdupq_n_u32(ALPHA));
+    }
+};
+using VectorOps = NEONOps;
+
+#else
+
+using VectorOps = ScalarOps;
+
+#endif
+
+constexpr int WIDTH = SCREEN_WIDTH;
+constexpr int HEIGHT = SCREEN_HEIGHT;
+
+// Writes factor copies of each pixel of one source row
+template <typename Ops>
+void nearestRow(const uint32_t *row, uint32_t *out, int factor) {
+    int x = 0;
+    if (factor == 2 || factor == 3) {
+        for (; x + Ops::LANES <= WIDTH; x += Ops::LANES) {
+            const typename Ops::Reg pixels = Ops::load(row + x);
+            if (factor == 2) {
+                Ops::store2(out + x * 2, pixels, pixels);
+            } else {
+                Ops::store3(out + x * 3, pixels, pixels, pixels);
+            }
+        }
+    }
+    for (; x < WIDTH; x++) {
+        std::fill_n(out + x * factor, factor, row[x]);
+    }
+}
+
+template <typename Ops> void darkenRow(const uint32_t *row, uint32_t *out,
+                                       int width) {
+    int x = 0;
+    for (; x + Ops::LANES <= width; x += Ops::LANES) {
+        Ops::store(out + x, Ops::darken(Ops::load(row + x)));
+    }
+    for (; x < width; x++) {
+        out[x] = ScalarOps::darken(row[x]);
+    }
+}
+
+/*
+ * EPX (AdvMAME Scale2x/Scale3x). For source pixel E and its neighbours
+ *   A B C
+ *   D E F
+ *   G H I
+ * each output pixel copies a neighbour where two edges meet, otherwise E.
+ * left and right are the columns of D and F, clamped at the image edges.
+ */
+template <typename Ops>
+void epxStep(int factor, const uint32_t *above, const uint32_t *row,
+             const uint32_t *below, int left, int x, int right, uint32_t *out,
+             std::size_t outStride) {
+    using Reg = typename Ops::Reg;
+    const Reg b = Ops::load(above + x);
+    const Reg d = Ops::load(row + left);
+    const Reg e = Ops::load(row + x);
+    const Reg f = Ops::load(row + right);
+    const Reg h = Ops::load(below + x);
+
+    // only smooth where B != H and D != F
+    const Reg smooth =
+        Ops::andNot(Ops::bitOr(Ops::equal(b, h), Ops::equal(d, f)),
+                    Ops::equal(e, e));
+    const Reg db = Ops::bitAnd(smooth, Ops::equal(d, b));
+    const Reg bf = Ops::bitAnd(smooth, Ops::equal(b, f));
+    const Reg dh = Ops::bitAnd(smooth, Ops::equal(d, h));
+    const Reg hf = Ops::bitAnd(smooth, Ops::equal(h, f));
+
+    if (factor == 2) {
+        Ops::store2(out, Ops::select(db, d, e), Ops::select(bf, f, e));
+        Ops::store2(out + outStride, Ops::select(dh, d, e),
+                    Ops::select(hf, f, e));
+        return;
+    }
+
+    const Reg a = Ops::load(above + left);
+    const Reg c = Ops::load(above + right);
+    const Reg g = Ops::load(below + left);
+    const Reg i = Ops::load(below + right);
+    const Reg ea = Ops::equal(e, a);
+    const Reg ec = Ops::equal(e, c);
+    const Reg eg = Ops::equal(e, g);
+    const Reg ei = Ops::equal(e, i);
+
+    const Reg top = Ops::bitOr(Ops::andNot(ec, db), Ops::andNot(ea, bf));
+    const Reg middleLeft = Ops::bitOr(Ops::andNot(eg, db), Ops::andNot(ea, dh));
+    const Reg middleRight =
+        Ops::bitOr(Ops::andNot(ei, bf), Ops::andNot(ec, hf));
+    const Reg bottom = Ops::bitOr(Ops::andNot(ei, dh), Ops::andNot(eg, hf));
+
+    Ops::store3(out, Ops::select(db, d, e), Ops::select(top, b, e),
+                Ops::select(bf, f, e));
+    Ops::store3(out + outStride, Ops::select(middleLeft, d, e), e,
+                Ops::select(middleRight, f, e));
+    Ops::store3(out + 2 * outStride, Ops::select(dh, d, e),
+                Ops::select(bottom, h, e), Ops::select(hf, f, e));
+}
+
+template <typename Ops>
+void epxRow(int factor, const uint32_t *above, const uint32_t *row,
+            const uint32_t *below, uint32_t *out, std::size_t outStride) {
+    // edge columns are scalar so vector loads never read outside the row
+    epxStep<ScalarOps>(factor, above, row, below, 0, 0, 1, out, outStride);
+    int x = 1;
+    for (; x + Ops::LANES < WIDTH; x += Ops::LANES) {
+        epxStep<Ops>(factor, above, row, below, x - 1, x, x + 1,
+                     out + x * factor, outStride);
+    }
+    for (; x < WIDTH; x++) {
+        epxStep<ScalarOps>(factor, above, row, below, x - 1, x,
+                           std::min(x + 1, WIDTH - 1), out + x * factor,
+                           outStride);
+    }
+}
+
+// Frame uploaded at native size, SDL scales it
+class GPUScaler : public Scaler {
+  public:
+    int outputWidth() const override { return WIDTH; }
+    int outputHeight() const override { return HEIGHT; }
+    const uint32_t *scale(const uint32_t *pixels) override { return pixels; }
+};
+
+class CPUScaler : public Scaler {
+  protected:
+    const int factor;
+    const bool vectorized;
+    std::vector<uint32_t> output;
+
+    std::size_t stride() const {
+        return static_cast<std::size_t>(WIDTH) * factor;
+    }
+    uint32_t *outputRow(int sourceY) {
+        return output.data() + static_cast<std::size_t>(sourceY) * factor *
+                                   stride();
+    }
+
+    // repeats the first output row of sourceY over rows first..factor-1
+    void repeatRow(int sourceY, int first) {
+        uint32_t *row = outputRow(sourceY);
+        for (int copy = first; copy < factor; copy++) {
+            std::memcpy(row + copy * stride(), row,
+                        stride() * sizeof(uint32_t));
+        }
+    }
+
+  public:
+    CPUScaler(int factor, bool vectorized)
+        : factor(factor), vectorized(vectorized),
+          output(static_cast<std::size_t>(WIDTH) * factor * HEIGHT * factor) {}
+
+    int outputWidth() const override { return WIDTH * factor; }
+    int outputHeight() const override { return HEIGHT * factor; }
+};
+
+class NearestScaler : public CPUScaler {
+  public:
+    using CPUScaler::CPUScaler;
+
+    const uint32_t *scale(const uint32_t *pixels) override {
+        for (int y = 0; y < HEIGHT; y++) {
+            const uint32_t *row = pixels + static_cast<std::size_t>(y) * WIDTH;
+            if (vectorized) {
+                nearestRow<VectorOps>(row, outputRow(y), factor);
+            } else {
+                nearestRow<ScalarOps>(row, outputRow(y), factor);
+            }
+            repeatRow(y, 1);
+        }
+        return output.data();
+    }
+};
+
+class ScanlineScaler : public CPUScaler {
+  public:
+    using CPUScaler::CPUScaler;
+
+    const uint32_t *scale(const uint32_t *pixels) override {
+        for (int y = 0; y < HEIGHT; y++) {
+            const uint32_t *row = pixels + static_cast<std::size_t>(y) * WIDTH;
+            uint32_t *out = outputRow(y);
+            uint32_t *last = out + (factor - 1) * stride();
+            const int width = static_cast<int>(stride());
+            if (vectorized) {
+                nearestRow<VectorOps>(row, out, factor);
+                darkenRow<VectorOps>(out, last, width);
+            } else {
+                nearestRow<ScalarOps>(row, out, factor);
+                darkenRow<ScalarOps>(out, last, width);
+            }
+            // rows between the first and the darkened last
+            for (int copy = 1; copy < factor - 1; copy++) {
+                std::memcpy(out + copy * stride(), out,
+                            stride() * sizeof(uint32_t));
+            }
+        }
+        return output.data();
+    }
+};
+
+class EPXScaler : public CPUScaler {
+  public:
+    using CPUScaler::CPUScaler;
+
+    const uint32_t *scale(const uint32_t *pixels) override {
+        for (int y = 0; y < HEIGHT; y++) {
+            const uint32_t *row = pixels + static_cast<std::size_t>(y) * WIDTH;
+            const uint32_t *above = y > 0 ? row - WIDTH : row;
+            const uint32_t *below = y < HEIGHT - 1 ? row + WIDTH : row;
+            if (vectorized) {
+                epxRow<VectorOps>(factor, above, row, below, outputRow(y),
+                                  stride());
+            } else {
+                epxRow<ScalarOps>(factor, above, row, below, outputRow(y),
+                                  stride());
+            }
+        }
+        return output.data();
+    }
+};
+
+} // namespace
+
+const char *scalerKindName(ScalerKind kind) {
+    switch (kind) {
+    case ScalerKind::GPU:
+        return "gpu";
+    case ScalerKind::Nearest:
+        return "nearest";
+    case ScalerKind::Scanlines:
+        return "scanlines";
+    case ScalerKind::EPX:
+        return "epx";
+    }
+    return "unknown";
+}
+
+ScalerKind scalerKindFromName(const std::string &name) {
+    for (ScalerKind kind : {ScalerKind::GPU, ScalerKind::Nearest,
+                            ScalerKind::Scanlines, ScalerKind::EPX}) {
+        if (name == scalerKindName(kind)) {
+            return kind;
+        }
+    }
+    throw std::invalid_argument("Unknown scaler: " + name);
+}
+
+std::unique_ptr<Scaler> makeScaler(ScalerKind kind, int factor,
+                                   bool vectorized) {
+    switch (kind) {
+    case ScalerKind::GPU:
+        return std::make_unique<GPUScaler>();
+    case ScalerKind::Nearest:
+        if (factor >= 1) {
+            return std::make_unique<NearestScaler>(factor, vectorized);
+        }
+        break;
+    case ScalerKind::Scanlines:
+        if (factor >= 2) {
+            return std::make_unique<ScanlineScaler>(factor, vectorized);
+        }
+        break;
+    case ScalerKind::EPX:
+        if (factor == 2 || factor == 3) {
+            return std::make_unique<EPXScaler>(factor, vectorized);
+        }
+        break;
+    }
+    throw std::invalid_argument(std::string("Scaler ") + scalerKindName(kind) +
+                                " does not support factor " +
+                                std::to_string(factor));
+}
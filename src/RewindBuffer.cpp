@@ -0,0 +1,184 @@
+#include "../include/RewindBuffer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+void writeVarint(std::vector<uint8_t> &out, std::size_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+std::size_t readVarint(const uint8_t *&cursor) {
+    std::size_t value = 0;
+    int shift = 0;
+    while (*cursor & 0x80) {
+        value |= static_cast<std::size_t>(*cursor++ & 0x7F) << shift;
+        shift += 7;
+    }
+    value |= static_cast<std::size_t>(*cursor++) << shift;
+    return value;
+}
+
+/**
+ * Run-length encodes a XOR b. The shorter buffer is treated as zero padded.
+ * Output is a sequence of (zero run length, literal length, literal bytes).
+ */
+void encodeDelta(const std::vector<uint8_t> &a, const std::vector<uint8_t> &b,
+                 std::vector<uint8_t> &out) {
+    const std::size_t length = std::max(a.size(), b.size());
+    const std::size_t common = std::min(a.size(), b.size());
+    auto xorAt = [&](std::size_t i) -> uint8_t {
+        const uint8_t left = i < a.size() ? a[i] : 0;
+        const uint8_t right = i < b.size() ? b[i] : 0;
+        return static_cast<uint8_t>(left ^ right);
+    };
+
+    std::size_t i = 0;
+    while (i < length) {
+        // skip unchanged bytes, a word at a time where possible
+        const std::size_t zeroStart = i;
+        while (i < length) {
+            if (i + 8 <= common && std::memcmp(&a[i], &b[i], 8) == 0) {
+                i += 8;
+            } else if (xorAt(i) == 0) {
+                i++;
+            } else {
+                break;
+            }
+        }
+
+        // changed bytes, ending at two unchanged bytes in a row
+        const std::size_t literalStart = i;
+        while (i < length &&
+               !(xorAt(i) == 0 && (i + 1 >= length || xorAt(i + 1) == 0))) {
+            i++;
+        }
+
+        writeVarint(out, literalStart - zeroStart);
+        writeVarint(out, i - literalStart);
+        for (std::size_t j = literalStart; j < i; j++) {
+            out.push_back(xorAt(j));
+        }
+    }
+}
+
+/**
+ * XORs an encoded delta into target, which must already be long enough.
+ */
+void applyDelta(const uint8_t *delta, std::size_t deltaLength,
+                std::vector<uint8_t> &target) {
+    const uint8_t *cursor = delta;
+    const uint8_t *end = delta + deltaLength;
+    std::size_t i = 0;
+    while (cursor < end) {
+        i += readVarint(cursor);
+        const std::size_t literals = readVarint(cursor);
+        for (std::size_t j = 0; j < literals; j++) {
+            target[i++] ^= *cursor++;
+        }
+    }
+}
+
+} // namespace
+
+void RewindBuffer::setBudget(std::size_t budgetBytes) {
+    ring.assign(budgetBytes, 0);
+    ring.shrink_to_fit();
+    statistics.budgetBytes = budgetBytes;
+    clear();
+}
+
+void RewindBuffer::clear() {
+    entries.clear();
+    head = 0;
+    newest.clear();
+    hasNewest = false;
+    const std::size_t budget = statistics.budgetBytes;
+    statistics = RewindStats{};
+    statistics.budgetBytes = budget;
+}
+
+// Copies scratch into the ring after the newest delta, dropping the oldest
+// deltas in the way.
+void RewindBuffer::storeDelta(std::size_t previousSize) {
+    const std::size_t length = scratch.size();
+    if (length > ring.size()) {
+        // a single delta does not fit, history cannot continue past this
+        entries.clear();
+        head = 0;
+        statistics.historyBytes = 0;
+        return;
+    }
+
+    auto dropOldest = [&]() {
+        statistics.historyBytes -= entries.front().length;
+        entries.pop_front();
+    };
+
+    if (head + length > ring.size()) {
+        // deltas between head and the end of the ring are the oldest
+        while (!entries.empty() && entries.front().offset >= head) {
+            dropOldest();
+        }
+        head = 0;
+    }
+    while (!entries.empty() && entries.front().offset < head + length &&
+           entries.front().offset + entries.front().length > head) {
+        dropOldest();
+    }
+
+    std::memcpy(&ring[head], scratch.data(), length);
+    entries.push_back(Entry{head, length, previousSize});
+    head += length;
+    statistics.historyBytes += length;
+}
+
+void RewindBuffer::push(const std::vector<uint8_t> &snapshot) {
+    if (!enabled()) {
+        return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    if (hasNewest) {
+        scratch.clear();
+        encodeDelta(newest, snapshot, scratch);
+        storeDelta(newest.size());
+    }
+    newest.assign(snapshot.begin(), snapshot.end());
+    hasNewest = true;
+    const double micros = std::chrono::duration<double, std::micro>(
+                              std::chrono::steady_clock::now() - start)
+                              .count();
+
+    statistics.frames = entries.size() + 1;
+    statistics.snapshotBytes = newest.size();
+    statistics.framesRecorded++;
+    statistics.lastCompressMicros = micros;
+    statistics.totalCompressMicros += micros;
+}
+
+bool RewindBuffer::stepBack(std::vector<uint8_t> &snapshot) {
+    if (entries.empty()) {
+        return false;
+    }
+
+    const Entry entry = entries.back();
+    entries.pop_back();
+    newest.resize(std::max(newest.size(), entry.previousSize), 0);
+    applyDelta(&ring[entry.offset], entry.length, newest);
+    newest.resize(entry.previousSize);
+
+    head = entry.offset; // the delta's space is free again
+    statistics.historyBytes -= entry.length;
+    statistics.frames = entries.size() + 1;
+    statistics.snapshotBytes = newest.size();
+
+    snapshot.assign(newest.begin(), newest.end());
+    return true;
+}
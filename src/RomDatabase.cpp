@@ -0,0 +1,146 @@
+#include "../include/RomDatabase.h"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// Dumps whose iNES headers are known to be wrong. Add an entry with the
+// values from NesCartDB for the dump's PRG+CHR CRC32, which
+// Cartridge::getCRC32() reports. Keep the table sorted by CRC32; this is
+// checked at compile time. Empty until entries are verified against real
+// dumps; nesemu --rom-db loads a table from a file meanwhile.
+constexpr std::array<RomDatabaseEntry, 0> EMBEDDED_ENTRIES{};
+
+static_assert(std::is_sorted(EMBEDDED_ENTRIES.begin(), EMBEDDED_ENTRIES.end(),
+                             [](const RomDatabaseEntry &a,
+                                const RomDatabaseEntry &b) {
+                                 return a.crc32 < b.crc32;
+                             }),
+              "EMBEDDED_ENTRIES must be sorted by crc32");
+
+bool byCRC(const RomDatabaseEntry &a, const RomDatabaseEntry &b) {
+    return a.crc32 < b.crc32;
+}
+
+// set by install(), kept alive for the standard database to point into
+std::vector<RomDatabaseEntry> installedEntries;
+RomDatabase installedDatabase{std::span<const RomDatabaseEntry>{}};
+bool installed = false;
+
+MirroringMode parseMirroring(const std::string &name) {
+    if (name == "H") {
+        return MirroringMode::Horizontal;
+    }
+    if (name == "V") {
+        return MirroringMode::Vertical;
+    }
+    if (name == "4") {
+        return MirroringMode::FourScreen;
+    }
+    throw std::invalid_argument("unknown mirroring " + name);
+}
+
+NESRegion parseRegion(const std::string &name) {
+    if (name == "NTSC") {
+        return NESRegion::NTSC;
+    }
+    if (name == "PAL") {
+        return NESRegion::PAL;
+    }
+    if (name == "Dendy") {
+        return NESRegion::Dendy;
+    }
+    throw std::invalid_argument("unknown region " + name);
+}
+
+RomDatabaseEntry parseEntry(const std::string &line) {
+    std::istringstream fields(line);
+    std::string crc, mirroring, region;
+    unsigned mapper = 0, submapper = 0;
+    uint32_t prgRam = 0, prgNvram = 0;
+    if (!(fields >> crc >> mapper >> submapper >> mirroring >> region >>
+          prgRam >> prgNvram)) {
+        throw std::invalid_argument("expected 7 fields");
+    }
+    std::string extra;
+    if (fields >> extra) {
+        throw std::invalid_argument("unexpected " + extra);
+    }
+    if (mapper > 4095 || submapper > 15) {
+        throw std::invalid_argument("mapper out of range");
+    }
+
+    std::size_t end = 0;
+    const unsigned long value = std::stoul(crc, &end, 16);
+    if (end != crc.size() || value > UINT32_MAX) {
+        throw std::invalid_argument("bad CRC32 " + crc);
+    }
+
+    RomDatabaseEntry entry{};
+    entry.crc32 = static_cast<uint32_t>(value);
+    entry.mapper = static_cast<uint16_t>(mapper);
+    entry.submapper = static_cast<uint8_t>(submapper);
+    entry.mirroring = parseMirroring(mirroring);
+    entry.region = parseRegion(region);
+    entry.prgRamSize = prgRam;
+    entry.prgNvramSize = prgNvram;
+    return entry;
+}
+
+} // namespace
+
+const RomDatabaseEntry *RomDatabase::find(uint32_t crc32) const {
+    const auto it = std::lower_bound(
+        entries.begin(), entries.end(), crc32,
+        [](const RomDatabaseEntry &entry, uint32_t key) {
+            return entry.crc32 < key;
+        });
+    if (it == entries.end() || it->crc32 != crc32) {
+        return nullptr;
+    }
+    return &*it;
+}
+
+const RomDatabase &RomDatabase::embedded() {
+    static constexpr RomDatabase database{EMBEDDED_ENTRIES};
+    return database;
+}
+
+const RomDatabase &RomDatabase::standard() {
+    return installed ? installedDatabase : embedded();
+}
+
+void RomDatabase::install(std::vector<RomDatabaseEntry> entries) {
+    std::sort(entries.begin(), entries.end(), byCRC);
+    installedEntries = std::move(entries);
+    installedDatabase = RomDatabase(installedEntries);
+    installed = true;
+}
+
+std::vector<RomDatabaseEntry> RomDatabase::readFile(const std::string &path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Cannot open ROM database: " + path);
+    }
+
+    std::vector<RomDatabaseEntry> entries;
+    std::string line;
+    for (int number = 1; std::getline(file, line); number++) {
+        line = line.substr(0, line.find('#'));
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        try {
+            entries.push_back(parseEntry(line));
+        } catch (const std::exception &e) {
+            throw std::runtime_error(path + ":" + std::to_string(number) +
+                                     ": " + e.what());
+        }
+    }
+    return entries;
+}
@@ -0,0 +1,98 @@
+#include "../include/RomHeader.h"
+
+#include <stdexcept>
+
+namespace {
+
+// NES 2.0 ROM size from its LSB and MSB nibble, in units of unit bytes
+std::size_t nes2RomSize(uint8_t lsb, uint8_t msb, std::size_t unit) {
+    if (msb != 0x0F) {
+        return ((static_cast<std::size_t>(msb) << 8) | lsb) * unit;
+    }
+    const unsigned exponent = lsb >> 2;
+    const std::size_t multiplier = (lsb & 0x03) * 2 + 1;
+    if (exponent > 32) {
+        throw std::invalid_argument("Invalid ROM file: ROM size too large");
+    }
+    return (std::size_t{1} << exponent) * multiplier;
+}
+
+std::size_t nes2RamSize(uint8_t shift) { return shift ? 64u << shift : 0; }
+
+} // namespace
+
+RomHeader RomHeader::parse(std::span<const uint8_t> romDump) {
+    // 0-3 | Constant "NES" ($4E $45 $53 $1A - ASCII "NES" followed by EOF char)
+    if (romDump.size() < 16 || romDump[0] != 'N' || romDump[1] != 'E' ||
+        romDump[2] != 'S' || romDump[3] != 0x1A) {
+        throw std::invalid_argument("File is not in iNES file format");
+    }
+
+    RomHeader header;
+    const uint8_t flags6 = romDump[6];
+    const uint8_t flags7 = romDump[7];
+
+    if (flags6 & 0b00001000) {
+        // bit 3 of flags 6 is set [alt layout]
+        header.mirroring = MirroringMode::FourScreen;
+    } else {
+        // bit 0 of flags 6 set ? vertical mirroring, else horizontal
+        header.mirroring = (flags6 & 0b1) ? MirroringMode::Vertical
+                                          : MirroringMode::Horizontal;
+    }
+    header.battery = (flags6 & 0b00000010) != 0;
+    header.trainer = (flags6 & 0b00000100) != 0;
+
+    if (((flags7 >> 2) & 0b11) == 2) {
+        header.format = RomFormat::NES2;
+        header.mapper = static_cast<uint16_t>(((romDump[8] & 0x0F) << 8) |
+                                              (flags7 & 0xF0) | (flags6 >> 4));
+        header.submapper = romDump[8] >> 4;
+        header.prgRomSize =
+            nes2RomSize(romDump[4], romDump[9] & 0x0F, 16384);
+        header.chrRomSize = nes2RomSize(romDump[5], romDump[9] >> 4, 8192);
+        header.prgRamSize = nes2RamSize(romDump[10] & 0x0F);
+        header.prgNvramSize = nes2RamSize(romDump[10] >> 4);
+        header.chrRamSize = nes2RamSize(romDump[11] & 0x0F);
+        header.chrNvramSize = nes2RamSize(romDump[11] >> 4);
+        switch (romDump[12] & 0b11) {
+        case 1:
+            header.region = NESRegion::PAL;
+            break;
+        case 3:
+            header.region = NESRegion::Dendy;
+            break;
+        default:
+            // multiple-region carts run as NTSC
+            header.region = NESRegion::NTSC;
+            break;
+        }
+    } else {
+        header.format = RomFormat::INES;
+        // Dumping tools used to sign bytes 7-15 ("DiskDude!"). If the
+        // normally zero bytes 12-15 are set, flags 7 cannot be trusted.
+        const bool padded = romDump[12] == 0 && romDump[13] == 0 &&
+                            romDump[14] == 0 && romDump[15] == 0;
+        const uint8_t upperNibble = padded ? (flags7 & 0xF0) : 0;
+        header.mapper = static_cast<uint16_t>(upperNibble | (flags6 >> 4));
+        header.prgRomSize = romDump[4] * 16384; // given in 16KiB blocks
+        header.chrRomSize = romDump[5] * 8192;  // given in 8KiB blocks
+        header.prgNvramSize = header.battery ? 0x2000 : 0;
+        // iNES uses CHR size 0 to indicate 8 KiB of CHR-RAM
+        header.chrRamSize = header.chrRomSize == 0 ? 0x2000 : 0;
+
+        // FLAGS 9
+        // 76543210
+        // ||||||||
+        // |||||||+- TV system (0: NTSC; 1: PAL)
+        // +++++++-- Reserved, set to zero
+        header.region = (padded && (romDump[9] & 0x01)) ? NESRegion::PAL
+                                                        : NESRegion::NTSC;
+    }
+
+    if (romDump.size() <
+        header.prgRomOffset() + header.prgRomSize + header.chrRomSize) {
+        throw std::invalid_argument("Invalid ROM file: insufficient data");
+    }
+    return header;
+}
@@ -0,0 +1,93 @@
+#include "../include/RomImage.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ROMIMAGE_MMAP 1
+#endif
+
+namespace {
+
+// images opened by path, so instances in one process share a mapping
+std::mutex openImagesMutex;
+std::unordered_map<std::string, std::weak_ptr<const RomImage>> openImages;
+
+} // namespace
+
+RomImage::~RomImage() {
+#ifdef ROMIMAGE_MMAP
+    if (mapped) {
+        munmap(const_cast<uint8_t *>(data), size);
+    }
+#endif
+}
+
+std::shared_ptr<const RomImage> RomImage::open(const std::string &path) {
+    std::error_code error;
+    std::string key = std::filesystem::canonical(path, error).string();
+    if (error) {
+        throw std::runtime_error("Could not open file: " + path);
+    }
+
+    std::lock_guard<std::mutex> lock(openImagesMutex);
+    std::erase_if(openImages,
+                  [](const auto &entry) { return entry.second.expired(); });
+    if (auto existing = openImages[key].lock()) {
+        return existing;
+    }
+
+    std::shared_ptr<RomImage> image(new RomImage());
+#ifdef ROMIMAGE_MMAP
+    const int fd = ::open(key.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Could not open file: " + path);
+    }
+    struct stat info {};
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw std::runtime_error("Could not open file: " + path);
+    }
+    image->size = static_cast<std::size_t>(info.st_size);
+    if (image->size > 0) {
+        void *mapping =
+            mmap(nullptr, image->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("Could not map file: " + path);
+        }
+        image->data = static_cast<const uint8_t *>(mapping);
+        image->mapped = true;
+    }
+    close(fd); // the mapping stays valid
+#else
+    std::ifstream file(key, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Could not open file: " + path);
+    }
+    image->owned.assign(std::istreambuf_iterator<char>(file),
+                        std::istreambuf_iterator<char>());
+    image->data = image->owned.data();
+    image->size = image->owned.size();
+#endif
+
+    openImages[key] = image;
+    return image;
+}
+
+std::shared_ptr<const RomImage>
+RomImage::copy(std::span<const uint8_t> bytes) {
+    std::shared_ptr<RomImage> image(new RomImage());
+    image->owned.assign(bytes.begin(), bytes.end());
+    image->data = image->owned.data();
+    image->size = image->owned.size();
+    return image;
+}
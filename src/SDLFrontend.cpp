@@ -0,0 +1,62 @@
+#include "../include/SDLFrontend.h"
+
+#include <SDL3/SDL.h>
+
+#include "../include/Bus.h"
+
+FrontendInput SDLFrontend::poll() {
+    FrontendInput input;
+    SDL_Event event;
+    while (SDL_PollEvent(&event)) {
+        if (event.type == SDL_EVENT_QUIT) {
+            input.quit = true;
+        } else if (event.type == SDL_EVENT_KEY_DOWN ||
+                   event.type == SDL_EVENT_KEY_UP) {
+            switch (event.key.key) {
+            case SDLK_ESCAPE:
+                if (event.type == SDL_EVENT_KEY_DOWN && !event.key.repeat) {
+                    input.quit = true;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    int keyCount = 0;
+    const bool *keys = SDL_GetKeyboardState(&keyCount);
+    auto isPressed = [&](SDL_Scancode code) -> bool {
+        const int idx = static_cast<int>(code);
+        return idx >= 0 && idx < keyCount && keys[idx];
+    };
+
+    if (isPressed(SDL_SCANCODE_Z) || isPressed(SDL_SCANCODE_J)) {
+        input.joypad1 |= Bus::JOYPAD_A;
+    }
+    if (isPressed(SDL_SCANCODE_X) || isPressed(SDL_SCANCODE_K)) {
+        input.joypad1 |= Bus::JOYPAD_B;
+    }
+    if (isPressed(SDL_SCANCODE_RETURN) || isPressed(SDL_SCANCODE_KP_ENTER) ||
+        isPressed(SDL_SCANCODE_SPACE)) {
+        input.joypad1 |= Bus::JOYPAD_START;
+    }
+    if (isPressed(SDL_SCANCODE_TAB) || isPressed(SDL_SCANCODE_LSHIFT) ||
+        isPressed(SDL_SCANCODE_RSHIFT)) {
+        input.joypad1 |= Bus::JOYPAD_SELECT;
+    }
+    if (isPressed(SDL_SCANCODE_UP) || isPressed(SDL_SCANCODE_W)) {
+        input.joypad1 |= Bus::JOYPAD_UP;
+    }
+    if (isPressed(SDL_SCANCODE_DOWN) || isPressed(SDL_SCANCODE_S)) {
+        input.joypad1 |= Bus::JOYPAD_DOWN;
+    }
+    if (isPressed(SDL_SCANCODE_LEFT) || isPressed(SDL_SCANCODE_A)) {
+        input.joypad1 |= Bus::JOYPAD_LEFT;
+    }
+    if (isPressed(SDL_SCANCODE_RIGHT) || isPressed(SDL_SCANCODE_D)) {
+        input.joypad1 |= Bus::JOYPAD_RIGHT;
+    }
+    input.rewind = isPressed(SDL_SCANCODE_BACKSPACE);
+    return input;
+}
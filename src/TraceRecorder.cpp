@@ -0,0 +1,141 @@
+#include "../include/TraceRecorder.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define TRACERECORDER_MMAP 1
+#endif
+
+namespace {
+
+std::size_t ringCapacity(std::size_t capacity) {
+    return std::bit_ceil(std::max<std::size_t>(capacity, 1));
+}
+
+std::size_t fileBytes(std::size_t capacity) {
+    return sizeof(TraceRecorder::FileHeader) + capacity * sizeof(TraceRecord);
+}
+
+void writeHeader(TraceRecorder::FileHeader &header, std::size_t capacity) {
+    std::memcpy(header.magic, TraceRecorder::MAGIC, sizeof(header.magic));
+    header.version = TraceRecorder::VERSION;
+    header.recordSize = sizeof(TraceRecord);
+    header.capacity = capacity;
+    header.written = 0;
+}
+
+} // namespace
+
+void TraceRecorder::allocate(std::size_t capacity) {
+    bytes = fileBytes(capacity);
+    // not zeroed: records are only read back once written
+    owned = std::make_unique_for_overwrite<uint8_t[]>(bytes);
+    header = reinterpret_cast<FileHeader *>(owned.get());
+    records = reinterpret_cast<TraceRecord *>(owned.get() + sizeof(FileHeader));
+}
+
+TraceRecorder::TraceRecorder(std::size_t capacity) {
+    capacity = ringCapacity(capacity);
+    allocate(capacity);
+    writeHeader(*header, capacity);
+    mask = capacity - 1;
+}
+
+TraceRecorder::TraceRecorder(const std::string &path, std::size_t capacity) {
+    capacity = ringCapacity(capacity);
+#ifdef TRACERECORDER_MMAP
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Could not create trace file: " + path);
+    }
+    bytes = fileBytes(capacity);
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        close(fd);
+        throw std::runtime_error("Could not size trace file: " + path);
+    }
+    void *mapping =
+        mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd); // the mapping stays valid
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Could not map trace file: " + path);
+    }
+    mapped = true;
+    header = static_cast<FileHeader *>(mapping);
+    records = reinterpret_cast<TraceRecord *>(static_cast<uint8_t *>(mapping) +
+                                              sizeof(FileHeader));
+#else
+    allocate(capacity);
+    this->path = path;
+#endif
+    writeHeader(*header, capacity);
+    mask = capacity - 1;
+}
+
+TraceRecorder::~TraceRecorder() {
+#ifdef TRACERECORDER_MMAP
+    if (mapped) {
+        munmap(header, bytes);
+        return;
+    }
+#endif
+    if (!path.empty()) {
+        // slots fill in order, so only the used ones are written
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char *>(owned.get()),
+                   static_cast<std::streamsize>(fileBytes(size())));
+    }
+}
+
+std::vector<TraceRecord> TraceRecorder::snapshot() const {
+    std::vector<TraceRecord> ordered;
+    ordered.reserve(size());
+    for (uint64_t i = count - size(); i < count; i++) {
+        ordered.push_back(records[i & mask]);
+    }
+    return ordered;
+}
+
+std::vector<TraceRecord> TraceRecorder::readFile(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Could not open trace file: " + path);
+    }
+    const std::vector<uint8_t> contents((std::istreambuf_iterator<char>(file)),
+                                        std::istreambuf_iterator<char>());
+
+    FileHeader header{};
+    if (contents.size() < sizeof(header)) {
+        throw std::runtime_error("Not a trace file: " + path);
+    }
+    std::memcpy(&header, contents.data(), sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        header.version != VERSION || header.recordSize != sizeof(TraceRecord) ||
+        !std::has_single_bit(header.capacity)) {
+        throw std::runtime_error("Not a trace file: " + path);
+    }
+
+    const uint64_t stored = std::min(header.written, header.capacity);
+    const uint64_t available =
+        (contents.size() - sizeof(header)) / sizeof(TraceRecord);
+    if (stored > available) {
+        throw std::runtime_error("Trace file is truncated: " + path);
+    }
+
+    std::vector<TraceRecord> ordered(stored);
+    const uint8_t *slots = contents.data() + sizeof(header);
+    for (uint64_t i = 0; i < stored; i++) {
+        const uint64_t slot =
+            (header.written - stored + i) & (header.capacity - 1);
+        std::memcpy(&ordered[i], slots + slot * sizeof(TraceRecord),
+                    sizeof(TraceRecord));
+    }
+    return ordered;
+}
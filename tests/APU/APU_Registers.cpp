@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "../../include/APU/APU.h"
+#include "../../include/Cartridge.h"
+#include "../../include/SaveState.h"
+#include "../TestRoms.h"
+
+namespace {
+
+class APURegisters : public ::testing::Test {
+  protected:
+    // NROM with 32 KiB PRG filled with $FF, so DMC samples ramp the level up
+    Cartridge cart{testroms::makeINES(0x8000, 0x2000, 0, 0xFF)};
+    APU apu{cart};
+
+    // runs cycles one at a time, as Clock does in cycle stepped mode
+    void run(uint32_t cycles) {
+        for (uint32_t i = 0; i < cycles; i++) {
+            apu.clock(1);
+        }
+    }
+};
+
+} // namespace
+
+TEST_F(APURegisters, LengthCounterLoadsOnlyWhenEnabled) {
+    apu.writeRegister(0x4003, 0x08); // length index 1 (254)
+    EXPECT_EQ(apu.readStatus() & 0x01, 0);
+
+    apu.writeRegister(0x4015, 0x0F);
+    apu.writeRegister(0x4003, 0x08);
+    apu.writeRegister(0x400B, 0x08);
+    apu.writeRegister(0x400F, 0x08);
+    EXPECT_EQ(apu.readStatus() & 0x0F, 0x0D); // pulse 1, triangle, noise
+
+    apu.writeRegister(0x4015, 0x00); // disabling clears the counters
+    EXPECT_EQ(apu.readStatus() & 0x0F, 0);
+}
+
+TEST_F(APURegisters, LengthCounterCountsHalfFrames) {
+    apu.writeRegister(0x4015, 0x01);
+    apu.writeRegister(0x4017, 0x40); // 4-step, no IRQ
+    apu.writeRegister(0x4003, 0x18); // length index 3 (2)
+    run(3 + 14913 - 1);
+    EXPECT_EQ(apu.readStatus() & 0x01, 0x01);
+    run(29829 - 14913 + 1); // second half frame clock
+    EXPECT_EQ(apu.readStatus() & 0x01, 0);
+}
+
+TEST_F(APURegisters, FrameIRQInFourStepMode) {
+    apu.writeRegister(0x4017, 0x00);
+    run(3 + 29828 - 1);
+    EXPECT_FALSE(apu.irqAsserted());
+    run(1);
+    EXPECT_TRUE(apu.irqAsserted());
+
+    // reading $4015 acknowledges it
+    EXPECT_EQ(apu.readStatus() & 0x40, 0x40);
+    EXPECT_FALSE(apu.irqAsserted());
+
+    // raised again on the following two cycles, then once per sequence
+    run(2);
+    EXPECT_TRUE(apu.irqAsserted());
+    apu.readStatus();
+    run(29828 - 1);
+    EXPECT_FALSE(apu.irqAsserted());
+    run(1);
+    EXPECT_TRUE(apu.irqAsserted());
+}
+
+TEST_F(APURegisters, FrameIRQInhibitedAndFiveStep) {
+    apu.writeRegister(0x4017, 0x40);
+    run(40000);
+    EXPECT_FALSE(apu.irqAsserted());
+
+    apu.writeRegister(0x4017, 0x00);
+    run(30000);
+    EXPECT_TRUE(apu.irqAsserted());
+    apu.writeRegister(0x4017, 0x40); // setting inhibit clears the flag
+    EXPECT_FALSE(apu.irqAsserted());
+
+    apu.writeRegister(0x4017, 0x80);
+    run(80000);
+    EXPECT_FALSE(apu.irqAsserted());
+}
+
+TEST_F(APURegisters, LargeClockStepsMatchSingleCycles) {
+    APU other(cart);
+    for (APU *unit : {&apu, &other}) {
+        unit->writeRegister(0x4015, 0x01);
+        unit->writeRegister(0x4017, 0x00);
+        unit->writeRegister(0x4003, 0x18);
+    }
+    run(29830);
+    other.clock(29830);
+    EXPECT_EQ(apu.readStatus(), other.readStatus());
+}
+
+TEST_F(APURegisters, DMCFetchesStallAndRaiseIRQ) {
+    apu.writeRegister(0x4017, 0x40);
+    apu.writeRegister(0x4010, 0x8F); // IRQ, fastest rate (54 cycles)
+    apu.writeRegister(0x4012, 0x00); // $C000
+    apu.writeRegister(0x4013, 0x01); // 17 bytes
+    apu.writeRegister(0x4015, 0x10);
+
+    // the first byte is fetched as soon as the channel is enabled
+    EXPECT_EQ(apu.takeStallCycles(), 4u);
+    EXPECT_EQ(apu.readStatus() & 0x10, 0x10);
+
+    uint32_t stalls = 0;
+    for (int i = 0; i < 17 * 8 * 54; i++) {
+        apu.clock(1);
+        stalls += apu.takeStallCycles();
+    }
+    EXPECT_EQ(stalls, 16u * 4u);
+    EXPECT_TRUE(apu.irqAsserted());
+    EXPECT_EQ(apu.readStatus() & 0x90, 0x80);
+
+    // writing $4015 acknowledges the DMC IRQ
+    apu.writeRegister(0x4015, 0x00);
+    EXPECT_FALSE(apu.irqAsserted());
+}
+
+TEST_F(APURegisters, SaveStateRestoresTiming) {
+    apu.writeRegister(0x4017, 0x00);
+    run(10000);
+    std::vector<uint8_t> state;
+    StateWriter writer(state);
+    apu.saveState(writer);
+
+    run(25000);
+    ASSERT_TRUE(apu.irqAsserted());
+
+    StateReader reader(state);
+    apu.loadState(reader);
+    EXPECT_TRUE(reader.atEnd());
+    EXPECT_FALSE(apu.irqAsserted());
+    run(3 + 29828 - 10000 - 1);
+    EXPECT_FALSE(apu.irqAsserted());
+    run(1);
+    EXPECT_TRUE(apu.irqAsserted());
+}
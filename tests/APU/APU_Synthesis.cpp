@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "../../include/APU/APU.h"
+#include "../../include/APU/AudioRing.h"
+#include "../../include/APU/BlipBuffer.h"
+#include "../../include/Cartridge.h"
+#include "../TestRoms.h"
+
+namespace {
+
+constexpr double CPU_HZ = 1789773.0;
+constexpr uint32_t FRAME_CYCLES = 29781;
+
+std::vector<int16_t> drain(AudioRing &ring) {
+    std::vector<int16_t> out(ring.size());
+    out.resize(ring.pop(out.data(), out.size()));
+    return out;
+}
+
+} // namespace
+
+TEST(APUSynthesis, BlipStepSettlesAtDelta) {
+    BlipBuffer blip;
+    blip.setRates(CPU_HZ, 48000.0, FRAME_CYCLES);
+    blip.addDelta(100, 0.5f);
+    blip.endFrame(FRAME_CYCLES);
+    std::vector<int16_t> out(blip.samplesAvailable());
+    ASSERT_EQ(blip.readSamples(out.data(), out.size()), out.size());
+    EXPECT_NEAR(static_cast<double>(out.size()), 48000.0 * FRAME_CYCLES / CPU_HZ,
+                1.0);
+
+    // silent before the step, then close to 0.5 full scale; the DC blocker
+    // only lets it sag slowly
+    EXPECT_EQ(out[0], 0);
+    EXPECT_NEAR(out[16], 0.5 * 32767, 0.04 * 32767);
+    for (std::size_t i = 1; i < out.size(); i++) {
+        EXPECT_LE(out[i], 0.5 * 32767 * 1.1);
+    }
+}
+
+TEST(APUSynthesis, RingWrapsAndDropsWhenFull) {
+    AudioRing ring(6);
+    ASSERT_EQ(ring.capacity(), 8u);
+    const int16_t in[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    int16_t out[10] = {};
+    EXPECT_EQ(ring.push(in, 5), 5u);
+    EXPECT_EQ(ring.pop(out, 3), 3u);
+    EXPECT_EQ(out[2], 3);
+    EXPECT_EQ(ring.push(in, 10), 6u); // 2 left + 6 fit
+    EXPECT_EQ(ring.size(), 8u);
+    EXPECT_EQ(ring.pop(out, 10), 8u);
+    EXPECT_EQ(out[0], 4);
+    EXPECT_EQ(out[1], 5);
+    EXPECT_EQ(out[2], 1);
+    EXPECT_EQ(out[7], 6);
+    EXPECT_EQ(ring.pop(out, 10), 0u);
+
+    // the dropping push and both short pops are counted
+    EXPECT_EQ(ring.overrunCount(), 1u);
+    EXPECT_EQ(ring.underrunCount(), 2u);
+}
+
+TEST(APUSynthesis, PulsePlaysAtItsFrequency) {
+    Cartridge cart(testroms::makeINES(0x4000, 0x2000));
+    APU apu(cart);
+    drain(apu.output());
+
+    // 50% duty, constant volume 15, period 253: 1789773 / (16 * 254) Hz
+    apu.writeRegister(0x4015, 0x01);
+    apu.writeRegister(0x4000, 0xBF);
+    apu.writeRegister(0x4002, 0xFD);
+    apu.writeRegister(0x4003, 0x00); // length 10
+    for (int frame = 0; frame < 4; frame++) {
+        apu.clock(FRAME_CYCLES);
+        apu.endFrame();
+    }
+    const std::vector<int16_t> samples = drain(apu.output());
+    ASSERT_NEAR(static_cast<double>(samples.size()),
+                4 * 48000.0 * FRAME_CYCLES / CPU_HZ, 2.0);
+
+    // count low to high swings, with hysteresis against the band-limited
+    // ringing at each edge
+    int rising = 0;
+    bool high = true;
+    for (int16_t sample : samples) {
+        if (high && sample < -1000) {
+            high = false;
+        } else if (!high && sample > 1000) {
+            high = true;
+            rising++;
+        }
+    }
+    const double seconds = samples.size() / 48000.0;
+    const double expected = CPU_HZ / (16.0 * 254.0) * seconds;
+    EXPECT_NEAR(rising, expected, 2.0);
+}
+
+TEST(APUSynthesis, SilentWithoutChannelsAndWhileMuted) {
+    Cartridge cart(testroms::makeINES(0x4000, 0x2000));
+    APU apu(cart);
+    apu.clock(FRAME_CYCLES);
+    apu.endFrame();
+    for (int16_t sample : drain(apu.output())) {
+        EXPECT_EQ(sample, 0);
+    }
+
+    apu.writeRegister(0x4015, 0x08);
+    apu.writeRegister(0x400C, 0x3F);
+    apu.writeRegister(0x400F, 0x00);
+    apu.setAudioOutput(false);
+    apu.clock(FRAME_CYCLES);
+    apu.endFrame();
+    EXPECT_EQ(apu.output().size(), 0u);
+
+    apu.setAudioOutput(true);
+    apu.clock(FRAME_CYCLES);
+    apu.endFrame();
+    int loud = 0;
+    for (int16_t sample : drain(apu.output())) {
+        loud += std::abs(sample) > 1000;
+    }
+    EXPECT_GT(loud, 100);
+}
+
+TEST(APUSynthesis, RateRatioScalesSamplesPerFrame) {
+    Cartridge cart(testroms::makeINES(0x4000, 0x2000));
+    APU apu(cart);
+    const double perFrame = 48000.0 * FRAME_CYCLES / CPU_HZ;
+
+    // takes effect from the frame after it is set
+    apu.setRateRatio(1.005);
+    apu.clock(FRAME_CYCLES);
+    apu.endFrame();
+    EXPECT_NEAR(static_cast<double>(drain(apu.output()).size()), perFrame,
+                1.0);
+
+    for (double ratio : {1.005, 0.995}) {
+        apu.setRateRatio(ratio);
+        apu.clock(FRAME_CYCLES);
+        apu.endFrame();
+        drain(apu.output());
+        std::size_t samples = 0;
+        for (int frame = 0; frame < 100; frame++) {
+            apu.clock(FRAME_CYCLES);
+            apu.endFrame();
+            samples += drain(apu.output()).size();
+        }
+        EXPECT_NEAR(static_cast<double>(samples), 100 * perFrame * ratio, 2.0)
+            << ratio;
+    }
+}
@@ -1,153 +1,231 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdio>
 #include <filesystem>
-#include <format>
-#include <fstream>
-#include <nlohmann/json.hpp>
+#include <memory>
+#include <string>
+#include <thread>
 #include <vector>
 
 #include "../../include/CPU/CPU.h"
-#include "../../include/TestBus.h"
-// #include "../../include/CPU/OpCode.h"
+#include "../../include/CPU/OpCode.h"
 #include "../../include/Logger.h"
-
-using json = nlohmann::json;
+#include "../../include/TestBus.h"
+#include "HarteCorpus.h"
 
 /**
- * Tests all documented opcodes from Tom Harte nes6502 tests:
- * https://github.com/SingleStepTests/65x02/tree/main/nes6502
+ * Tests documented and undocumented opcodes against the Tom Harte nes6502
+ * tests: https://github.com/SingleStepTests/65x02/tree/main/nes6502
+ *
+ * Reads the binary corpus harteConvert builds from the JSON (HARTE_CORPUS).
+ * Opcodes are shared out between threads, each with its own CPU and bus, and
+ * every case of an opcode runs even after one fails, so the report gives a
+ * pass count per opcode.
  */
 
-constexpr char HARTE_DIR[] = "nes6502_harte";
+namespace {
+
+// Undocumented opcodes whose results depend on analog effects (the ANE
+// "magic" constant, the unstable high byte AND of SHA/SHX/SHY/TAS), so real
+// 6502s disagree. Their pass counts are reported but not required.
+constexpr std::array<uint8_t, 6> UNSTABLE_OPCODES = {0x8B, 0x93, 0x9F,
+                                                     0x9B, 0x9C, 0x9E};
 
-std::filesystem::path harteTestPath(uint16_t opcode) {
-    return std::filesystem::path(__FILE__).parent_path() / HARTE_DIR /
-           std::format("{:02x}.json", opcode);
+bool isUnstable(uint8_t opcode) {
+    return std::find(UNSTABLE_OPCODES.begin(), UNSTABLE_OPCODES.end(),
+                     opcode) != UNSTABLE_OPCODES.end();
 }
 
-// Define a test fixture for CPU tests.
-class CPUHarteTests : public ::testing::Test {
-  protected:
+struct OpcodeResult {
+    uint32_t cases = 0;
+    uint32_t passed = 0;
+    std::string firstFailure; // empty while every case passes
+};
+
+std::string mismatch(const char *field, uint32_t caseIndex, unsigned expected,
+                     unsigned actual) {
+    char message[96];
+    std::snprintf(message, sizeof(message),
+                  "case %u: %s expected 0x%02X, got 0x%02X", caseIndex, field,
+                  expected, actual);
+    return message;
+}
+
+/**
+ * A CPU and bus of its own, run on one thread.
+ */
+class Worker {
+  private:
     Logger logger;
     TestBus bus;
-    CPU cpu;
+    CPU<TestBus> cpu;
+
+    // empty if the case passed, otherwise what differed
+    std::string runCase(const harte::Case &test, uint32_t caseIndex,
+                        bool instructionStepped) {
+        const harte::Registers &initial = test.header->initial;
+        const harte::Registers &expected = test.header->final;
+        cpu.TEST_setA(initial.a);
+        cpu.TEST_setX(initial.x);
+        cpu.TEST_setY(initial.y);
+        cpu.TEST_setStatus(initial.p);
+        cpu.TEST_setPC(initial.pc);
+        cpu.TEST_setSP(initial.s);
+        for (const harte::RamEntry &ram : test.initialRam) {
+            bus.write(ram.address, ram.value);
+        }
 
-    CPUHarteTests() : logger(), bus(), cpu(bus, logger) {}
-};
+        unsigned cycles = 0;
+        if (instructionStepped) {
+            cycles = cpu.step(); // execute whole instruction
+        } else {
+            cpu.tick(); // start executing new instruction
+            cycles++;
+            // continue ticking until instruction is complete:
+            while (cpu.TEST_getCyclesRemainingInCurrentInstr() > 0) {
+                cpu.tick();
+                cycles++;
+            }
+        }
+
+        if (cycles != test.header->cycles) {
+            return mismatch("cycles", caseIndex, test.header->cycles, cycles);
+        }
+        if (cpu.TEST_getA() != expected.a) {
+            return mismatch("A", caseIndex, expected.a, cpu.TEST_getA());
+        }
+        if (cpu.TEST_getX() != expected.x) {
+            return mismatch("X", caseIndex, expected.x, cpu.TEST_getX());
+        }
+        if (cpu.TEST_getY() != expected.y) {
+            return mismatch("Y", caseIndex, expected.y, cpu.TEST_getY());
+        }
+        if (cpu.TEST_getStatus() != expected.p) {
+            return mismatch("P", caseIndex, expected.p, cpu.TEST_getStatus());
+        }
+        if (cpu.TEST_getPC() != expected.pc) {
+            return mismatch("PC", caseIndex, expected.pc, cpu.TEST_getPC());
+        }
+        if (cpu.TEST_getSP() != expected.s) {
+            return mismatch("SP", caseIndex, expected.s, cpu.TEST_getSP());
+        }
+        for (const harte::RamEntry &ram : test.finalRam) {
+            const uint8_t actual = bus.peek(ram.address);
+            if (actual != ram.value) {
+                char field[16];
+                std::snprintf(field, sizeof(field), "RAM[0x%04X]",
+                              ram.address);
+                return mismatch(field, caseIndex, ram.value, actual);
+            }
+        }
+        return {};
+    }
 
-struct CPUTestState {
-    uint16_t pc;
-    uint8_t s;          // sp
-    uint8_t a, x, y, p; // p = processor status
-    std::vector<std::pair<uint16_t, uint8_t>> ram;
+  public:
+    Worker() : logger(), bus(), cpu(bus, logger) { logger.mute(); }
+
+    OpcodeResult run(const harte::Corpus &corpus, uint8_t opcode,
+                     bool instructionStepped) {
+        OpcodeResult result;
+        corpus.forEachCase(opcode, [&](const harte::Case &test) {
+            std::string failure =
+                runCase(test, result.cases, instructionStepped);
+            if (failure.empty()) {
+                result.passed++;
+            } else if (result.firstFailure.empty()) {
+                result.firstFailure = std::move(failure);
+            }
+            result.cases++;
+        });
+        return result;
+    }
 };
 
-// Function to load JSON file
-json load_json(const std::string &filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        throw std::runtime_error("Cannot open file: " + filename);
+std::array<OpcodeResult, 256> runCorpus(const harte::Corpus &corpus,
+                                        bool instructionStepped) {
+    std::array<OpcodeResult, 256> results;
+    std::atomic<int> nextOpcode = 0;
+    auto work = [&] {
+        // 64 KiB of bus memory each, kept off the thread's stack
+        auto worker = std::make_unique<Worker>();
+        for (int opcode = nextOpcode++; opcode < 256; opcode = nextOpcode++) {
+            results[opcode] = worker->run(corpus, static_cast<uint8_t>(opcode),
+                                          instructionStepped);
+        }
+    };
+
+    const unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> helpers;
+    for (unsigned i = 1; i < threads; i++) {
+        helpers.emplace_back(work);
+    }
+    work();
+    for (std::thread &helper : helpers) {
+        helper.join();
     }
-    json j;
-    file >> j;
-    return j;
+    return results;
 }
 
-// Convert JSON object to CPUTestState
-CPUTestState parse_state(const json &j) {
-    CPUTestState state;
-    state.pc = j["pc"];
-    state.s = j["s"];
-    state.a = j["a"];
-    state.x = j["x"];
-    state.y = j["y"];
-    state.p = j["p"]; // status
-
-    for (const auto &entry : j["ram"]) {
-        state.ram.emplace_back(entry[0], entry[1]);
+void report(const std::array<OpcodeResult, 256> &results) {
+    uint32_t cases = 0;
+    uint32_t passed = 0;
+    std::string untested;
+    for (int opcode = 0; opcode < 256; opcode++) {
+        const OpcodeResult &result = results[opcode];
+        const OpCode *op = OpCode::getOpCode(static_cast<uint8_t>(opcode));
+        char line[64];
+        if (result.cases == 0) {
+            std::snprintf(line, sizeof(line), " %02X", opcode);
+            untested += line;
+            continue;
+        }
+        std::snprintf(line, sizeof(line), "%02X %c%s %5u/%-5u%s\n", opcode,
+                      op->isDocumented() ? ' ' : '*', op->name(),
+                      result.passed, result.cases,
+                      isUnstable(static_cast<uint8_t>(opcode)) ? " unstable"
+                                                               : "");
+        std::cout << line;
+        cases += result.cases;
+        passed += result.passed;
+    }
+    std::cout << passed << "/" << cases << " passed";
+    if (!untested.empty()) {
+        std::cout << ", no tests for" << untested;
     }
-    return state;
+    std::cout << std::endl;
 }
 
-TEST_F(CPUHarteTests, runAllHarteTests) {
-    uint num_passed_tests = 0;
-    // logger.mute();
+void runHarteSuite(bool instructionStepped) {
+    ASSERT_TRUE(std::filesystem::exists(HARTE_CORPUS))
+        << HARTE_CORPUS << " is missing, build the harteCorpus target";
+    const harte::Corpus corpus(HARTE_CORPUS);
+    ASSERT_GT(corpus.totalCases(), 0u);
 
-    for (uint16_t opcode = 0x00; opcode <= 0xFF; opcode++) {
-        const OpCode *op = OpCode::getOpCode(opcode); // look up opcode
-        if (op) {
-            if (!op->isDocumented)
-                continue; // only test documented opcodes
-        } else {
+    const std::array<OpcodeResult, 256> results =
+        runCorpus(corpus, instructionStepped);
+    report(results);
+
+    for (int opcode = 0; opcode < 256; opcode++) {
+        if (isUnstable(static_cast<uint8_t>(opcode))) {
             continue;
         }
-        // unpredictable results make some unstable undocmented opcodes almost
-        // impossible to emulate consistently. Nestest provides best possible
-        // testing for undocumented opcodes.
-
-        const std::string filename = harteTestPath(opcode).string();
-        std::cout << "STARTING TEST " << std::format("{:#04x}\n", opcode);
-
-        json tests = load_json(filename);
-
-        for (const auto &test : tests) {
-            CPUTestState initial = parse_state(test["initial"]);
-            CPUTestState expected = parse_state(test["final"]);
-
-            uint8_t expectedCycles = test["cycles"].size();
-            uint8_t actualCycles = 0;
-
-            cpu.TEST_setA(initial.a);
-            cpu.TEST_setX(initial.x);
-            cpu.TEST_setY(initial.y);
-            cpu.TEST_setStatus(initial.p);
-            cpu.TEST_setPC(initial.pc);
-            cpu.TEST_setSP(initial.s);
-            for (const auto &[addr, val] : initial.ram) {
-                bus.write(addr, val);
-            }
+        const OpcodeResult &result = results[opcode];
+        EXPECT_EQ(result.passed, result.cases)
+            << "opcode " << std::hex << opcode << " "
+            << OpCode::getOpCode(static_cast<uint8_t>(opcode))->name()
+            << ", first failure: " << result.firstFailure;
+    }
+}
 
-            cpu.tick(); // start executing new instruction
-            actualCycles++;
-            // continue ticking until instruction is complete:
-            while (cpu.TEST_getCyclesRemainingInCurrentInstr() > 0) {
-                cpu.tick();
-                actualCycles++;
-            }
+} // namespace
 
-            ASSERT_EQ(actualCycles, expectedCycles)
-                << " @ instruction " << test["name"] << " after passing "
-                << num_passed_tests << " tests.";
-            ASSERT_EQ(cpu.TEST_getA(), expected.a)
-                << " @ instruction " << test["name"] << " after passing "
-                << num_passed_tests << " tests.";
-            ASSERT_EQ(cpu.TEST_getX(), expected.x)
-                << " @ instruction " << test["name"] << " after passing "
-                << num_passed_tests << " tests.";
-            ASSERT_EQ(cpu.TEST_getY(), expected.y)
-                << " @ instruction " << test["name"] << " after passing "
-                << num_passed_tests << " tests.";
-            ASSERT_EQ(cpu.TEST_getStatus(), expected.p)
-                << " @ instruction " << test["name"] << " after passing "
-                << num_passed_tests << " tests.";
-            ASSERT_EQ(cpu.TEST_getPC(), expected.pc)
-                << " @ instruction " << test["name"] << " after passing "
-                << num_passed_tests << " tests.";
-            ASSERT_EQ(cpu.TEST_getSP(), expected.s)
-                << " @ instruction " << test["name"] << " after passing "
-                << num_passed_tests << " tests.";
-            for (const auto &[addr, expectedRead] : expected.ram) {
-                // Compare the single byte at 'addr'
-                uint8_t actualRead = bus.read(addr);
-                ASSERT_EQ(actualRead, expectedRead)
-                    << "Mismatch at mem addr " << std::uppercase
-                    << std::format("{:#06x} (", addr) << addr
-                    << ") @ instruction " << test["name"] << " after passing "
-                    << num_passed_tests << " tests.";
-            }
-            num_passed_tests++;
-        }
-    }
+TEST(CPUHarteTests, runAllHarteTests) { runHarteSuite(false); }
+
+TEST(CPUHarteTests, runAllHarteTestsInstructionStepped) {
+    runHarteSuite(true);
 }
 
 // Main entry point for the tests.
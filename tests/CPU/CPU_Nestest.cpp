@@ -18,8 +18,7 @@ TEST(CPUNestest, TraceMatchesExpectedLog) {
     const std::vector<std::string> expectedLines = readExpectedCpuTrace();
     ASSERT_FALSE(expectedLines.empty());
 
-    Renderer renderer(nullptr, nullptr, nullptr);
-    NES nes(std::move(renderer), nestest::readBinaryFile("nestest.nes"));
+    NES nes(nestest::readBinaryFile("nestest.nes"));
     nes.cpu.TEST_setPC(0xC000);
 
     // The reference log assumes the PPU advanced during the 7-cycle reset.
@@ -29,13 +28,12 @@ TEST(CPUNestest, TraceMatchesExpectedLog) {
 
     nestest::LineCompareStreamBuf compareBuf(expectedLines);
     nestest::ScopedStreamCapture capture(&compareBuf);
-    nestest::CpuPpuStepper stepper(nes);
 
     constexpr uint64_t kMaxCpuTicks = 100000;
     for (uint64_t cpuTicks = 0;
          cpuTicks < kMaxCpuTicks && !compareBuf.done() && !compareBuf.failed();
          cpuTicks++) {
-        stepper.tick();
+        nes.runCycles(1);
     }
 
     std::cout.flush();
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../../include/TraceRecorder.h"
+#include "../NestestTrace.h"
+
+namespace {
+
+TraceRecord recordAt(uint64_t cycles) {
+    TraceRecord record{};
+    record.cycles = cycles;
+    record.opBytes = {0xEA, 0x00, 0x00};
+    record.opByteCount = 1;
+    return record;
+}
+
+std::string formatLine(const TraceRecord &record) {
+    char line[Logger::MAX_LINE_LENGTH];
+    return std::string(line, Logger::format(record, line));
+}
+
+std::filesystem::path tracePath(const char *name) {
+    return std::filesystem::temp_directory_path() / name;
+}
+
+} // namespace
+
+TEST(CPUTrace, BinaryTraceMatchesExpectedLog) {
+    std::vector<std::string> expectedLines =
+        nestest::readLines("nestest_cpu_exp.log");
+    ASSERT_FALSE(expectedLines.empty());
+    for (std::string &line : expectedLines) {
+        line = nestest::swapPpuFields(line);
+    }
+
+    NES nes(nestest::readBinaryFile("nestest.nes"));
+    nes.cpu.TEST_setPC(0xC000);
+    for (int i = 0; i < 21; i++) {
+        nes.ppu.tick();
+    }
+
+    TraceRecorder recorder(expectedLines.size());
+    nes.log.recordTo(&recorder);
+    constexpr uint64_t kMaxCpuCycles = 100000;
+    nes.runUntil([&] {
+        return recorder.written() >= expectedLines.size() ||
+               nes.cpu.getCycleCount() >= kMaxCpuCycles;
+    });
+
+    const std::vector<TraceRecord> records = recorder.snapshot();
+    ASSERT_EQ(records.size(), expectedLines.size());
+    for (std::size_t i = 0; i < records.size(); i++) {
+        ASSERT_EQ(formatLine(records[i]), expectedLines[i])
+            << "at line " << i + 1;
+    }
+}
+
+TEST(CPUTrace, MutedLoggerRecordsNothing) {
+    TraceRecorder recorder(16);
+    Logger logger;
+    logger.recordTo(&recorder);
+    logger.mute();
+    logger.log(recordAt(7));
+    EXPECT_EQ(recorder.written(), 0u);
+
+    logger.unmute();
+    logger.log(recordAt(7));
+    EXPECT_EQ(recorder.written(), 1u);
+}
+
+TEST(CPUTrace, RingKeepsMostRecentRecords) {
+    TraceRecorder recorder(5);
+    EXPECT_EQ(recorder.capacity(), 8u); // rounded up to a power of two
+
+    for (uint64_t cycles = 0; cycles < 20; cycles++) {
+        recorder.append(recordAt(cycles));
+    }
+    EXPECT_EQ(recorder.written(), 20u);
+    const std::vector<TraceRecord> records = recorder.snapshot();
+    ASSERT_EQ(records.size(), 8u);
+    for (std::size_t i = 0; i < records.size(); i++) {
+        EXPECT_EQ(records[i].cycles, 12 + i);
+    }
+}
+
+TEST(CPUTrace, FileHoldsRecordsInOrder) {
+    const std::filesystem::path partial = tracePath("nes_trace_partial.bin");
+    const std::filesystem::path wrapped = tracePath("nes_trace_wrapped.bin");
+    {
+        TraceRecorder partialRecorder(partial.string(), 8);
+        TraceRecorder wrappedRecorder(wrapped.string(), 8);
+        for (uint64_t cycles = 0; cycles < 5; cycles++) {
+            partialRecorder.append(recordAt(cycles));
+        }
+        for (uint64_t cycles = 0; cycles < 13; cycles++) {
+            wrappedRecorder.append(recordAt(cycles));
+        }
+    }
+
+    const std::vector<TraceRecord> partialRecords =
+        TraceRecorder::readFile(partial.string());
+    ASSERT_EQ(partialRecords.size(), 5u);
+    for (std::size_t i = 0; i < partialRecords.size(); i++) {
+        EXPECT_EQ(partialRecords[i].cycles, i);
+    }
+
+    const std::vector<TraceRecord> wrappedRecords =
+        TraceRecorder::readFile(wrapped.string());
+    ASSERT_EQ(wrappedRecords.size(), 8u);
+    for (std::size_t i = 0; i < wrappedRecords.size(); i++) {
+        EXPECT_EQ(wrappedRecords[i].cycles, 5 + i);
+    }
+    EXPECT_EQ(formatLine(wrappedRecords[0]), formatLine(recordAt(5)));
+
+    std::filesystem::remove(partial);
+    std::filesystem::remove(wrapped);
+}
+
+TEST(CPUTrace, ReadFileRejectsOtherFiles) {
+    const std::filesystem::path path = tracePath("nes_trace_invalid.bin");
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "not a trace file, but long enough for a header";
+    }
+    EXPECT_THROW(TraceRecorder::readFile(path.string()), std::runtime_error);
+    std::filesystem::remove(path);
+
+    EXPECT_THROW(TraceRecorder::readFile(path.string()), std::runtime_error);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
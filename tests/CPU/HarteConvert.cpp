@@ -0,0 +1,134 @@
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "HarteCorpus.h"
+
+/**
+ * Converts the Tom Harte nes6502 JSON tests (00.json to ff.json, missing
+ * files skipped) into one binary corpus for runCPUHarteTests, see
+ * HarteCorpus.h. Run by the build when the JSON changes.
+ *
+ * Usage: harteConvert <json dir> <corpus out>
+ */
+
+using json = nlohmann::json;
+
+namespace {
+
+template <typename T> void append(std::vector<uint8_t> &out, const T &value) {
+    const auto *bytes = reinterpret_cast<const uint8_t *>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+harte::Registers parseRegisters(const json &state) {
+    harte::Registers registers{};
+    registers.pc = state["pc"];
+    registers.s = state["s"];
+    registers.a = state["a"];
+    registers.x = state["x"];
+    registers.y = state["y"];
+    registers.p = state["p"];
+    return registers;
+}
+
+uint8_t ramCount(const json &state) {
+    if (state["ram"].size() > UINT8_MAX) {
+        throw std::runtime_error("Too many RAM entries in one test");
+    }
+    return static_cast<uint8_t>(state["ram"].size());
+}
+
+void appendRam(std::vector<uint8_t> &out, const json &state) {
+    for (const auto &entry : state["ram"]) {
+        harte::RamEntry ram{};
+        ram.address = entry[0];
+        ram.value = entry[1];
+        append(out, ram);
+    }
+}
+
+// appends every case in the file, returns how many
+uint32_t appendCases(std::vector<uint8_t> &out,
+                     const std::filesystem::path &file) {
+    std::ifstream in(file);
+    if (!in) {
+        throw std::runtime_error("Cannot open file: " + file.string());
+    }
+    const json tests = json::parse(in);
+
+    for (const auto &test : tests) {
+        harte::CaseHeader header{};
+        header.initial = parseRegisters(test["initial"]);
+        header.final = parseRegisters(test["final"]);
+        header.cycles = static_cast<uint8_t>(test["cycles"].size());
+        header.initialRam = ramCount(test["initial"]);
+        header.finalRam = ramCount(test["final"]);
+        append(out, header);
+        appendRam(out, test["initial"]);
+        appendRam(out, test["final"]);
+    }
+    return static_cast<uint32_t>(tests.size());
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: harteConvert <json dir> <corpus out>" << std::endl;
+        return 1;
+    }
+    const std::filesystem::path jsonDir(argv[1]);
+    const std::filesystem::path outPath(argv[2]);
+
+    harte::CorpusHeader header{};
+    std::memcpy(header.magic, harte::MAGIC, sizeof(header.magic));
+    header.version = harte::VERSION;
+    std::array<harte::OpcodeEntry, 256> index{};
+    std::vector<uint8_t> cases;
+    const std::size_t casesOffset = sizeof(header) + sizeof(index);
+
+    try {
+        for (int opcode = 0; opcode < 256; opcode++) {
+            char name[8];
+            std::snprintf(name, sizeof(name), "%02x.json", opcode);
+            const std::filesystem::path file = jsonDir / name;
+            if (!std::filesystem::exists(file)) {
+                continue;
+            }
+            index[opcode].offset = casesOffset + cases.size();
+            index[opcode].cases = appendCases(cases, file);
+            header.totalCases += index[opcode].cases;
+        }
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    // written to a temporary name first, so a failed run leaves no corpus
+    const std::filesystem::path tempPath = outPath.string() + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(index.data()), sizeof(index));
+        out.write(reinterpret_cast<const char *>(cases.data()),
+                  static_cast<std::streamsize>(cases.size()));
+        if (!out) {
+            std::cerr << "Cannot write " << tempPath << std::endl;
+            return 1;
+        }
+    }
+    std::filesystem::rename(tempPath, outPath);
+    std::cout << "Converted " << header.totalCases << " tests to " << outPath
+              << std::endl;
+    return 0;
+}
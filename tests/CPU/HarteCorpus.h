@@ -0,0 +1,137 @@
+#ifndef HARTE_CORPUS_H
+#define HARTE_CORPUS_H
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+#include "../../include/RomImage.h"
+
+/**
+ * Binary form of the Tom Harte nes6502 tests, written once by harteConvert
+ * from the JSON files so the test runner only has to map it:
+ *
+ *   CorpusHeader
+ *   OpcodeEntry[256]     where each opcode's cases start, and how many
+ *   cases, each a CaseHeader followed by its initial then final RamEntries
+ *
+ * All fields are little endian with explicit padding, so the file can be
+ * read in place.
+ */
+
+namespace harte {
+
+constexpr char MAGIC[8] = {'H', 'A', 'R', 'T', 'E', 'B', 'I', 'N'};
+constexpr uint32_t VERSION = 1;
+
+struct CorpusHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t totalCases;
+};
+
+struct OpcodeEntry {
+    uint64_t offset; // from the start of the file
+    uint32_t cases;  // zero if the opcode has no JSON file
+    uint32_t reserved;
+};
+
+struct Registers {
+    uint16_t pc;
+    uint8_t s;
+    uint8_t a;
+    uint8_t x;
+    uint8_t y;
+    uint8_t p;
+    uint8_t reserved;
+};
+
+struct CaseHeader {
+    Registers initial;
+    Registers final;
+    uint8_t cycles; // bus cycles the instruction takes
+    uint8_t initialRam;
+    uint8_t finalRam;
+    uint8_t reserved;
+};
+
+struct RamEntry {
+    uint16_t address;
+    uint8_t value;
+    uint8_t reserved;
+};
+
+static_assert(sizeof(CorpusHeader) == 16);
+static_assert(sizeof(OpcodeEntry) == 16);
+static_assert(sizeof(CaseHeader) == 20);
+static_assert(sizeof(RamEntry) == 4);
+
+inline std::size_t caseSize(const CaseHeader &header) {
+    return sizeof(CaseHeader) +
+           (header.initialRam + header.finalRam) * sizeof(RamEntry);
+}
+
+/**
+ * One test case, pointing into the corpus.
+ */
+struct Case {
+    const CaseHeader *header;
+    std::span<const RamEntry> initialRam;
+    std::span<const RamEntry> finalRam;
+};
+
+/**
+ * A corpus file mapped read-only. Throws std::runtime_error if it cannot be
+ * opened or was not written by this version of harteConvert.
+ */
+class Corpus {
+  private:
+    std::shared_ptr<const RomImage> image;
+    std::array<OpcodeEntry, 256> index{};
+    uint32_t total = 0;
+
+  public:
+    explicit Corpus(const std::string &path) : image(RomImage::open(path)) {
+        const std::span<const uint8_t> bytes = image->bytes();
+        CorpusHeader header{};
+        if (bytes.size() < sizeof(header) + sizeof(index)) {
+            throw std::runtime_error("Not a Harte corpus: " + path);
+        }
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+            header.version != VERSION) {
+            throw std::runtime_error("Not a Harte corpus: " + path);
+        }
+        std::memcpy(index.data(), bytes.data() + sizeof(header),
+                    sizeof(index));
+        total = header.totalCases;
+    }
+
+    uint32_t totalCases() const { return total; }
+    uint32_t caseCount(uint8_t opcode) const { return index[opcode].cases; }
+
+    /**
+     * Calls visit(const Case &) for each case of opcode, in file order.
+     */
+    template <typename Visit>
+    void forEachCase(uint8_t opcode, Visit &&visit) const {
+        const uint8_t *at = image->bytes().data() + index[opcode].offset;
+        for (uint32_t i = 0; i < index[opcode].cases; i++) {
+            const auto *header = reinterpret_cast<const CaseHeader *>(at);
+            const auto *ram =
+                reinterpret_cast<const RamEntry *>(at + sizeof(CaseHeader));
+            visit(Case{header,
+                       {ram, header->initialRam},
+                       {ram + header->initialRam, header->finalRam}});
+            at += caseSize(*header);
+        }
+    }
+};
+
+} // namespace harte
+
+#endif // HARTE_CORPUS_H
@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../../include/Cartridge.h"
+#include "../../include/Hash.h"
+#include "../../include/RomDatabase.h"
+#include "../TestRoms.h"
+
+namespace {
+
+// 16 byte header with the given bytes 4-15, followed by prgSize + chrSize
+// bytes of ROM with a recognisable pattern.
+std::vector<uint8_t> makeRom(const std::array<uint8_t, 12> &bytes4To15,
+                             std::size_t prgSize, std::size_t chrSize) {
+    std::vector<uint8_t> rom = testroms::makeINES(prgSize, chrSize);
+    for (std::size_t i = 0; i < bytes4To15.size(); i++) {
+        rom[4 + i] = bytes4To15[i];
+    }
+    for (std::size_t i = 16; i < rom.size(); i++) {
+        rom[i] = static_cast<uint8_t>(i * 7);
+    }
+    return rom;
+}
+
+} // namespace
+
+TEST(CartridgeHeader, ParsesINES) {
+    // 2x16 KiB PRG, 1x8 KiB CHR, mapper 0x41, vertical, battery, PAL
+    const RomHeader header = RomHeader::parse(
+        makeRom({2, 1, 0x13, 0x40, 0, 1, 0, 0, 0, 0, 0, 0}, 0x8000, 0x2000));
+    EXPECT_EQ(header.format, RomFormat::INES);
+    EXPECT_EQ(header.mapper, 0x41);
+    EXPECT_EQ(header.mirroring, MirroringMode::Vertical);
+    EXPECT_TRUE(header.battery);
+    EXPECT_EQ(header.region, NESRegion::PAL);
+    EXPECT_EQ(header.prgRomSize, 0x8000u);
+    EXPECT_EQ(header.chrRomSize, 0x2000u);
+    EXPECT_EQ(header.prgNvramSize, 0x2000u);
+    EXPECT_EQ(header.chrRamSize, 0u);
+}
+
+TEST(CartridgeHeader, IgnoresFlags7OfSignedINESHeaders) {
+    // "DiskDude!" in bytes 7-15
+    const RomHeader header = RomHeader::parse(
+        makeRom({1, 0, 0x10, 'D', 'i', 's', 'k', 'D', 'u', 'd', 'e', '!'},
+                0x4000, 0));
+    EXPECT_EQ(header.mapper, 1);
+    EXPECT_EQ(header.region, NESRegion::NTSC);
+    EXPECT_EQ(header.chrRamSize, 0x2000u);
+}
+
+TEST(CartridgeHeader, ParsesNES2) {
+    // mapper 0x104 submapper 3, PRG 0x102 x 16 KiB (MSB nibble 1),
+    // 8 KiB PRG RAM, 32 KiB PRG NVRAM, 8 KiB CHR RAM, Dendy
+    const RomHeader header = RomHeader::parse(makeRom(
+        {0x02, 0x00, 0x40, 0x08, 0x31, 0x01, 0x97, 0x07, 0x03, 0, 0, 0},
+        0x102 * 0x4000, 0));
+    EXPECT_EQ(header.format, RomFormat::NES2);
+    EXPECT_EQ(header.mapper, 0x104);
+    EXPECT_EQ(header.submapper, 3);
+    EXPECT_EQ(header.prgRomSize, 0x102u * 0x4000u);
+    EXPECT_EQ(header.chrRomSize, 0u);
+    EXPECT_EQ(header.prgRamSize, 0x2000u);
+    EXPECT_EQ(header.prgNvramSize, 0x8000u);
+    EXPECT_EQ(header.chrRamSize, 0x2000u);
+    EXPECT_EQ(header.region, NESRegion::Dendy);
+}
+
+TEST(CartridgeHeader, ParsesNES2ExponentSizes) {
+    // PRG 2^15 * 1, CHR 2^13 * 3
+    const RomHeader header = RomHeader::parse(makeRom(
+        {15 << 2, (13 << 2) | 1, 0, 0x08, 0, 0xFF, 0, 0, 0, 0, 0, 0}, 0x8000,
+        0x6000));
+    EXPECT_EQ(header.prgRomSize, 0x8000u);
+    EXPECT_EQ(header.chrRomSize, 0x6000u);
+}
+
+TEST(CartridgeHeader, RejectsTruncatedROM) {
+    std::vector<uint8_t> rom =
+        makeRom({2, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, 0x8000, 0x2000);
+    rom.pop_back();
+    EXPECT_THROW(RomHeader::parse(rom), std::invalid_argument);
+}
+
+TEST(CartridgeHeader, NES2SetsUpCartridge) {
+    // UxROM, NES 2.0, PAL, 16 KiB CHR RAM
+    Cartridge cart(makeRom({8, 0, 0x20, 0x08, 0, 0, 0, 0x08, 1, 0, 0, 0},
+                           0x20000, 0));
+    EXPECT_EQ(cart.getMapperID(), 2);
+    EXPECT_EQ(cart.getRegion(), NESRegion::PAL);
+    EXPECT_EQ(cart.prg_ram_page(0x6000), nullptr);
+    cart.write_prg(0x8000, 0);
+    cart.write_chr_ram(0x1FFF, 0x5A);
+    EXPECT_EQ(cart.read_chr_rom(0x1FFF), 0x5A);
+}
+
+TEST(CartridgeHeader, CRC32MatchesReference) {
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    EXPECT_EQ(crc32(check, sizeof(check)), 0xCBF43926u);
+    // continuing a CRC is the same as hashing the concatenation
+    EXPECT_EQ(crc32(check + 4, 5, crc32(check, 4)), 0xCBF43926u);
+}
+
+TEST(CartridgeHeader, DatabaseCorrectsBadHeader) {
+    // header claims NROM, NTSC, horizontal
+    const std::vector<uint8_t> rom =
+        makeRom({2, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, 0x8000, 0x2000);
+    const uint32_t crc = crc32(rom.data() + 16, rom.size() - 16);
+
+    const std::array<RomDatabaseEntry, 3> entries{{
+        {crc - 1, 0, 0, MirroringMode::Horizontal, NESRegion::NTSC, 0, 0},
+        {crc, 3, 0, MirroringMode::Vertical, NESRegion::PAL, 0, 0x2000},
+        {crc + 1, 0, 0, MirroringMode::Horizontal, NESRegion::NTSC, 0, 0},
+    }};
+    const RomDatabase database(entries);
+    ASSERT_EQ(database.find(crc), &entries[1]);
+    EXPECT_EQ(database.find(crc + 2), nullptr);
+
+    Cartridge cart;
+    cart.load(rom, database);
+    EXPECT_EQ(cart.getCRC32(), crc);
+    EXPECT_EQ(cart.getMapperID(), 3);
+    EXPECT_EQ(cart.getRegion(), NESRegion::PAL);
+    EXPECT_EQ(cart.getMirroring(), MirroringMode::Vertical);
+    EXPECT_TRUE(cart.getHeader().battery);
+    EXPECT_NE(cart.prg_ram_page(0x6000), nullptr);
+
+    // without the database the header is used as is
+    cart.load(rom, RomDatabase(std::span<const RomDatabaseEntry>{}));
+    EXPECT_EQ(cart.getMapperID(), 0);
+    EXPECT_EQ(cart.getRegion(), NESRegion::NTSC);
+}
+
+TEST(CartridgeHeader, ReadsDatabaseFile) {
+    const std::vector<uint8_t> rom =
+        makeRom({2, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, 0x8000, 0x2000);
+    const uint32_t crc = crc32(rom.data() + 16, rom.size() - 16);
+    char crcText[9];
+    std::snprintf(crcText, sizeof(crcText), "%08x", crc);
+
+    const std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "nes_rom_db.txt";
+    {
+        std::ofstream file(path);
+        file << "# crc32 mapper submapper mirroring region prgram prgnvram\n"
+             << "\n"
+             << "FFFFFFFF 1 0 H NTSC 0 8192\n"
+             << crcText << " 3 0 V PAL 0 0 # out of order\n";
+    }
+    const std::vector<RomDatabaseEntry> entries =
+        RomDatabase::readFile(path.string());
+    ASSERT_EQ(entries.size(), 2u);
+    EXPECT_EQ(entries[0].crc32, 0xFFFFFFFFu);
+    EXPECT_EQ(entries[0].prgNvramSize, 0x2000u);
+
+    // installed tables are sorted and used by default
+    RomDatabase::install(entries);
+    Cartridge cart;
+    cart.load(rom);
+    EXPECT_EQ(cart.getMapperID(), 3);
+    EXPECT_EQ(cart.getRegion(), NESRegion::PAL);
+    EXPECT_EQ(cart.getMirroring(), MirroringMode::Vertical);
+    RomDatabase::install({});
+    cart.load(rom);
+    EXPECT_EQ(cart.getMapperID(), 0);
+
+    {
+        std::ofstream file(path);
+        file << "FFFFFFFF 1 0 H NTSC 0 8192\n"
+             << "FFFFFFFE 1 0 X NTSC 0 0\n";
+    }
+    try {
+        RomDatabase::readFile(path.string());
+        FAIL() << "malformed line accepted";
+    } catch (const std::runtime_error &e) {
+        EXPECT_NE(std::string(e.what()).find(":2:"), std::string::npos)
+            << e.what();
+    }
+    std::filesystem::remove(path);
+    EXPECT_THROW(RomDatabase::readFile(path.string()), std::runtime_error);
+}
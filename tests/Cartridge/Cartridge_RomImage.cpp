@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../../include/Cartridge.h"
+#include "../../include/Hash.h"
+#include "../../include/RomImage.h"
+#include "../TestRoms.h"
+
+namespace {
+
+// NROM with 16 KiB PRG, 8 KiB CHR ROM, or 8 KiB CHR RAM if !chrRom
+std::vector<uint8_t> makeRom(bool chrRom) {
+    std::vector<uint8_t> rom =
+        testroms::makeINES(0x4000, chrRom ? 0x2000 : 0);
+    for (std::size_t i = 16; i < rom.size(); i++) {
+        rom[i] = static_cast<uint8_t>(i * 13);
+    }
+    return rom;
+}
+
+class CartridgeRomImage : public ::testing::Test {
+  protected:
+    std::filesystem::path path;
+
+    void SetUp() override {
+        path = std::filesystem::temp_directory_path() /
+               ("nes_rom_image_" +
+                std::string(::testing::UnitTest::GetInstance()
+                                ->current_test_info()
+                                ->name()) +
+                ".nes");
+        const std::vector<uint8_t> rom = makeRom(true);
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char *>(rom.data()),
+                   static_cast<std::streamsize>(rom.size()));
+    }
+
+    void TearDown() override { std::filesystem::remove(path); }
+};
+
+} // namespace
+
+TEST_F(CartridgeRomImage, OpenReadsFile) {
+    const auto image = RomImage::open(path.string());
+    const std::vector<uint8_t> rom = makeRom(true);
+    ASSERT_EQ(image->bytes().size(), rom.size());
+    EXPECT_TRUE(std::equal(rom.begin(), rom.end(), image->bytes().begin()));
+    EXPECT_THROW(RomImage::open(path.string() + ".missing"),
+                 std::runtime_error);
+}
+
+TEST_F(CartridgeRomImage, InstancesShareImage) {
+    const auto image = RomImage::open(path.string());
+    EXPECT_EQ(RomImage::open(path.string()), image);
+
+    Cartridge a;
+    Cartridge b;
+    a.load(RomImage::open(path.string()));
+    b.load(RomImage::open(path.string()));
+
+    // PRG is read in place from the image, not from a per-cartridge copy
+    EXPECT_EQ(a.prg_page(0x8000), image->bytes().data() + 16);
+    EXPECT_EQ(a.prg_page(0x8000), b.prg_page(0x8000));
+    // decoded CHR ROM rows are shared too
+    EXPECT_EQ(&a.read_chr_tile_row(0x0010, false),
+              &b.read_chr_tile_row(0x0010, false));
+    EXPECT_EQ(a.read_chr_rom(0x0010), image->bytes()[16 + 0x4000 + 0x10]);
+    // and so is the CRC32 over PRG ROM + CHR ROM
+    EXPECT_EQ(a.getCRC32(), crc32(image->bytes().data() + 16, 0x6000));
+    EXPECT_EQ(a.getCRC32(), b.getCRC32());
+}
+
+TEST_F(CartridgeRomImage, IgnoresWritesToCHRROM) {
+    Cartridge cart;
+    cart.load(RomImage::open(path.string()));
+    const uint8_t before = cart.read_chr_rom(0x0123);
+    cart.write_chr_ram(0x0123, before ^ 0xFF);
+    EXPECT_EQ(cart.read_chr_rom(0x0123), before);
+}
+
+TEST_F(CartridgeRomImage, CHRRAMIsPerCartridge) {
+    const auto image = RomImage::copy(makeRom(false));
+    Cartridge a;
+    Cartridge b;
+    a.load(image);
+    b.load(image);
+    a.write_chr_ram(0x0040, 0xA5);
+    EXPECT_EQ(a.read_chr_rom(0x0040), 0xA5);
+    EXPECT_EQ(b.read_chr_rom(0x0040), 0x00);
+    EXPECT_NE(&a.read_chr_tile_row(0x0040, false),
+              &b.read_chr_tile_row(0x0040, false));
+}
@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "../../include/Bus.h"
+#include "../../include/Cartridge.h"
+#include "../../include/PPU/PPU.h"
+#include "../../include/SaveState.h"
+#include "../TestRoms.h"
+
+namespace {
+
+// iNES image for the given mapper. The first byte of every 8 KiB PRG bank
+// and every 1 KiB CHR bank holds that bank's number, so a read identifies
+// which bank is mapped. chrKiB of 0 selects 8 KiB CHR-RAM.
+std::vector<uint8_t> makeRom(uint8_t mapper, std::size_t prgKiB,
+                             std::size_t chrKiB) {
+    const std::size_t prgSize = prgKiB * 1024;
+    const std::size_t chrSize = chrKiB * 1024;
+    std::vector<uint8_t> rom = testroms::makeINES(prgSize, chrSize, mapper);
+    for (std::size_t bank = 0; bank < prgSize / 0x2000; bank++) {
+        rom[16 + bank * 0x2000] = static_cast<uint8_t>(bank);
+    }
+    for (std::size_t bank = 0; bank < chrSize / 0x400; bank++) {
+        rom[16 + prgSize + bank * 0x400] = static_cast<uint8_t>(bank);
+    }
+    return rom;
+}
+
+struct Board {
+    Cartridge cart;
+    PPU ppu;
+    APU apu;
+    Bus bus;
+
+    explicit Board(const std::vector<uint8_t> &rom)
+        : cart(rom), ppu(cart), apu(cart), bus(ppu, apu, cart) {}
+
+    // 8 KiB PRG bank mapped at addr
+    uint8_t prgBank(uint16_t addr) { return bus.read(addr); }
+    // 1 KiB CHR bank mapped at addr
+    uint8_t chrBank(uint16_t addr) { return cart.read_chr_rom(addr); }
+
+    void writeMMC1(uint16_t addr, uint8_t value) {
+        for (int bit = 0; bit < 5; bit++) {
+            bus.write(addr, static_cast<uint8_t>((value >> bit) & 0x01));
+        }
+    }
+};
+
+} // namespace
+
+TEST(MapperBankSwitch, UnsupportedMapperThrows) {
+    Cartridge cart;
+    EXPECT_THROW(cart.load(makeRom(5, 32, 8)), std::runtime_error);
+}
+
+TEST(MapperBankSwitch, StateWithoutCartridgeThrows) {
+    Cartridge cart;
+    std::vector<uint8_t> state;
+    StateWriter writer(state);
+    EXPECT_THROW(cart.saveState(writer), std::runtime_error);
+    StateReader reader(state);
+    EXPECT_THROW(cart.loadState(reader), std::runtime_error);
+}
+
+TEST(MapperBankSwitch, StateRestoresBanksAndRejectsBadOnes) {
+    Board board(makeRom(4, 256, 256));
+    board.bus.write(0x8000, 6);
+    board.bus.write(0x8001, 5);
+    board.bus.write(0x8000, 2);
+    board.bus.write(0x8001, 9);
+    std::vector<uint8_t> state;
+    StateWriter writer(state);
+    board.cart.saveState(writer);
+
+    Board restored(makeRom(4, 256, 256));
+    StateReader reader(state);
+    restored.cart.loadState(reader);
+    restored.bus.mapCartridge();
+    EXPECT_EQ(restored.prgBank(0x8000), 5);
+    EXPECT_EQ(restored.chrBank(0x1000), 9);
+
+    // the state starts with 4 PRG and 8 CHR bank numbers, then mirroring;
+    // 32 is one past the last 8 KiB bank of 256 KiB PRG
+    std::vector<uint8_t> badBank = state;
+    badBank[0] = 32;
+    StateReader badBankReader(badBank);
+    EXPECT_THROW(restored.cart.loadState(badBankReader), std::runtime_error);
+
+    std::vector<uint8_t> badMirroring = state;
+    badMirroring[12 * sizeof(uint32_t)] = 5;
+    StateReader badMirroringReader(badMirroring);
+    EXPECT_THROW(restored.cart.loadState(badMirroringReader),
+                 std::runtime_error);
+    restored.bus.mapCartridge();
+    EXPECT_EQ(restored.prgBank(0x8000), 5);
+}
+
+TEST(MapperBankSwitch, PRGRAMIsMappedOnBoardsWithIt) {
+    Board board(makeRom(4, 32, 8));
+    board.bus.write(0x6000, 0x12);
+    board.bus.write(0x7FFF, 0x34);
+    EXPECT_EQ(board.bus.read(0x6000), 0x12);
+    EXPECT_EQ(board.bus.read(0x7FFF), 0x34);
+
+    Board nrom(makeRom(0, 32, 8));
+    nrom.bus.write(0x6000, 0x12);
+    EXPECT_EQ(nrom.bus.read(0x6000), 0);
+}
+
+TEST(MapperBankSwitch, UxROMSwitchesLowBankAndFixesLast) {
+    Board board(makeRom(2, 128, 0));
+    EXPECT_EQ(board.prgBank(0x8000), 0);
+    EXPECT_EQ(board.prgBank(0xC000), 14);
+    EXPECT_EQ(board.prgBank(0xE000), 15);
+
+    board.bus.write(0x8000, 3);
+    EXPECT_EQ(board.prgBank(0x8000), 6);
+    EXPECT_EQ(board.prgBank(0xA000), 7);
+    EXPECT_EQ(board.prgBank(0xC000), 14);
+}
+
+TEST(MapperBankSwitch, CNROMSwitchesCHR) {
+    Board board(makeRom(3, 32, 32));
+    board.bus.write(0xFFFF, 2);
+    EXPECT_EQ(board.chrBank(0x0000), 16);
+    EXPECT_EQ(board.chrBank(0x1C00), 23);
+    EXPECT_EQ(board.prgBank(0x8000), 0);
+}
+
+TEST(MapperBankSwitch, AxROMSwitches32KiBAndSingleScreen) {
+    Board board(makeRom(7, 128, 0));
+    board.bus.write(0x8000, 0x12);
+    EXPECT_EQ(board.prgBank(0x8000), 8);
+    EXPECT_EQ(board.prgBank(0xE000), 11);
+    EXPECT_EQ(board.cart.getMirroring(), MirroringMode::SingleScreenUpper);
+    board.bus.write(0x8000, 0x00);
+    EXPECT_EQ(board.cart.getMirroring(), MirroringMode::SingleScreenLower);
+}
+
+TEST(MapperBankSwitch, MMC1SerialWritesSwitchBanks) {
+    Board board(makeRom(1, 256, 128));
+    // power on: PRG mode 3, last bank fixed at $C000
+    EXPECT_EQ(board.prgBank(0xC000), 30);
+
+    board.writeMMC1(0xE000, 5);
+    EXPECT_EQ(board.prgBank(0x8000), 10);
+    EXPECT_EQ(board.prgBank(0xC000), 30);
+
+    // 4 KiB CHR mode, vertical mirroring
+    board.writeMMC1(0x8000, 0x1E);
+    board.writeMMC1(0xA000, 3);
+    board.writeMMC1(0xC000, 7);
+    EXPECT_EQ(board.chrBank(0x0000), 12);
+    EXPECT_EQ(board.chrBank(0x1000), 28);
+    EXPECT_EQ(board.cart.getMirroring(), MirroringMode::Vertical);
+
+    // PRG mode 2: first bank fixed at $8000
+    board.writeMMC1(0x8000, 0x0B);
+    EXPECT_EQ(board.prgBank(0x8000), 0);
+    EXPECT_EQ(board.prgBank(0xC000), 10);
+    EXPECT_EQ(board.cart.getMirroring(), MirroringMode::Horizontal);
+}
+
+TEST(MapperBankSwitch, MMC1ResetBitClearsShiftRegister) {
+    Board board(makeRom(1, 256, 128));
+    board.bus.write(0xE000, 1);
+    board.bus.write(0xE000, 1);
+    board.bus.write(0xE000, 0x80);
+    board.writeMMC1(0xE000, 2);
+    EXPECT_EQ(board.prgBank(0x8000), 4);
+}
+
+TEST(MapperBankSwitch, MMC3SwitchesPRGAndCHR) {
+    Board board(makeRom(4, 256, 256));
+    for (uint8_t reg = 0; reg < 8; reg++) {
+        board.bus.write(0x8000, reg);
+        board.bus.write(0x8001, static_cast<uint8_t>(reg * 3 + 1));
+    }
+    EXPECT_EQ(board.prgBank(0x8000), 19); // R6
+    EXPECT_EQ(board.prgBank(0xA000), 22); // R7
+    EXPECT_EQ(board.prgBank(0xC000), 30);
+    EXPECT_EQ(board.prgBank(0xE000), 31);
+    EXPECT_EQ(board.chrBank(0x0000), 0); // R0 & 0xFE
+    EXPECT_EQ(board.chrBank(0x0400), 1);
+    EXPECT_EQ(board.chrBank(0x0800), 4); // R1 & 0xFE
+    EXPECT_EQ(board.chrBank(0x1000), 7); // R2
+    EXPECT_EQ(board.chrBank(0x1C00), 16); // R5
+
+    // PRG mode 1 and CHR A12 inversion
+    board.bus.write(0x8000, 0xC0);
+    EXPECT_EQ(board.prgBank(0x8000), 30);
+    EXPECT_EQ(board.prgBank(0xC000), 19);
+    EXPECT_EQ(board.chrBank(0x0000), 7);
+    EXPECT_EQ(board.chrBank(0x1000), 0);
+    EXPECT_EQ(board.chrBank(0x1800), 4);
+}
+
+TEST(MapperBankSwitch, MMC3CountsScanlinesFromA12) {
+    Board board(makeRom(4, 256, 256));
+    board.bus.write(0xC000, 9);    // latch
+    board.bus.write(0xC001, 0);    // reload
+    board.bus.write(0xE001, 0);    // enable
+    board.ppu.write_to_ctrl(0x08); // background $0000, sprites $1000
+    board.ppu.write_to_mask(0x18);
+
+    // scanline 0 reloads the counter, then every following line counts
+    // down, so the IRQ is raised on scanline 9
+    while (!board.cart.irqAsserted()) {
+        ASSERT_LT(board.ppu.getScanline(), 240);
+        board.ppu.tick();
+    }
+    EXPECT_EQ(board.ppu.getScanline(), 9);
+
+    board.bus.write(0xE000, 0); // acknowledge
+    EXPECT_FALSE(board.cart.irqAsserted());
+}
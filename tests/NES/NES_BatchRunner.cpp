@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "../../include/BatchRunner.h"
+#include "../NestestTrace.h"
+
+namespace {
+
+std::shared_ptr<const RomImage> nestestImage() {
+    return RomImage::copy(nestest::readBinaryFile("nestest.nes"));
+}
+
+} // namespace
+
+TEST(NESBatchRunner, MatchesAHeadlessRun) {
+    const auto rom = nestestImage();
+    NES reference(rom);
+    reference.log.mute();
+    const HeadlessResult expected = reference.runHeadless(30);
+    const auto &ram = reference.bus.getCPURAM();
+
+    BatchJob job;
+    job.rom = rom;
+    job.frames = 30;
+    BatchRunner runner(4);
+    const std::vector<BatchResult> results =
+        runner.run(std::vector<BatchJob>(8, job));
+    ASSERT_EQ(results.size(), 8u);
+    for (const BatchResult &result : results) {
+        ASSERT_TRUE(result.ok()) << result.error;
+        EXPECT_EQ(result.frames, 30u);
+        EXPECT_EQ(result.cpuCycles, expected.cpuCycles);
+        EXPECT_EQ(result.frameHash, expected.frameHash);
+        EXPECT_EQ(result.ram, ram);
+    }
+    EXPECT_EQ(runner.stats().threads, 4u);
+    EXPECT_EQ(runner.stats().jobs, 8u);
+}
+
+TEST(NESBatchRunner, ResultsDoNotDependOnThreadCount) {
+    const auto rom = nestestImage();
+    std::vector<BatchJob> jobs;
+    for (uint64_t seed = 0; seed < 6; seed++) {
+        BatchJob job;
+        job.rom = rom;
+        job.frames = 20 + 5 * seed; // uneven, so threads steal
+        job.inputSeed = seed;
+        job.recordFrameHashes = true;
+        jobs.push_back(job);
+    }
+    BatchJob movie;
+    movie.rom = rom;
+    movie.frames = 40;
+    movie.inputMovie.assign(40, 0);
+    movie.inputMovie[10] = Bus::JOYPAD_DOWN; // move the nestest menu cursor
+    movie.recordFrameHashes = true;
+    jobs.push_back(movie);
+
+    const std::vector<BatchResult> serial = BatchRunner(1).run(jobs);
+    const std::vector<BatchResult> parallel = BatchRunner(3).run(jobs);
+    for (std::size_t i = 0; i < jobs.size(); i++) {
+        ASSERT_TRUE(serial[i].ok()) << serial[i].error;
+        EXPECT_EQ(serial[i].frameHashes.size(), jobs[i].frames);
+        EXPECT_EQ(serial[i].frameHashes, parallel[i].frameHashes) << i;
+        EXPECT_EQ(serial[i].ramHash, parallel[i].ramHash) << i;
+        EXPECT_EQ(serial[i].cpuCycles, parallel[i].cpuCycles) << i;
+    }
+
+    // input reaches the game: the movie's frames part from an idle run
+    BatchJob idle = movie;
+    idle.inputMovie.clear();
+    EXPECT_NE(BatchRunner::runJob(idle).frameHash, serial.back().frameHash);
+}
+
+TEST(NESBatchRunner, FailedJobDoesNotStopTheOthers) {
+    BatchJob good;
+    good.rom = nestestImage();
+    good.frames = 5;
+    BatchJob bad; // no ROM
+    const std::vector<BatchResult> results =
+        BatchRunner(2).run({good, bad, good});
+    EXPECT_TRUE(results[0].ok());
+    EXPECT_FALSE(results[1].ok());
+    EXPECT_FALSE(results[1].error.empty());
+    EXPECT_TRUE(results[2].ok());
+    EXPECT_EQ(results[2].frames, 5u);
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "../TestRoms.h"
+
+using testroms::makeNES;
+
+namespace {
+
+// NROM with 8 KiB CHR. Every PRG byte holds its page number plus one, so the
+// byte at a CPU address identifies which ROM page it came from.
+std::vector<uint8_t> makeNrom(uint8_t prgBanks) {
+    const std::size_t prgSize = static_cast<std::size_t>(prgBanks) * 0x4000;
+    std::vector<uint8_t> rom = testroms::makeINES(prgSize, 0x2000);
+    for (std::size_t i = 0; i < prgSize; i++) {
+        rom[16 + i] = static_cast<uint8_t>((i >> 8) + 1);
+    }
+    testroms::setVector(rom, 0xFFFC, 0x8000);
+    return rom;
+}
+
+} // namespace
+
+TEST(NESBusMemoryMap, RAMIsMirroredEvery2KiB) {
+    auto nes = makeNES(makeNrom(2));
+    nes->bus.write(0x0123, 0xAB);
+    for (uint16_t mirror : {0x0123, 0x0923, 0x1123, 0x1923}) {
+        EXPECT_EQ(nes->bus.read(mirror), 0xAB) << std::hex << mirror;
+    }
+    nes->bus.write(0x1FFF, 0xCD);
+    EXPECT_EQ(nes->bus.getCPURAM()[0x07FF], 0xCD);
+}
+
+TEST(NESBusMemoryMap, PRGIsReadPerPage) {
+    auto nes = makeNES(makeNrom(2));
+    for (uint32_t addr = 0x8000; addr <= 0xFFFB; addr += 0x11) {
+        EXPECT_EQ(nes->bus.read(static_cast<uint16_t>(addr)),
+                  ((addr - 0x8000) >> 8) + 1)
+            << std::hex << addr;
+    }
+}
+
+TEST(NESBusMemoryMap, SixteenKiBPRGIsMirrored) {
+    auto nes = makeNES(makeNrom(1));
+    for (uint16_t addr : {0x8000, 0x80FF, 0xA345, 0xBFF0}) {
+        EXPECT_EQ(nes->bus.read(addr), nes->bus.read(addr + 0x4000));
+        EXPECT_EQ(nes->bus.read(addr), ((addr - 0x8000) >> 8) + 1);
+    }
+}
+
+TEST(NESBusMemoryMap, WritesToROMAreIgnored) {
+    auto nes = makeNES(makeNrom(2));
+    const uint8_t before = nes->bus.read(0x9000);
+    nes->bus.write(0x9000, static_cast<uint8_t>(before + 1));
+    EXPECT_EQ(nes->bus.read(0x9000), before);
+}
+
+TEST(NESBusMemoryMap, PPURegistersAreMirroredEvery8Bytes) {
+    auto nes = makeNES(makeNrom(2));
+    // writing $2006 twice then $2007 stores through any mirror
+    nes->bus.write(0x3FFE, 0x21); // $2006
+    nes->bus.write(0x200E, 0x00); // $2006
+    nes->bus.write(0x2F8F, 0x5A); // $2007
+
+    nes->bus.write(0x2006, 0x21);
+    nes->bus.write(0x2006, 0x00);
+    nes->bus.read(0x3007); // buffered read, returns stale data
+    EXPECT_EQ(nes->bus.read(0x2007), 0x5A);
+
+    // write-only registers read back the last value written
+    nes->bus.write(0x2005, 0x77);
+    EXPECT_EQ(nes->bus.read(0x3FF8), 0x77); // mirror of $2000
+}
+
+TEST(NESBusMemoryMap, PRGReadWithoutCartridgeThrows) {
+    Cartridge cart;
+    PPU ppu(cart);
+    APU apu(cart);
+    Bus bus(ppu, apu, cart);
+    EXPECT_THROW(bus.read(0x8000), std::runtime_error);
+    bus.write(0x0001, 0x42);
+    EXPECT_EQ(bus.read(0x0801), 0x42);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
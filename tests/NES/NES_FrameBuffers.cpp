@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <set>
+#include <vector>
+
+#include "../NestestTrace.h"
+#include "../TestRoms.h"
+
+// Count every heap allocation made by this test binary.
+namespace {
+std::atomic<uint64_t> allocationCount{0};
+} // namespace
+
+void *operator new(std::size_t size) {
+    allocationCount++;
+    if (void *memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, std::size_t) noexcept { std::free(memory); }
+
+using testroms::makeNES;
+
+namespace {
+
+uint64_t allocationsDuring(NES &nes, uint64_t frames) {
+    const uint64_t before = allocationCount.load();
+    nes.runHeadless(frames);
+    return allocationCount.load() - before;
+}
+
+} // namespace
+
+TEST(NESFrameBuffers, SteadyStateFramesDoNotAllocate) {
+    const std::vector<uint8_t> rom = nestest::readBinaryFile("nestest.nes");
+    for (SyncMode sync : {SyncMode::CycleStepped, SyncMode::InstructionStepped}) {
+        for (PPURenderMode render :
+             {PPURenderMode::Dot, PPURenderMode::Scanline}) {
+            auto nes = makeNES(rom);
+            nes->clock.setSyncMode(sync);
+            nes->ppu.setRenderMode(render);
+
+            allocationsDuring(*nes, 3); // warm up
+            EXPECT_EQ(allocationsDuring(*nes, 60), 0u);
+        }
+    }
+}
+
+TEST(NESFrameBuffers, RunAheadDoesNotAllocate) {
+    auto nes = makeNES(nestest::readBinaryFile("nestest.nes"));
+    nes->clock.setRunAhead(2);
+
+    allocationsDuring(*nes, 3); // warm up, sizes the snapshot buffer
+    EXPECT_EQ(allocationsDuring(*nes, 60), 0u);
+}
+
+TEST(NESFrameBuffers, CompletedFramesRotateThroughPool) {
+    auto nes = makeNES(nestest::readBinaryFile("nestest.nes"));
+
+    std::vector<const Frame *> completed;
+    completed.reserve(2 * PPU::FRAME_BUFFERS);
+    for (int i = 0; i < 3; i++) {
+        nes->runFrame(); // warm up
+    }
+    const uint64_t before = allocationCount.load();
+    while (completed.size() < 2 * PPU::FRAME_BUFFERS) {
+        completed.push_back(&nes->runFrame());
+    }
+    const uint64_t allocations = allocationCount.load() - before;
+
+    EXPECT_EQ(allocations, 0u);
+    const std::set<const Frame *> distinct(
+        completed.begin(), completed.begin() + PPU::FRAME_BUFFERS);
+    EXPECT_EQ(distinct.size(), PPU::FRAME_BUFFERS);
+    for (std::size_t i = PPU::FRAME_BUFFERS; i < completed.size(); i++) {
+        EXPECT_EQ(completed[i], completed[i - PPU::FRAME_BUFFERS]);
+    }
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "../TestRoms.h"
+
+namespace {
+
+// RAM used by the test program
+constexpr uint16_t FRAME_IRQS = 0x0010; // frame IRQs handled
+constexpr uint16_t MAPPER_IRQS = 0x0011; // MMC3 IRQs handled
+constexpr uint16_t GO = 0x0012; // set to leave the SEI wait loop
+
+// MMC3 board with 32 KiB PRG and 8 KiB CHR running, from the fixed bank at
+// $E000:
+//
+//   reset: SEI
+//   wait:  LDA GO
+//          BEQ wait
+//          BPL cli        ; GO bit 7 set: acknowledge the frame IRQ first
+//          LDA $4015
+//   cli:   CLI
+//   spin:  JMP spin
+//
+//   irq:   PHA
+//          LDA $4015      ; acknowledges the frame IRQ, bit 6 = was raised
+//          AND #$40
+//          BEQ mapper
+//          INC FRAME_IRQS
+//          PLA
+//          RTI
+//   mapper: STA $E000     ; acknowledge and disable the MMC3 IRQ
+//          INC MAPPER_IRQS
+//          PLA
+//          RTI
+std::vector<uint8_t> makeIrqRom() {
+    constexpr std::size_t prgSize = 0x8000;
+    std::vector<uint8_t> rom = testroms::makeINES(prgSize, 0x2000, 4);
+    const std::vector<uint8_t> reset = {
+        0x78,             // SEI
+        0xA5, 0x12,       // LDA GO
+        0xF0, 0xFC,       // BEQ wait
+        0x10, 0x03,       // BPL cli
+        0xAD, 0x15, 0x40, // LDA $4015
+        0x58,             // CLI
+        0x4C, 0x0B, 0xE0, // JMP spin
+    };
+    const std::vector<uint8_t> irq = {
+        0x48,             // PHA
+        0xAD, 0x15, 0x40, // LDA $4015
+        0x29, 0x40,       // AND #$40
+        0xF0, 0x04,       // BEQ mapper
+        0xE6, 0x10,       // INC FRAME_IRQS
+        0x68,             // PLA
+        0x40,             // RTI
+        0x8D, 0x00, 0xE0, // STA $E000
+        0xE6, 0x11,       // INC MAPPER_IRQS
+        0x68,             // PLA
+        0x40,             // RTI
+    };
+    // $E000 is the start of the last 8 KiB of PRG
+    const std::size_t fixedBank = 16 + prgSize - 0x2000;
+    std::copy(reset.begin(), reset.end(), rom.begin() + fixedBank);
+    std::copy(irq.begin(), irq.end(), rom.begin() + fixedBank + 0x100);
+    testroms::setVector(rom, 0xFFFA, 0xE00B); // NMI: spin, never enabled
+    testroms::setVector(rom, 0xFFFC, 0xE000);
+    testroms::setVector(rom, 0xFFFE, 0xE100);
+    return rom;
+}
+
+std::unique_ptr<NES> makeNES(SyncMode sync) {
+    auto nes = testroms::makeNES(makeIrqRom());
+    nes->clock.setSyncMode(sync);
+    return nes;
+}
+
+} // namespace
+
+TEST(NESIRQ, MapperIRQIsTakenWhileFrameIRQIsHigh) {
+    for (SyncMode sync : {SyncMode::CycleStepped, SyncMode::InstructionStepped}) {
+        auto nes = makeNES(sync);
+        nes->bus.write(0xC000, 9); // latch
+        nes->bus.write(0xC001, 0); // reload
+        nes->bus.write(0xE001, 0); // enable
+        nes->ppu.write_to_ctrl(0x08); // background $0000, sprites $1000
+        nes->ppu.write_to_mask(0x18);
+
+        // with I set, let the MMC3 fire while the frame IRQ holds the line
+        nes->runUntil([&] { return nes->apu.irqAsserted(); });
+        nes->runUntil([&] { return nes->cart.irqAsserted(); });
+        ASSERT_TRUE(nes->apu.irqAsserted());
+
+        nes->bus.write(GO, 0x01);
+        nes->runCycles(1000);
+        // the handler acknowledges one source per entry, so it must be
+        // entered again for the MMC3 after acknowledging the frame IRQ
+        EXPECT_EQ(nes->bus.read(FRAME_IRQS), 1);
+        EXPECT_EQ(nes->bus.read(MAPPER_IRQS), 1);
+        EXPECT_FALSE(nes->apu.irqAsserted());
+        EXPECT_FALSE(nes->cart.irqAsserted());
+    }
+}
+
+TEST(NESIRQ, IRQAcknowledgedUnderSEIIsNotTakenAfterCLI) {
+    for (SyncMode sync : {SyncMode::CycleStepped, SyncMode::InstructionStepped}) {
+        auto nes = makeNES(sync);
+        nes->runUntil([&] { return nes->apu.irqAsserted(); });
+
+        nes->bus.write(GO, 0x80);
+        nes->runCycles(1000);
+        EXPECT_FALSE(nes->apu.irqAsserted());
+        EXPECT_EQ(nes->bus.read(FRAME_IRQS), 0);
+        EXPECT_EQ(nes->bus.read(MAPPER_IRQS), 0);
+    }
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
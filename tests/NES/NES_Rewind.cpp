@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "../../include/RewindBuffer.h"
+#include "../NestestTrace.h"
+
+namespace {
+
+// Snapshot-like buffers: mostly constant with a few bytes changing per frame.
+std::vector<std::vector<uint8_t>> makeSnapshots(int count, std::size_t size) {
+    std::vector<std::vector<uint8_t>> snapshots;
+    std::vector<uint8_t> state(size);
+    for (std::size_t i = 0; i < size; i++) {
+        state[i] = static_cast<uint8_t>(i * 7);
+    }
+    uint32_t random = 99;
+    for (int frame = 0; frame < count; frame++) {
+        for (int change = 0; change < 12; change++) {
+            random = random * 1103515245 + 12345;
+            state[(random >> 8) % size] = static_cast<uint8_t>(random >> 24);
+        }
+        snapshots.push_back(state);
+    }
+    return snapshots;
+}
+
+} // namespace
+
+TEST(NESRewind, StepBackReturnsSnapshotsInReverse) {
+    const auto snapshots = makeSnapshots(200, 5000);
+    RewindBuffer rewind(1024 * 1024);
+    for (const auto &snapshot : snapshots) {
+        rewind.push(snapshot);
+    }
+    EXPECT_EQ(rewind.stats().frames, snapshots.size());
+
+    std::vector<uint8_t> restored;
+    for (int frame = static_cast<int>(snapshots.size()) - 2; frame >= 0;
+         frame--) {
+        ASSERT_TRUE(rewind.stepBack(restored));
+        ASSERT_EQ(restored, snapshots[frame]) << "frame " << frame;
+    }
+    EXPECT_FALSE(rewind.stepBack(restored));
+    EXPECT_EQ(rewind.stats().historyBytes, 0u);
+}
+
+TEST(NESRewind, SparseChangesCompressWell) {
+    const auto snapshots = makeSnapshots(100, 5000);
+    RewindBuffer rewind(1024 * 1024);
+    for (const auto &snapshot : snapshots) {
+        rewind.push(snapshot);
+    }
+    // 12 changed bytes per frame should cost tens of bytes, not kilobytes
+    EXPECT_LT(rewind.stats().historyBytes, 99u * 100u);
+}
+
+TEST(NESRewind, BudgetDropsOldestHistory) {
+    const auto snapshots = makeSnapshots(2000, 5000);
+    constexpr std::size_t kBudget = 8 * 1024;
+    RewindBuffer rewind(kBudget);
+    for (const auto &snapshot : snapshots) {
+        rewind.push(snapshot);
+        ASSERT_LE(rewind.stats().historyBytes, kBudget);
+    }
+    const std::size_t held = rewind.stats().frames;
+    EXPECT_GT(held, 1u);
+    EXPECT_LT(held, snapshots.size());
+
+    // whatever is held is still exact, back to the oldest surviving frame
+    std::vector<uint8_t> restored;
+    std::size_t frame = snapshots.size() - 1;
+    while (rewind.stepBack(restored)) {
+        frame--;
+        ASSERT_EQ(restored, snapshots[frame]) << "frame " << frame;
+    }
+    EXPECT_EQ(snapshots.size() - frame, held);
+}
+
+TEST(NESRewind, RecordingContinuesAfterRewinding) {
+    const auto snapshots = makeSnapshots(60, 3000);
+    RewindBuffer rewind(64 * 1024);
+    for (int frame = 0; frame < 40; frame++) {
+        rewind.push(snapshots[frame]);
+    }
+    std::vector<uint8_t> restored;
+    for (int i = 0; i < 10; i++) {
+        ASSERT_TRUE(rewind.stepBack(restored));
+    }
+    ASSERT_EQ(restored, snapshots[29]);
+
+    // new history branches off frame 29
+    for (int frame = 40; frame < 60; frame++) {
+        rewind.push(snapshots[frame]);
+    }
+    for (int frame = 58; frame >= 40; frame--) {
+        ASSERT_TRUE(rewind.stepBack(restored));
+        ASSERT_EQ(restored, snapshots[frame]);
+    }
+    ASSERT_TRUE(rewind.stepBack(restored));
+    EXPECT_EQ(restored, snapshots[29]);
+}
+
+TEST(NESRewind, ClockRewindsNestestFrames) {
+    const std::vector<uint8_t> rom = nestest::readBinaryFile("nestest.nes");
+    NES nes(rom);
+    nes.log.mute();
+    nes.clock.setRewindBudget(1);
+
+    nes.runHeadless(30);
+    std::vector<uint8_t> at30;
+    nes.saveState(at30);
+    nes.runHeadless(30);
+
+    const RewindStats &stats = nes.clock.getRewindStats();
+    EXPECT_EQ(stats.frames, 60u);
+    EXPECT_EQ(stats.framesRecorded, 60u);
+    EXPECT_GT(stats.totalCompressMicros, 0.0);
+
+    for (int i = 0; i < 30; i++) {
+        ASSERT_TRUE(nes.clock.rewindFrame());
+    }
+    std::vector<uint8_t> rewound;
+    nes.saveState(rewound);
+    EXPECT_EQ(rewound, at30);
+
+    // resuming from the rewound state matches an uninterrupted run
+    nes.clock.setRewindBudget(0);
+    const uint64_t resumedHash = nes.runHeadless(30).frameHash;
+
+    NES reference(rom);
+    reference.log.mute();
+    EXPECT_EQ(reference.runHeadless(60).frameHash, resumedHash);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "../../include/Frontend.h"
+#include "../NestestTrace.h"
+#include "../TestRoms.h"
+
+using testroms::makeNES;
+
+namespace {
+
+uint64_t frameHashAfter(const std::vector<uint8_t> &rom, uint64_t frames) {
+    return makeNES(rom)->runHeadless(frames).frameHash;
+}
+
+// closes the window on the first poll
+class QuitFrontend : public Frontend {
+  public:
+    FrontendInput poll() override { return {.quit = true}; }
+    void present(const Frame &) override {}
+};
+
+} // namespace
+
+TEST(NESRunAhead, PresentsFrameFromTheFuture) {
+    const std::vector<uint8_t> rom = nestest::readBinaryFile("nestest.nes");
+    // nestest draws its menu over the first few frames
+    ASSERT_NE(frameHashAfter(rom, 3), frameHashAfter(rom, 5));
+
+    for (uint32_t frames : {1u, 2u}) {
+        auto nes = makeNES(rom);
+        nes->clock.setRunAhead(frames);
+        EXPECT_EQ(nes->runHeadless(3).frameHash,
+                  frameHashAfter(rom, 3 + frames))
+            << frames << " frames ahead";
+
+        const RunAheadStats &stats = nes->clock.getRunAheadStats();
+        EXPECT_EQ(stats.hostFrames, 3u);
+        EXPECT_EQ(stats.framesRun, 3u * frames);
+    }
+}
+
+TEST(NESRunAhead, RealTimelineIsUnaffected) {
+    const std::vector<uint8_t> rom = nestest::readBinaryFile("nestest.nes");
+    auto reference = makeNES(rom);
+    const HeadlessResult expected = reference->runHeadless(20);
+
+    auto nes = makeNES(rom);
+    nes->clock.setRunAhead(2);
+    const HeadlessResult actual = nes->runHeadless(20);
+    EXPECT_EQ(expected.cpuCycles, actual.cpuCycles);
+
+    std::vector<uint8_t> expectedState, actualState;
+    reference->saveState(expectedState);
+    nes->saveState(actualState);
+    EXPECT_EQ(expectedState, actualState);
+}
+
+TEST(NESRunAhead, NoVideoFramesKeepEmulationState) {
+    const std::vector<uint8_t> rom = nestest::readBinaryFile("nestest.nes");
+    for (PPURenderMode mode : {PPURenderMode::Dot, PPURenderMode::Scanline}) {
+        auto withVideo = makeNES(rom);
+        auto withoutVideo = makeNES(rom);
+        withVideo->ppu.setRenderMode(mode);
+        withoutVideo->ppu.setRenderMode(mode);
+        // with run-ahead the real timeline runs without video output
+        withoutVideo->clock.setRunAhead(1);
+
+        withVideo->runHeadless(30);
+        withoutVideo->runHeadless(30);
+
+        std::vector<uint8_t> expected, actual;
+        withVideo->saveState(expected);
+        withoutVideo->saveState(actual);
+        EXPECT_EQ(expected, actual);
+    }
+}
+
+TEST(NESRunAhead, RunLoopShowsFramesAfterRunAhead) {
+    const std::vector<uint8_t> rom = nestest::readBinaryFile("nestest.nes");
+    auto reference = makeNES(rom);
+    reference->runHeadless(3);
+    const uint64_t expected = reference->runFrame().hash();
+
+    auto nes = makeNES(rom);
+    nes->clock.setRunAhead(1);
+    nes->runHeadless(3);
+    EXPECT_EQ(nes->runFrame().hash(), expected);
+
+    // start() leaves video output off on the real timeline
+    nes = makeNES(rom);
+    nes->clock.setRunAhead(1);
+    QuitFrontend frontend;
+    nes->start(frontend);
+    std::vector<uint8_t> state;
+    nes->saveState(state);
+    reference = makeNES(rom);
+    reference->loadState(state);
+    // nestest's first frames are blank, so go on until its menu is drawn
+    for (int i = 0; i < 5; i++) {
+        EXPECT_EQ(nes->runFrame().hash(), reference->runFrame().hash()) << i;
+    }
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
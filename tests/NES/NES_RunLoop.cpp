@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "../NestestTrace.h"
+#include "../TestRoms.h"
+
+using testroms::makeNES;
+
+TEST(NESRunLoop, RunFrameMatchesHeadlessRun) {
+    const std::vector<uint8_t> rom = nestest::readBinaryFile("nestest.nes");
+    for (SyncMode sync : {SyncMode::CycleStepped, SyncMode::InstructionStepped}) {
+        auto reference = makeNES(rom);
+        reference->clock.setSyncMode(sync);
+        const HeadlessResult expected = reference->runHeadless(10);
+
+        auto nes = makeNES(rom);
+        nes->clock.setSyncMode(sync);
+        std::vector<uint64_t> delivered;
+        nes->setFrameCallback(
+            [&](const Frame &frame) { delivered.push_back(frame.hash()); });
+        uint64_t lastHash = 0;
+        for (int i = 0; i < 10; i++) {
+            lastHash = nes->runFrame().hash();
+        }
+
+        EXPECT_EQ(lastHash, expected.frameHash);
+        EXPECT_EQ(nes->cpu.getCycleCount(), reference->cpu.getCycleCount());
+        ASSERT_EQ(delivered.size(), 10u);
+        EXPECT_EQ(delivered.back(), lastHash);
+    }
+}
+
+TEST(NESRunLoop, RunCyclesRunsAtLeastTheBudget) {
+    const std::vector<uint8_t> rom = nestest::readBinaryFile("nestest.nes");
+    for (SyncMode sync : {SyncMode::CycleStepped, SyncMode::InstructionStepped}) {
+        auto nes = makeNES(rom);
+        nes->clock.setSyncMode(sync);
+        uint64_t delivered = 0;
+        nes->setFrameCallback([&](const Frame &) { delivered++; });
+
+        constexpr uint64_t budget = 5 * 29781;
+        const uint64_t start = nes->cpu.getCycleCount();
+        const uint64_t frames = nes->runCycles(budget);
+        const uint64_t ran = nes->cpu.getCycleCount() - start;
+
+        EXPECT_GE(ran, budget);
+        EXPECT_LT(ran, budget + 8); // one instruction at most
+        EXPECT_GE(frames, 4u);
+        EXPECT_LE(frames, 5u);
+        EXPECT_EQ(frames, delivered);
+    }
+}
+
+TEST(NESRunLoop, RunUntilChecksBeforeEachStep) {
+    auto nes = makeNES(nestest::readBinaryFile("nestest.nes"));
+    const uint64_t start = nes->cpu.getCycleCount();
+    EXPECT_EQ(nes->runUntil([] { return true; }), 0u);
+    EXPECT_EQ(nes->cpu.getCycleCount(), start);
+
+    // stops on the first step of vertical blank, having completed no frame
+    EXPECT_EQ(nes->runUntil([&] { return nes->ppu.getScanline() == 241; }),
+              0u);
+    EXPECT_EQ(nes->ppu.getScanline(), 241);
+    EXPECT_EQ(nes->runUntil([&] { return nes->ppu.getScanline() == 0; }), 1u);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
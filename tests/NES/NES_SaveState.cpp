@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <sstream>
+
+#include "../NestestTrace.h"
+#include "../TestRoms.h"
+
+using testroms::makeNES;
+
+namespace {
+
+std::string captureTrace(NES &nes, uint64_t cpuCycles) {
+    std::ostringstream trace;
+    nestest::ScopedStreamCapture capture(trace.rdbuf());
+    nes.runCycles(cpuCycles);
+    std::cout.flush();
+    return trace.str();
+}
+
+} // namespace
+
+TEST(NESSaveState, NestestTraceResumesIdenticallyMidInstruction) {
+    const std::vector<uint8_t> rom = nestest::readBinaryFile("nestest.nes");
+    auto original = makeNES(rom);
+    original->log.unmute();
+    original->cpu.TEST_setPC(0xC000);
+
+    // run into the test suite and stop part way through an instruction
+    captureTrace(*original, 10000);
+    while (original->cpu.TEST_getCyclesRemainingInCurrentInstr() < 2) {
+        captureTrace(*original, 1);
+    }
+
+    std::vector<uint8_t> snapshot;
+    original->saveState(snapshot);
+    const std::string expected = captureTrace(*original, 5000);
+
+    // restore into a console that has not run nestest at all
+    auto restored = makeNES(rom);
+    restored->log.unmute();
+    restored->loadState(snapshot);
+    const std::string actual = captureTrace(*restored, 5000);
+
+    ASSERT_FALSE(expected.empty());
+    EXPECT_EQ(expected, actual);
+    EXPECT_EQ(original->bus.getCPURAM(), restored->bus.getCPURAM());
+    EXPECT_EQ(original->cpu.getCycleCount(), restored->cpu.getCycleCount());
+}
+
+TEST(NESSaveState, FramesResumeIdenticallyMidFrame) {
+    const std::vector<uint8_t> rom = nestest::readBinaryFile("nestest.nes");
+    auto original = makeNES(rom);
+    original->runHeadless(5);
+
+    // stop mid-frame with part of the picture drawn
+    original->runUntil([&] { return original->ppu.getScanline() >= 100; });
+
+    std::vector<uint8_t> snapshot;
+    original->saveState(snapshot);
+    const HeadlessResult expected = original->runHeadless(10);
+
+    auto restored = makeNES(rom);
+    restored->loadState(snapshot);
+    const HeadlessResult actual = restored->runHeadless(10);
+
+    EXPECT_EQ(expected.frameHash, actual.frameHash);
+    EXPECT_EQ(expected.cpuCycles, actual.cpuCycles);
+    EXPECT_EQ(original->bus.getCPURAM(), restored->bus.getCPURAM());
+    EXPECT_EQ(original->ppu.getScanline(), restored->ppu.getScanline());
+    EXPECT_EQ(original->ppu.getCycle(), restored->ppu.getCycle());
+}
+
+TEST(NESSaveState, SnapshotIsCompactAndReusesBuffer) {
+    auto nes = makeNES(nestest::readBinaryFile("nestest.nes"));
+    nes->runHeadless(2);
+
+    // between frames no framebuffer is stored
+    std::vector<uint8_t> snapshot;
+    nes->saveState(snapshot);
+    EXPECT_LT(snapshot.size(), 8u * 1024u);
+
+    const uint8_t *data = snapshot.data();
+    nes->saveState(snapshot);
+    EXPECT_EQ(data, snapshot.data());
+
+    constexpr int kIterations = 1000;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kIterations; i++) {
+        nes->saveState(snapshot);
+        nes->loadState(snapshot);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "save+load: "
+              << std::chrono::duration<double, std::micro>(elapsed).count() /
+                     kIterations
+              << " us" << std::endl;
+}
+
+TEST(NESSaveState, RejectsInvalidSnapshots) {
+    const std::vector<uint8_t> rom = nestest::readBinaryFile("nestest.nes");
+    auto nes = makeNES(rom);
+    std::vector<uint8_t> snapshot;
+    nes->saveState(snapshot);
+    // move on, so a partly loaded snapshot would show
+    nes->runFrame();
+    std::vector<uint8_t> before;
+    nes->saveState(before);
+
+    std::vector<uint8_t> badVersion = snapshot;
+    badVersion[4] ^= 0xFF;
+    EXPECT_THROW(nes->loadState(badVersion), std::invalid_argument);
+
+    std::vector<uint8_t> otherROM = snapshot;
+    otherROM[8] ^= 0xFF;
+    EXPECT_THROW(nes->loadState(otherROM), std::invalid_argument);
+
+    // every component but the clock loads before the end is reached
+    std::vector<uint8_t> truncated(snapshot.begin(), snapshot.end() - 1);
+    EXPECT_THROW(nes->loadState(truncated), std::runtime_error);
+    std::vector<uint8_t> after;
+    nes->saveState(after);
+    EXPECT_EQ(after, before);
+
+    // the CPU's addressing mode follows the 12 byte header and 16 bytes of
+    // registers and instruction progress
+    std::vector<uint8_t> badMode = snapshot;
+    badMode[12 + 16] = 0xFF;
+    EXPECT_THROW(nes->loadState(badMode), std::runtime_error);
+    nes->saveState(after);
+    EXPECT_EQ(after, before);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -149,38 +149,6 @@ class ScopedStreamCapture {
     std::streambuf *original;
 };
 
-class CpuPpuStepper {
-  public:
-    explicit CpuPpuStepper(NES &nes) : nes(nes) {}
-
-    void tick() {
-        nes.cpu.tick();
-
-        if (pendingNMIEdge) {
-            nes.cpu.triggerNMI();
-            pendingNMIEdge = false;
-        }
-
-        for (int i = 0; i < 3; i++) {
-            nes.ppu.tick();
-            const bool nmiState = nes.bus.ppuNMI();
-            if (nmiState && !lastNMIState) {
-                if (nes.cpu.completedTakenBranchLastTick()) {
-                    pendingNMIEdge = true;
-                } else {
-                    nes.cpu.triggerNMI();
-                }
-            }
-            lastNMIState = nmiState;
-        }
-    }
-
-  private:
-    NES &nes;
-    bool lastNMIState = false;
-    bool pendingNMIEdge = false;
-};
-
 } // namespace nestest
 
 #endif // NESTEST_TRACE_H
@@ -7,19 +7,17 @@ TEST(PPUNestest, TraceMatchesExpectedLog) {
         nestest::readLines("nestest_ppu_exp.log");
     ASSERT_FALSE(expectedLines.empty());
 
-    Renderer renderer(nullptr, nullptr, nullptr);
-    NES nes(std::move(renderer), nestest::readBinaryFile("nestest.nes"));
+    NES nes(nestest::readBinaryFile("nestest.nes"));
     nes.cpu.TEST_setPC(0xC004);
 
     nestest::LineCompareStreamBuf compareBuf(expectedLines);
     nestest::ScopedStreamCapture capture(&compareBuf);
-    nestest::CpuPpuStepper stepper(nes);
 
     constexpr uint64_t kMaxCpuTicks = 2000000;
     for (uint64_t cpuTicks = 0;
          cpuTicks < kMaxCpuTicks && !compareBuf.done() && !compareBuf.failed();
          cpuTicks++) {
-        stepper.tick();
+        nes.runCycles(1);
     }
 
     std::cout.flush();
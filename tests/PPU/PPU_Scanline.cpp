@@ -0,0 +1,208 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "../../include/Cartridge.h"
+#include "../../include/PPU/PPU.h"
+#include "../../include/PPU/Registers/PPUMask.h"
+#include "../../include/PPU/Registers/PPUStatus.h"
+#include "../NestestTrace.h"
+
+// Scanline render mode must be indistinguishable from the dot renderer, so
+// every test runs the same scene in both modes and compares the results.
+
+namespace {
+std::vector<uint8_t> makeMinimalChrRamNrom128() {
+    // iNES header + 16 KiB PRG. CHR size 0 gives us 8 KiB of CHR-RAM.
+    std::vector<uint8_t> rom(16 + 0x4000, 0);
+    rom[0] = 'N';
+    rom[1] = 'E';
+    rom[2] = 'S';
+    rom[3] = 0x1A;
+    rom[4] = 1; // 1x 16 KiB PRG-ROM bank
+    rom[5] = 0; // CHR-RAM
+    return rom;
+}
+
+// Small deterministic generator so both PPUs see the same scene.
+class SceneRandom {
+  public:
+    uint8_t next() {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<uint8_t>(state >> 56);
+    }
+
+  private:
+    uint64_t state = 0x2C0FFEE;
+};
+
+void loadRandomScene(Cartridge &cart, PPU &ppu) {
+    SceneRandom random;
+    for (uint16_t address = 0; address < 0x2000; address++) {
+        cart.write_chr_ram(address, random.next());
+    }
+    for (uint16_t address = 0; address < 0x0800; address++) {
+        ppu.TEST_setvram(address, random.next());
+    }
+
+    ppu.write_to_ppu_addr(0x3F);
+    ppu.write_to_ppu_addr(0x00);
+    for (int i = 0; i < 32; i++) {
+        ppu.cpuWrite(random.next() & 0x3F);
+    }
+
+    ppu.write_to_oam_addr(0x00);
+    for (int i = 0; i < 256; i++) {
+        ppu.write_to_oam_data(random.next());
+    }
+    // put sprite zero mid-screen so its hit lands inside a scanline
+    ppu.write_to_oam_addr(0x00);
+    ppu.write_to_oam_data(100);
+    ppu.write_to_oam_data(0x41);
+    ppu.write_to_oam_data(0x00);
+    ppu.write_to_oam_data(121);
+
+    ppu.write_to_mask(PPUMask::SHOW_BACKGROUND | PPUMask::SHOW_SPRITES |
+                      PPUMask::LEFTMOST_8PXL_BACKGROUND |
+                      PPUMask::LEFTMOST_8PXL_SPRITE);
+}
+
+struct RunResult {
+    std::vector<uint64_t> frameHashes;
+    std::vector<uint8_t> statusReads;
+    uint8_t finalStatus = 0;
+};
+
+// Register writes that land mid-scanline, keyed on the dot about to be ticked.
+void applyMidScanlineWrites(PPU &ppu, int frame) {
+    const int scanline = ppu.getScanline();
+    const int dot = ppu.getCycle();
+    if (scanline >= 240) {
+        return;
+    }
+
+    if (scanline % 16 == 3 && dot == 100) {
+        ppu.write_to_scroll(static_cast<uint8_t>(scanline * 3 + frame));
+        ppu.write_to_scroll(static_cast<uint8_t>(scanline / 2));
+    }
+    if (scanline == 120 && dot == 37) {
+        ppu.write_to_ctrl(0x11); // nametable $2400, background table $1000
+    }
+    if (scanline == 180 && dot == 250) {
+        ppu.write_to_ctrl(0x00);
+    }
+    if (scanline == 200 && dot == 129) {
+        ppu.write_to_mask(PPUMask::SHOW_BACKGROUND | PPUMask::SHOW_SPRITES);
+    }
+    if (scanline == 60 && dot == 201) {
+        ppu.write_to_ppu_addr(0x3F);
+        ppu.write_to_ppu_addr(0x01);
+        ppu.cpuWrite(static_cast<uint8_t>(0x16 + frame));
+    }
+}
+
+RunResult runScene(PPURenderMode mode, int frames, bool midScanlineWrites,
+                   bool pollStatus) {
+    Cartridge cart;
+    cart.load(makeMinimalChrRamNrom128());
+    PPU ppu(cart);
+    ppu.setRenderMode(mode);
+    loadRandomScene(cart, ppu);
+
+    RunResult result;
+    while (static_cast<int>(result.frameHashes.size()) < frames) {
+        const int frame = static_cast<int>(result.frameHashes.size());
+        if (midScanlineWrites) {
+            applyMidScanlineWrites(ppu, frame);
+        }
+        if (pollStatus && ppu.getScanline() < 240 && ppu.getCycle() % 7 == 3) {
+            result.statusReads.push_back(ppu.read_status());
+        }
+        if (auto completed = ppu.tick()) {
+            result.frameHashes.push_back(completed->hash());
+        }
+    }
+    result.finalStatus = ppu.TEST_getstatus();
+    return result;
+}
+
+void expectSameResult(const RunResult &dot, const RunResult &batched) {
+    ASSERT_EQ(dot.frameHashes.size(), batched.frameHashes.size());
+    for (std::size_t i = 0; i < dot.frameHashes.size(); i++) {
+        EXPECT_EQ(dot.frameHashes[i], batched.frameHashes[i])
+            << "frame " << i << " differs";
+    }
+    EXPECT_EQ(dot.statusReads, batched.statusReads);
+    EXPECT_EQ(dot.finalStatus, batched.finalStatus);
+}
+} // namespace
+
+TEST(PPUScanline, StaticSceneMatchesDotRenderer) {
+    const RunResult dot = runScene(PPURenderMode::Dot, 3, false, false);
+    const RunResult batched = runScene(PPURenderMode::Scanline, 3, false, false);
+    expectSameResult(dot, batched);
+}
+
+TEST(PPUScanline, MidScanlineWritesMatchDotRenderer) {
+    const RunResult dot = runScene(PPURenderMode::Dot, 3, true, false);
+    const RunResult batched = runScene(PPURenderMode::Scanline, 3, true, false);
+    expectSameResult(dot, batched);
+
+    // the scroll splits must actually change the picture between frames
+    EXPECT_NE(dot.frameHashes[1], dot.frameHashes[2]);
+}
+
+TEST(PPUScanline, SpriteZeroHitTimingMatchesDotRenderer) {
+    const RunResult dot = runScene(PPURenderMode::Dot, 2, true, true);
+    const RunResult batched = runScene(PPURenderMode::Scanline, 2, true, true);
+    expectSameResult(dot, batched);
+
+    bool sawSpriteZeroHit = false;
+    for (uint8_t status : dot.statusReads) {
+        sawSpriteZeroHit |= (status & PPUStatus::SPRITE_ZERO_HIT) != 0;
+    }
+    EXPECT_TRUE(sawSpriteZeroHit);
+}
+
+TEST(PPUScanline, SwitchingModeMidScanlineMatchesDotRenderer) {
+    Cartridge cart;
+    cart.load(makeMinimalChrRamNrom128());
+    PPU ppu(cart);
+    loadRandomScene(cart, ppu);
+
+    const RunResult dot = runScene(PPURenderMode::Dot, 2, true, false);
+
+    std::vector<uint64_t> frameHashes;
+    int ticks = 0;
+    while (frameHashes.size() < 2) {
+        applyMidScanlineWrites(ppu, static_cast<int>(frameHashes.size()));
+        if (ticks % 5000 == 77) {
+            ppu.setRenderMode(ppu.getRenderMode() == PPURenderMode::Dot
+                                  ? PPURenderMode::Scanline
+                                  : PPURenderMode::Dot);
+        }
+        if (auto completed = ppu.tick()) {
+            frameHashes.push_back(completed->hash());
+        }
+        ticks++;
+    }
+    EXPECT_EQ(dot.frameHashes, frameHashes);
+}
+
+TEST(PPUScanline, NestestFramesMatchDotRenderer) {
+    const std::vector<uint8_t> rom = nestest::readBinaryFile("nestest.nes");
+    std::vector<uint64_t> hashes;
+    for (PPURenderMode mode : {PPURenderMode::Dot, PPURenderMode::Scanline}) {
+        NES nes(rom);
+        nes.log.mute();
+        nes.ppu.setRenderMode(mode);
+        hashes.push_back(nes.runHeadless(30).frameHash);
+    }
+    EXPECT_EQ(hashes[0], hashes[1]);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
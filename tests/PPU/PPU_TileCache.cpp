@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "../../include/Cartridge.h"
+#include "../TestRoms.h"
+
+namespace {
+// NROM with 16 KiB PRG and pseudo-random 8 KiB CHR-ROM, or 8 KiB CHR-RAM
+std::vector<uint8_t> makeNrom128(bool chrRam) {
+    std::vector<uint8_t> rom =
+        testroms::makeINES(0x4000, chrRam ? 0 : 0x2000);
+
+    uint32_t state = 12345;
+    for (std::size_t i = 16 + 0x4000; i < rom.size(); i++) {
+        state = state * 1103515245 + 12345;
+        rom[i] = static_cast<uint8_t>(state >> 16);
+    }
+    return rom;
+}
+
+uint8_t decodeFromPlanes(Cartridge &cart, uint16_t rowAddress, int px) {
+    const uint8_t low = cart.read_chr_rom(rowAddress);
+    const uint8_t high = cart.read_chr_rom(rowAddress + 8);
+    const int bit = 7 - px;
+    return static_cast<uint8_t>((((high >> bit) & 0x01) << 1) |
+                                ((low >> bit) & 0x01));
+}
+} // namespace
+
+TEST(PPUTileCache, DecodedRowsMatchChrRom) {
+    Cartridge cart(makeNrom128(false));
+
+    for (uint16_t tile = 0; tile < 512; tile++) {
+        for (uint16_t fineY = 0; fineY < 8; fineY++) {
+            const uint16_t rowAddress =
+                static_cast<uint16_t>(tile * 16 + fineY);
+            const TileRow &row = cart.read_chr_tile_row(rowAddress, false);
+            const TileRow &flipped = cart.read_chr_tile_row(rowAddress, true);
+            for (int px = 0; px < 8; px++) {
+                const uint8_t expected = decodeFromPlanes(cart, rowAddress, px);
+                ASSERT_EQ(row[px], expected)
+                    << "tile " << tile << " row " << fineY << " px " << px;
+                ASSERT_EQ(flipped[7 - px], expected)
+                    << "tile " << tile << " row " << fineY << " px " << px;
+            }
+        }
+    }
+}
+
+TEST(PPUTileCache, ChrRamWritesUpdateOnlyTouchedRow) {
+    Cartridge cart(makeNrom128(true));
+
+    // tile 3, row 5: low plane 0b10100000, high plane 0b11000000
+    cart.write_chr_ram(3 * 16 + 5, 0xA0);
+    EXPECT_EQ(cart.read_chr_tile_row(3 * 16 + 5, false),
+              (TileRow{1, 0, 1, 0, 0, 0, 0, 0}));
+
+    cart.write_chr_ram(3 * 16 + 5 + 8, 0xC0);
+    EXPECT_EQ(cart.read_chr_tile_row(3 * 16 + 5, false),
+              (TileRow{3, 2, 1, 0, 0, 0, 0, 0}));
+    EXPECT_EQ(cart.read_chr_tile_row(3 * 16 + 5, true),
+              (TileRow{0, 0, 0, 0, 0, 1, 2, 3}));
+
+    // neighbouring rows and tiles are untouched
+    EXPECT_EQ(cart.read_chr_tile_row(3 * 16 + 4, false), TileRow{});
+    EXPECT_EQ(cart.read_chr_tile_row(3 * 16 + 6, false), TileRow{});
+    EXPECT_EQ(cart.read_chr_tile_row(4 * 16 + 5, false), TileRow{});
+}
+
+TEST(PPUTileCache, ReloadRebuildsCache) {
+    Cartridge cart(makeNrom128(true));
+    cart.write_chr_ram(0, 0xFF);
+    ASSERT_EQ(cart.read_chr_tile_row(0, false)[0], 1);
+
+    cart.load(makeNrom128(false));
+    EXPECT_EQ(cart.read_chr_tile_row(0, false)[0], decodeFromPlanes(cart, 0, 0));
+}
+
+TEST(PPUTileCache, ThrowsWithoutCartridge) {
+    Cartridge cart;
+    EXPECT_THROW(cart.read_chr_tile_row(0, false), std::runtime_error);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
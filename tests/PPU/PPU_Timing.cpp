@@ -51,13 +51,13 @@ TEST(PPUTiming, TickReturnsOptionalFrameOnlyWhenReady) {
     cart.load(makeMinimalNrom128());
     PPU ppu(cart);
 
-    EXPECT_FALSE(ppu.tick().has_value());
+    EXPECT_EQ(ppu.tick(), nullptr);
 
     constexpr int maxTicks = 300000;
     for (int ticks = 1; ticks < maxTicks; ticks++) {
-        auto frame = ppu.tick();
-        if (frame.has_value()) {
-            EXPECT_EQ(frame->pixelData.size(), SCREEN_WIDTH * SCREEN_HEIGHT * 3);
+        const Frame *frame = ppu.tick();
+        if (frame != nullptr) {
+            EXPECT_EQ(frame->pixelData.size(), SCREEN_WIDTH * SCREEN_HEIGHT);
             EXPECT_EQ(frame->backgroundOpaque.size(),
                       SCREEN_WIDTH * SCREEN_HEIGHT);
             return;
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+#include "../../include/Renderer/FrameMailbox.h"
+
+namespace {
+
+// Fills every pixel with value so torn frames can be detected
+void fill(Frame &frame, uint8_t value) {
+    std::fill(frame.pixelData.begin(), frame.pixelData.end(), value);
+}
+
+bool uniform(const Frame &frame) {
+    const uint8_t first = frame.pixelData.front();
+    return std::all_of(frame.pixelData.begin(), frame.pixelData.end(),
+                       [first](uint8_t value) { return value == first; });
+}
+
+} // namespace
+
+TEST(FrameMailbox, EmptyUntilPublished) {
+    FrameMailbox mailbox;
+    EXPECT_EQ(mailbox.take(), nullptr);
+
+    Frame frame;
+    fill(frame, 7);
+    mailbox.publish(frame);
+    const Frame *taken = mailbox.take();
+    ASSERT_NE(taken, nullptr);
+    EXPECT_EQ(taken->pixelData, frame.pixelData);
+
+    // each frame is handed over once
+    EXPECT_EQ(mailbox.take(), nullptr);
+}
+
+TEST(FrameMailbox, TakeReturnsLatestFrame) {
+    FrameMailbox mailbox;
+    Frame frame;
+    for (uint8_t value = 1; value <= 5; value++) {
+        fill(frame, value);
+        mailbox.publish(frame);
+    }
+    const Frame *taken = mailbox.take();
+    ASSERT_NE(taken, nullptr);
+    EXPECT_EQ(taken->pixelData.front(), 5);
+    EXPECT_TRUE(uniform(*taken));
+}
+
+TEST(FrameMailbox, TakenFrameIsNotOverwrittenByPublish) {
+    FrameMailbox mailbox;
+    Frame frame;
+    fill(frame, 1);
+    mailbox.publish(frame);
+    const Frame *taken = mailbox.take();
+    ASSERT_NE(taken, nullptr);
+
+    for (uint8_t value = 2; value <= 10; value++) {
+        fill(frame, value);
+        mailbox.publish(frame);
+    }
+    EXPECT_EQ(taken->pixelData.front(), 1);
+    EXPECT_TRUE(uniform(*taken));
+}
+
+TEST(FrameMailbox, ConcurrentFramesArriveWholeAndInOrder) {
+    FrameMailbox mailbox;
+    constexpr uint32_t publishes = 2000;
+    std::atomic<bool> done{false};
+
+    // frame i holds i in its first four bytes and i & 0xFF everywhere else
+    std::thread producer([&] {
+        Frame frame;
+        for (uint32_t i = 1; i <= publishes; i++) {
+            fill(frame, static_cast<uint8_t>(i));
+            std::memcpy(frame.pixelData.data(), &i, sizeof(i));
+            mailbox.publish(frame);
+        }
+        done = true;
+    });
+
+    int taken = 0;
+    int torn = 0;
+    int outOfOrder = 0;
+    uint32_t last = 0;
+    while (true) {
+        const bool finished = done;
+        if (const Frame *frame = mailbox.take()) {
+            uint32_t sequence = 0;
+            std::memcpy(&sequence, frame->pixelData.data(), sizeof(sequence));
+            const bool whole = std::all_of(
+                frame->pixelData.begin() + sizeof(sequence),
+                frame->pixelData.end(), [sequence](uint8_t value) {
+                    return value == static_cast<uint8_t>(sequence);
+                });
+            taken++;
+            torn += whole ? 0 : 1;
+            outOfOrder += sequence > last ? 0 : 1;
+            last = sequence;
+        } else if (finished) {
+            break;
+        }
+    }
+    producer.join();
+
+    EXPECT_GT(taken, 0);
+    EXPECT_EQ(torn, 0);
+    EXPECT_EQ(outOfOrder, 0);
+    EXPECT_EQ(last, publishes); // the final frame is never lost
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "../../include/Renderer/Frame.h"
+#include "../../include/Renderer/PaletteConversion.h"
+
+namespace {
+
+constexpr PaletteConversionPath ALL_PATHS[] = {
+    PaletteConversionPath::Scalar, PaletteConversionPath::SSSE3,
+    PaletteConversionPath::AVX2, PaletteConversionPath::NEON};
+
+// Every byte value, including ones with the unused top bits set
+std::vector<uint8_t> makeIndices(std::size_t count) {
+    std::vector<uint8_t> indices(count);
+    uint32_t state = 12345;
+    for (uint8_t &index : indices) {
+        state = state * 1103515245u + 12345u;
+        index = static_cast<uint8_t>(state >> 16);
+    }
+    return indices;
+}
+
+std::vector<uint8_t> expectedRGBA(const std::vector<uint8_t> &indices) {
+    std::vector<uint8_t> rgba;
+    for (uint8_t index : indices) {
+        const auto &[r, g, b] = NES_PALETTE[index & 0x3F];
+        rgba.insert(rgba.end(), {r, g, b, 0xFF});
+    }
+    return rgba;
+}
+
+} // namespace
+
+TEST(PaletteConversion, BestPathIsSupported) {
+    EXPECT_TRUE(paletteConversionSupported(PaletteConversionPath::Scalar));
+    EXPECT_TRUE(paletteConversionSupported(bestPaletteConversionPath()));
+}
+
+TEST(PaletteConversion, EveryPathMatchesPalette) {
+    // a full frame, plus lengths that leave a tail for the scalar loop
+    for (std::size_t count :
+         {static_cast<std::size_t>(SCREEN_WIDTH * SCREEN_HEIGHT),
+          std::size_t{0}, std::size_t{1}, std::size_t{15}, std::size_t{33},
+          std::size_t{64 + 31}}) {
+        const std::vector<uint8_t> indices = makeIndices(count);
+        const std::vector<uint8_t> expected = expectedRGBA(indices);
+
+        for (PaletteConversionPath path : ALL_PATHS) {
+            if (!paletteConversionSupported(path)) {
+                continue;
+            }
+            std::vector<uint8_t> rgba(count * 4, 0);
+            convertPaletteIndicesToRGBA(path, indices.data(), count,
+                                        rgba.data());
+            EXPECT_EQ(rgba, expected)
+                << paletteConversionPathName(path) << ", " << count
+                << " pixels";
+        }
+    }
+}
+
+TEST(PaletteConversion, UnsupportedPathThrows) {
+    for (PaletteConversionPath path : ALL_PATHS) {
+        if (paletteConversionSupported(path)) {
+            continue;
+        }
+        uint8_t index = 0;
+        uint8_t rgba[4];
+        EXPECT_THROW(convertPaletteIndicesToRGBA(path, &index, 1, rgba),
+                     std::invalid_argument);
+    }
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
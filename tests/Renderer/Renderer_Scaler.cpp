@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "../../include/Constants.h"
+#include "../../include/Renderer/Scaler.h"
+
+namespace {
+
+constexpr std::size_t PIXELS =
+    static_cast<std::size_t>(SCREEN_WIDTH) * SCREEN_HEIGHT;
+
+// Opaque pixels from a small palette, so neighbours are often equal and EPX
+// has edges to smooth
+std::vector<uint32_t> makeImage() {
+    constexpr uint32_t colours[] = {0xFF000000u, 0xFF0000FFu, 0xFF00FF00u,
+                                    0xFFFF0000u};
+    std::vector<uint32_t> image(PIXELS);
+    uint32_t state = 99;
+    for (uint32_t &pixel : image) {
+        state = state * 1103515245u + 12345u;
+        pixel = colours[(state >> 16) % 4];
+    }
+    return image;
+}
+
+std::vector<uint32_t> scaleWith(Scaler &scaler,
+                                const std::vector<uint32_t> &image) {
+    const uint32_t *out = scaler.scale(image.data());
+    return std::vector<uint32_t>(
+        out, out + static_cast<std::size_t>(scaler.outputWidth()) *
+                       scaler.outputHeight());
+}
+
+uint32_t sourcePixel(const std::vector<uint32_t> &image, int x, int y) {
+    return image[static_cast<std::size_t>(y) * SCREEN_WIDTH + x];
+}
+
+} // namespace
+
+TEST(Scaler, GPUScalerPassesFrameThrough) {
+    const std::vector<uint32_t> image = makeImage();
+    auto scaler = makeScaler(ScalerKind::GPU, SCREEN_SCALING);
+    EXPECT_EQ(scaler->outputWidth(), SCREEN_WIDTH);
+    EXPECT_EQ(scaler->outputHeight(), SCREEN_HEIGHT);
+    EXPECT_EQ(scaler->scale(image.data()), image.data());
+}
+
+TEST(Scaler, NearestRepeatsPixels) {
+    const std::vector<uint32_t> image = makeImage();
+    for (int factor : {1, 2, 3, 4}) {
+        auto scaler = makeScaler(ScalerKind::Nearest, factor);
+        ASSERT_EQ(scaler->outputWidth(), SCREEN_WIDTH * factor);
+        ASSERT_EQ(scaler->outputHeight(), SCREEN_HEIGHT * factor);
+        const std::vector<uint32_t> out = scaleWith(*scaler, image);
+        int mismatches = 0;
+        for (int y = 0; y < scaler->outputHeight(); y++) {
+            for (int x = 0; x < scaler->outputWidth(); x++) {
+                mismatches +=
+                    out[static_cast<std::size_t>(y) * scaler->outputWidth() +
+                        x] != sourcePixel(image, x / factor, y / factor);
+            }
+        }
+        EXPECT_EQ(mismatches, 0) << "factor " << factor;
+    }
+}
+
+TEST(Scaler, ScanlinesDarkenLastRowOfEachSourceRow) {
+    const std::vector<uint32_t> image = makeImage();
+    auto scaler = makeScaler(ScalerKind::Scanlines, 3);
+    auto nearest = makeScaler(ScalerKind::Nearest, 3);
+    const std::vector<uint32_t> out = scaleWith(*scaler, image);
+    const std::vector<uint32_t> plain = scaleWith(*nearest, image);
+
+    const std::size_t width = scaler->outputWidth();
+    for (int y = 0; y < scaler->outputHeight(); y++) {
+        for (std::size_t x = 0; x < width; x += 37) {
+            const std::size_t i = y * width + x;
+            if (y % 3 == 2) {
+                const uint8_t *bytes =
+                    reinterpret_cast<const uint8_t *>(&out[i]);
+                const uint8_t *original =
+                    reinterpret_cast<const uint8_t *>(&plain[i]);
+                EXPECT_EQ(bytes[0], original[0] / 2);
+                EXPECT_EQ(bytes[1], original[1] / 2);
+                EXPECT_EQ(bytes[2], original[2] / 2);
+                EXPECT_EQ(bytes[3], 0xFF); // alpha untouched
+            } else {
+                EXPECT_EQ(out[i], plain[i]);
+            }
+        }
+    }
+}
+
+TEST(Scaler, EPXLeavesFlatAreasAndSmoothsDiagonals) {
+    // flat image: EPX matches nearest
+    std::vector<uint32_t> image(PIXELS, 0xFF123456u);
+    for (int factor : {2, 3}) {
+        auto epx = makeScaler(ScalerKind::EPX, factor);
+        auto nearest = makeScaler(ScalerKind::Nearest, factor);
+        EXPECT_EQ(scaleWith(*epx, image), scaleWith(*nearest, image));
+    }
+
+    // Two ink pixels touching diagonally at (10, 10) and (11, 11). EPX fills
+    // the facing corners of the two black pixels between them.
+    constexpr uint32_t ink = 0xFFFFFFFFu;
+    std::fill(image.begin(), image.end(), 0xFF000000u);
+    image[10 * SCREEN_WIDTH + 10] = ink;
+    image[11 * SCREEN_WIDTH + 11] = ink;
+    auto epx = makeScaler(ScalerKind::EPX, 2);
+    const std::vector<uint32_t> out = scaleWith(*epx, image);
+    const std::size_t width = epx->outputWidth();
+    EXPECT_EQ(out[(11 * 2) * width + (10 * 2 + 1)], ink); // top right of (10, 11)
+    EXPECT_EQ(out[(10 * 2 + 1) * width + (11 * 2)], ink); // bottom left of (11, 10)
+    EXPECT_EQ(out[(11 * 2 + 1) * width + (10 * 2)], 0xFF000000u);
+}
+
+TEST(Scaler, VectorizedMatchesScalar) {
+    const std::vector<uint32_t> image = makeImage();
+    struct Case {
+        ScalerKind kind;
+        int factor;
+    };
+    for (const Case &c : {Case{ScalerKind::Nearest, 2},
+                          Case{ScalerKind::Nearest, 3},
+                          Case{ScalerKind::Nearest, 4},
+                          Case{ScalerKind::Scanlines, 2},
+                          Case{ScalerKind::Scanlines, 3},
+                          Case{ScalerKind::EPX, 2}, Case{ScalerKind::EPX, 3}}) {
+        auto vectorized = makeScaler(c.kind, c.factor, true);
+        auto scalar = makeScaler(c.kind, c.factor, false);
+        EXPECT_EQ(scaleWith(*vectorized, image), scaleWith(*scalar, image))
+            << scalerKindName(c.kind) << " x" << c.factor;
+    }
+}
+
+TEST(Scaler, RejectsUnsupportedFactorsAndNames) {
+    EXPECT_THROW(makeScaler(ScalerKind::EPX, 4), std::invalid_argument);
+    EXPECT_THROW(makeScaler(ScalerKind::Scanlines, 1), std::invalid_argument);
+    EXPECT_THROW(makeScaler(ScalerKind::Nearest, 0), std::invalid_argument);
+    EXPECT_THROW(scalerKindFromName("hq9x"), std::invalid_argument);
+    EXPECT_EQ(scalerKindFromName("epx"), ScalerKind::EPX);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
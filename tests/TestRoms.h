@@ -0,0 +1,58 @@
+#ifndef TEST_ROMS_H
+#define TEST_ROMS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "../include/NES.h"
+
+// ROM images and consoles built by the unit tests
+
+namespace testroms {
+
+/**
+ * iNES image for the given mapper: header, prgSize bytes of PRG ROM and
+ * chrSize bytes of CHR ROM, all filled with fill. A chrSize of 0 gives the
+ * board 8 KiB of CHR RAM.
+ */
+inline std::vector<uint8_t> makeINES(std::size_t prgSize, std::size_t chrSize,
+                                     uint8_t mapper = 0, uint8_t fill = 0) {
+    std::vector<uint8_t> rom(16 + prgSize + chrSize, fill);
+    rom[0] = 'N';
+    rom[1] = 'E';
+    rom[2] = 'S';
+    rom[3] = 0x1A;
+    rom[4] = static_cast<uint8_t>(prgSize / 0x4000);
+    rom[5] = static_cast<uint8_t>(chrSize / 0x2000);
+    rom[6] = static_cast<uint8_t>((mapper & 0x0F) << 4);
+    rom[7] = static_cast<uint8_t>(mapper & 0xF0);
+    for (std::size_t i = 8; i < 16; i++) {
+        rom[i] = 0;
+    }
+    return rom;
+}
+
+/**
+ * Points a CPU vector ($FFFA NMI, $FFFC reset, $FFFE IRQ) of a makeINES()
+ * image at addr. The vectors are the last bytes of PRG ROM.
+ */
+inline void setVector(std::vector<uint8_t> &rom, uint16_t vector,
+                      uint16_t addr) {
+    const std::size_t prgEnd = 16 + static_cast<std::size_t>(rom[4]) * 0x4000;
+    const std::size_t at = prgEnd - (0x10000 - vector);
+    rom[at] = static_cast<uint8_t>(addr & 0xFF);
+    rom[at + 1] = static_cast<uint8_t>(addr >> 8);
+}
+
+// console running rom, with the CPU trace muted
+inline std::unique_ptr<NES> makeNES(const std::vector<uint8_t> &rom) {
+    auto nes = std::make_unique<NES>(rom);
+    nes->log.mute();
+    return nes;
+}
+
+} // namespace testroms
+
+#endif // TEST_ROMS_H
@@ -0,0 +1,56 @@
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../include/CPU/TraceRecord.h"
+#include "../include/Logger.h"
+#include "../include/TraceRecorder.h"
+
+/**
+ * Prints a binary trace written by nesemu --trace-file in the same nestest
+ * format as nesemu --trace, oldest instruction first.
+ *
+ * Usage: nesemu_trace <trace.bin> [--last N]
+ */
+int main(int argc, char *argv[]) {
+    const std::string usage = "Usage: nesemu_trace <trace.bin> [--last N]";
+    if (argc < 2) {
+        std::cerr << usage << std::endl;
+        return 1;
+    }
+
+    uint64_t last = UINT64_MAX;
+    for (int i = 2; i < argc; i++) {
+        const std::string option(argv[i]);
+        if (option == "--last" && i + 1 < argc) {
+            last = std::stoull(argv[++i]);
+        } else {
+            std::cerr << "Unknown option: " << option << "\n"
+                      << usage << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<TraceRecord> records;
+    try {
+        records = TraceRecorder::readFile(argv[1]);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    const std::size_t first =
+        records.size() > last ? records.size() - static_cast<std::size_t>(last)
+                              : 0;
+    char line[Logger::MAX_LINE_LENGTH + 2];
+    for (std::size_t i = first; i < records.size(); i++) {
+        std::size_t length = Logger::format(records[i], line);
+        line[length++] = '\r';
+        line[length++] = '\n';
+        std::fwrite(line, 1, length, stdout);
+    }
+    return 0;
+}